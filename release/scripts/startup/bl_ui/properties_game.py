@@ -380,6 +380,8 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
             sub = col.row()
             sub.prop(gs, "deactivation_time", text="Time")
 
+            layout.prop(gs, "use_physics_cache")
+
         else:
             split = layout.split()
 
@@ -391,6 +393,15 @@ class SCENE_PT_game_physics(SceneButtonsPanel, Panel):
             col.label(text="Logic Steps:")
             col.prop(gs, "logic_step_max", text="Max")
 
+        col = layout.column()
+        col.label(text="Multithreading:")
+        col.prop(gs, "use_parallel_scenes")
+        col.prop(gs, "use_parallel_scenegraph")
+        col.prop(gs, "use_parallel_physics")
+        sub = col.column()
+        sub.active = gs.use_parallel_physics
+        sub.prop(gs, "physics_threads")
+
 
 class SCENE_PT_game_physics_obstacles(SceneButtonsPanel, Panel):
     bl_label = "Obstacle Simulation"
@@ -495,6 +506,22 @@ class SCENE_PT_game_hysteresis(SceneButtonsPanel, Panel):
         row.prop(gs, "scene_hysteresis_percentage", text="")
 
 
+class SCENE_PT_game_animation(SceneButtonsPanel, Panel):
+    bl_label = "Animation"
+    COMPAT_ENGINES = {'BLENDER_GAME', 'BLENDER_EEVEE'}
+
+    @classmethod
+    def poll(cls, context):
+        scene = context.scene
+        return (scene and scene.render.engine in cls.COMPAT_ENGINES)
+
+    def draw(self, context):
+        layout = self.layout
+        gs = context.scene.game_settings
+
+        layout.prop(gs, "use_baked_loop_actions")
+
+
 class DataButtonsPanel:
     bl_space_type = 'PROPERTIES'
     bl_region_type = 'WINDOW'
@@ -568,6 +595,7 @@ classes = (
     SCENE_PT_game_physics_obstacles,
     SCENE_PT_game_navmesh,
     SCENE_PT_game_hysteresis,
+    SCENE_PT_game_animation,
     OBJECT_MT_lod_tools,
     OBJECT_PT_levels_of_detail,
 )
@@ -1553,7 +1553,9 @@ static void draw_controller_python(uiLayout *layout, PointerRNA *ptr)
   split = uiLayoutSplit(layout, 0.3, true);
   uiItemR(split, ptr, "mode", 0, "", ICON_NONE);
   if (RNA_enum_get(ptr, "mode") == CONT_PY_SCRIPT) {
-    uiItemR(split, ptr, "text", 0, "", ICON_NONE);
+    sub = uiLayoutSplit(split, 0.8f, false);
+    uiItemR(sub, ptr, "text", 0, "", ICON_NONE);
+    uiItemR(sub, ptr, "use_function", UI_ITEM_R_TOGGLE, NULL, ICON_NONE);
   }
   else {
     sub = uiLayoutSplit(split, 0.8f, false);
@@ -1900,6 +1902,7 @@ static void draw_actuator_edit_object(uiLayout *layout, PointerRNA *ptr)
       row = uiLayoutRow(layout, false);
       uiItemR(row, ptr, "object", 0, NULL, ICON_NONE);
       uiItemR(row, ptr, "time", 0, NULL, ICON_NONE);
+      uiItemR(row, ptr, "pool_size", 0, NULL, ICON_NONE);
 
       split = uiLayoutSplit(layout, 0.9, false);
       row = uiLayoutRow(split, false);
@@ -101,7 +101,7 @@ typedef struct bEditObjectActuator {
   short dyn_operation;
   short upflag, trackflag; /* flag for up axis and track axis */
   short dyn_operation_flag;
-  short _pad;
+  short pool_size; /* number of hidden copies kept for the added object */
 } bEditObjectActuator;
 
 typedef struct bSceneActuator {
@@ -48,7 +48,7 @@ typedef struct bPythonCont {
   struct Text *text;
   char module[64];
   int mode;
-  int flag; /* only used for debug now */
+  int flag;
 } bPythonCont;
 
 typedef struct bController {
@@ -87,6 +87,7 @@ typedef struct bController {
 
 /* pyctrl->flag */
 #define CONT_PY_DEBUG 1
+#define CONT_PY_FUNCTION 2
 
 /* pyctrl->mode */
 #define CONT_PY_SCRIPT 0
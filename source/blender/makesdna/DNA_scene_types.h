@@ -881,7 +881,9 @@ typedef struct GameData {
   int _pad;
 
   /* Scene LoD */
-  short lodflag, _pad2;
+  short lodflag;
+  /* Threads of the parallel physics, 0 for all. */
+  short physicsthreads;
   int scehysteresis;
 } GameData;
 
@@ -942,6 +944,12 @@ typedef struct GameData {
 #define GAME_USE_UNDO (1 << 19)
 #define GAME_USE_UI_ANTI_FLICKER (1 << 20)
 #define GAME_USE_VIEWPORT_RENDER (1 << 21)
+#define GAME_USE_PARALLEL_SCENES (1 << 22)
+#define GAME_USE_PARALLEL_SCENEGRAPH (1 << 23)
+#define GAME_BAKE_LOOP_ACTIONS (1 << 24)
+#define GAME_USE_PARALLEL_PHYSICS (1 << 25)
+#define GAME_USE_PHYSICS_CACHE (1 << 26)
+#define GAME_USE_RENDER_INTERPOLATION (1 << 27)
 /* Note: GameData.flag is now an int (max 32 flags). A short could only take 16 flags */
 
 /* GameData.playerflag */
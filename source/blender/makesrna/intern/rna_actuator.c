@@ -1533,6 +1533,15 @@ static void rna_def_edit_object_actuator(BlenderRNA *brna)
   RNA_def_property_ui_text(prop, "Time", "Duration the new Object lives or the track takes");
   RNA_def_property_update(prop, NC_LOGIC, NULL);
 
+  prop = RNA_def_property(srna, "pool_size", PROP_INT, PROP_NONE);
+  RNA_def_property_range(prop, 0, 10000);
+  RNA_def_property_ui_text(
+      prop,
+      "Pool Size",
+      "Number of hidden copies of the object kept to be reused by the added objects "
+      "(0 to disable)");
+  RNA_def_property_update(prop, NC_LOGIC, NULL);
+
   prop = RNA_def_property(srna, "mass", PROP_FLOAT, PROP_NONE);
   RNA_def_property_ui_range(prop, 0, 10000, 1, 2);
   RNA_def_property_ui_text(prop, "Mass", "The mass of the object");
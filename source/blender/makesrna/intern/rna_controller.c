@@ -323,6 +323,14 @@ void RNA_def_controller(BlenderRNA *brna)
                            "without restarting");
   RNA_def_property_update(prop, NC_LOGIC, NULL);
 
+  prop = RNA_def_property(srna, "use_function", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", CONT_PY_FUNCTION);
+  RNA_def_property_ui_text(prop,
+                           "F",
+                           "Run the script as the body of a function compiled once, the variables "
+                           "of the script are local to each run (faster)");
+  RNA_def_property_update(prop, NC_LOGIC, NULL);
+
   /* Other Controllers */
   srna = RNA_def_struct(brna, "AndController", "Controller");
   RNA_def_struct_ui_text(
@@ -5379,6 +5379,13 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
                            "Respect the frame rate from the Physics panel in the world properties "
                            "rather than rendering as many frames as possible");
 
+  prop = RNA_def_property(srna, "use_render_interpolation", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_RENDER_INTERPOLATION);
+  RNA_def_property_ui_text(prop,
+                           "Render Interpolation",
+                           "Render as many frames as possible and interpolate the object "
+                           "transformations between the two last logic frames");
+
   prop = RNA_def_property(srna, "use_deprecation_warnings", PROP_BOOLEAN, PROP_NONE);
   RNA_def_property_boolean_negative_sdna(prop, NULL, "flag", GAME_IGNORE_DEPRECATION_WARNINGS);
   RNA_def_property_ui_text(prop,
@@ -5402,6 +5409,50 @@ static void rna_def_scene_game_data(BlenderRNA *brna)
       "Restrict the number of animation updates to the animation FPS (this is "
       "better for performance, but can cause issues with smooth playback)");
 
+  prop = RNA_def_property(srna, "use_parallel_scenes", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PARALLEL_SCENES);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Scenes",
+                           "Update the scene graph and physics of each scene concurrently, "
+                           "logic and python are still run serially before");
+
+  prop = RNA_def_property(srna, "use_parallel_scenegraph", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PARALLEL_SCENEGRAPH);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Scene Graph",
+                           "Update the transformations of independent object hierarchies "
+                           "concurrently when many objects are moving");
+
+  prop = RNA_def_property(srna, "use_parallel_physics", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PARALLEL_PHYSICS);
+  RNA_def_property_ui_text(prop,
+                           "Parallel Physics",
+                           "Compute the collisions and solve the independent simulation islands "
+                           "concurrently, the result doesn't depend on the number of threads");
+
+  prop = RNA_def_property(srna, "physics_threads", PROP_INT, PROP_NONE);
+  RNA_def_property_int_sdna(prop, NULL, "physicsthreads");
+  RNA_def_property_range(prop, 0, 64);
+  RNA_def_property_ui_text(prop,
+                           "Physics Threads",
+                           "Number of threads of the parallel physics, 0 to use all the threads");
+
+  prop = RNA_def_property(srna, "use_physics_cache", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_USE_PHYSICS_CACHE);
+  RNA_def_property_ui_text(prop,
+                           "Physics Cache",
+                           "Store the collision hierarchies of the triangle mesh shapes in a "
+                           "physics_cache directory next to the blend file to not rebuild them "
+                           "at the next conversions, the least recently used files are removed "
+                           "above 256 MB");
+
+  prop = RNA_def_property(srna, "use_baked_loop_actions", PROP_BOOLEAN, PROP_NONE);
+  RNA_def_property_boolean_sdna(prop, NULL, "flag", GAME_BAKE_LOOP_ACTIONS);
+  RNA_def_property_ui_text(prop,
+                           "Bake Looping Actions",
+                           "Sample the bones of looping armature actions from a table baked for "
+                           "each frame instead of evaluating the curves (uses more memory)");
+
   /* materials */
   prop = RNA_def_property(srna, "material_mode", PROP_ENUM, PROP_NONE);
   RNA_def_property_enum_sdna(prop, NULL, "matmode");
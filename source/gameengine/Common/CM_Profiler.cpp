@@ -0,0 +1,190 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Common/CM_Profiler.cpp
+ *  \ingroup common
+ */
+
+#include "CM_Profiler.h"
+#include "SCA_ILogicBrick.h"
+
+#include "BLI_fileops.h"
+#include "BLI_string.h"
+
+#include "PIL_time.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <vector>
+
+bool CM_Profiler::s_enabled = false;
+unsigned int CM_Profiler::s_generation = 0;
+
+/// Ring buffer of the events.
+static std::vector<CM_Profiler::Event> events;
+/// Number of events recorded since the start, the slots are claimed concurrently.
+static std::atomic<unsigned long long> numRecordedEvents(0);
+/// Time of the start of the recording, the events are relative to it.
+static double startTime = 0.0;
+static std::atomic<unsigned int> numThreads(0);
+
+/// Small index of the current thread used as trace thread id.
+static unsigned int get_thread_index()
+{
+  static thread_local unsigned int index = numThreads++;
+  return index;
+}
+
+void CM_Profiler::Start(unsigned int size)
+{
+  s_enabled = false;
+
+  events.clear();
+  events.resize(std::max(size, 1u));
+  numRecordedEvents = 0;
+  ++s_generation;
+  startTime = PIL_check_seconds_timer();
+
+  s_enabled = true;
+}
+
+void CM_Profiler::Stop()
+{
+  s_enabled = false;
+}
+
+unsigned int CM_Profiler::GetNumEvents()
+{
+  const unsigned long long count = numRecordedEvents;
+  return (count < events.size()) ? (unsigned int)count : events.size();
+}
+
+unsigned long long CM_Profiler::BeginEvent(const char *category,
+                                           const char *prefix,
+                                           const char *name,
+                                           unsigned int &r_generation)
+{
+  if (!s_enabled) {
+    return 0;
+  }
+
+  const unsigned long long index = numRecordedEvents++;
+  Event *event = &events[index % events.size()];
+  event->m_category = category;
+  if (prefix) {
+    BLI_snprintf(event->m_name, EVENT_NAME_SIZE, "%s.%s", prefix, name);
+  }
+  else {
+    BLI_strncpy(event->m_name, name, EVENT_NAME_SIZE);
+  }
+  event->m_thread = get_thread_index();
+  event->m_end = -1.0;
+  event->m_start = PIL_check_seconds_timer() - startTime;
+
+  r_generation = s_generation;
+  return index + 1;
+}
+
+void CM_Profiler::EndEvent(unsigned long long id, unsigned int generation)
+{
+  const unsigned long long index = id - 1;
+  // The recording restarted or the event slot was reused.
+  if (generation != s_generation || numRecordedEvents - index > events.size()) {
+    return;
+  }
+
+  events[index % events.size()].m_end = PIL_check_seconds_timer() - startTime;
+}
+
+/// Write a JSON string with the escaped characters.
+static void write_json_string(FILE *file, const char *str)
+{
+  fputc('"', file);
+  for (const char *c = str; *c; ++c) {
+    if (*c == '"' || *c == '\\') {
+      fputc('\\', file);
+      fputc(*c, file);
+    }
+    else if ((unsigned char)*c < 0x20) {
+      fprintf(file, "\\u%04x", (unsigned int)*c);
+    }
+    else {
+      fputc(*c, file);
+    }
+  }
+  fputc('"', file);
+}
+
+bool CM_Profiler::Save(const std::string &filepath)
+{
+  FILE *file = BLI_fopen(filepath.c_str(), "w");
+  if (!file) {
+    return false;
+  }
+
+  const unsigned long long count = numRecordedEvents;
+  const unsigned int numEvents = GetNumEvents();
+  // Oldest event first.
+  const unsigned long long first = count - numEvents;
+
+  fprintf(file, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+
+  bool firstEvent = true;
+  for (unsigned long long i = first; i < count; ++i) {
+    const Event &event = events[i % events.size()];
+    // Unfinished events.
+    if (event.m_end < event.m_start) {
+      continue;
+    }
+
+    fprintf(file, "%s\n{\"name\": ", firstEvent ? "" : ",");
+    write_json_string(file, event.m_name);
+    fprintf(file, ", \"cat\": ");
+    write_json_string(file, event.m_category);
+    // Times are in microseconds.
+    fprintf(file,
+            ", \"ph\": \"X\", \"ts\": %.3f, \"dur\": %.3f, \"pid\": 0, \"tid\": %u}",
+            event.m_start * 1.0e6,
+            (event.m_end - event.m_start) * 1.0e6,
+            event.m_thread);
+    firstEvent = false;
+  }
+
+  fprintf(file, "\n]}\n");
+
+  const bool success = (ferror(file) == 0);
+  fclose(file);
+
+  return success;
+}
+
+CM_ProfileScope::CM_ProfileScope(const char *category, SCA_ILogicBrick *brick) : m_id(0)
+{
+  if (!CM_Profiler::IsEnabled()) {
+    return;
+  }
+
+  const std::string objectName = (brick->GetParent()) ? brick->GetParent()->GetName() : "None";
+  m_id = CM_Profiler::BeginEvent(
+      category, objectName.c_str(), brick->GetName().c_str(), m_generation);
+}
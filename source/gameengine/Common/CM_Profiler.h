@@ -0,0 +1,125 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CM_Profiler.h
+ *  \ingroup common
+ */
+
+#ifndef __CM_PROFILER_H__
+#define __CM_PROFILER_H__
+
+#include <string>
+
+class SCA_ILogicBrick;
+
+/** Trace of the timed phases of the frames, recorded in a ring buffer overwriting the oldest
+ * events and saved as Chrome trace event JSON (chrome://tracing or Perfetto).
+ * The recording is disabled by default and only costs a test per scope in this case.
+ */
+class CM_Profiler {
+ public:
+  enum {
+    EVENT_NAME_SIZE = 64,
+    /// Default number of events kept, a few seconds of a busy game.
+    DEFAULT_NUM_EVENTS = 1 << 17
+  };
+
+  struct Event {
+    /// Static category name.
+    const char *m_category;
+    /// Copied and truncated event name.
+    char m_name[EVENT_NAME_SIZE];
+    double m_start;
+    /// End time, negative while the event is not finished.
+    double m_end;
+    unsigned int m_thread;
+  };
+
+ private:
+  static bool s_enabled;
+  /// Incremented at each start to invalidate the events begun in a previous recording.
+  static unsigned int s_generation;
+
+ public:
+  /** Start recording, the previous events are discarded.
+   * \param size The maximum number of events kept.
+   */
+  static void Start(unsigned int size);
+  /// Stop recording, the events are kept until the next start.
+  static void Stop();
+
+  inline static bool IsEnabled()
+  {
+    return s_enabled;
+  }
+
+  /// Return the number of events kept.
+  static unsigned int GetNumEvents();
+
+  /** Write the kept events as Chrome trace event JSON.
+   * \return False if the file can't be written.
+   */
+  static bool Save(const std::string &filepath);
+
+  /** Record the start of an event, the name is the concatenation of prefix and name.
+   * \param r_generation Set to the recording the event belongs to.
+   * \return The event id to end or 0 if the recording is disabled.
+   */
+  static unsigned long long BeginEvent(const char *category,
+                                       const char *prefix,
+                                       const char *name,
+                                       unsigned int &r_generation);
+  /// Record the end of an event, ignored if it was overwritten or the recording restarted.
+  static void EndEvent(unsigned long long id, unsigned int generation);
+};
+
+/// Time the duration of a scope, for example a frame phase or a logic brick update.
+class CM_ProfileScope {
+ private:
+  unsigned long long m_id;
+  unsigned int m_generation;
+
+ public:
+  inline CM_ProfileScope(const char *category, const char *name)
+      : m_id(CM_Profiler::IsEnabled() ?
+                 CM_Profiler::BeginEvent(category, nullptr, name, m_generation) :
+                 0)
+  {
+  }
+
+  inline CM_ProfileScope(const char *category, const std::string &name)
+      : CM_ProfileScope(category, name.c_str())
+  {
+  }
+
+  /// Name the event by the owner object and the logic brick names.
+  CM_ProfileScope(const char *category, SCA_ILogicBrick *brick);
+
+  inline ~CM_ProfileScope()
+  {
+    if (m_id != 0) {
+      CM_Profiler::EndEvent(m_id, m_generation);
+    }
+  }
+};
+
+#endif  // __CM_PROFILER_H__
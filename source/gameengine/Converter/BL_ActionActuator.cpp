@@ -231,10 +231,13 @@ bool BL_ActionActuator::Update(double curtime)
   if ((m_flag & ACT_FLAG_ACTIVE) && m_framepropname[0] != 0) {
     CValue *oldprop = obj->GetProperty(m_framepropname);
     CValue *newval = new CFloatValue(obj->GetActionFrame(m_layer));
-    if (oldprop)
+    if (oldprop) {
       oldprop->SetValue(newval);
-    else
+      obj->PropertyModified(CPropertyKey::Find(m_framepropname));
+    }
+    else {
       obj->SetProperty(m_framepropname, newval);
+    }
 
     newval->Release();
   }
@@ -0,0 +1,245 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/Converter/BL_ArmatureActionCache.cpp
+ *  \ingroup bgeconv
+ */
+
+#include "BL_ArmatureActionCache.h"
+
+extern "C" {
+#include "BKE_action.h"
+#include "BKE_animsys.h"
+#include "BKE_fcurve.h"
+
+#include "BLI_listbase.h"
+#include "BLI_string.h"
+#include "BLI_utildefines.h"
+
+#include "DNA_action_types.h"
+#include "DNA_anim_types.h"
+#include "DNA_object_types.h"
+
+#include "RNA_access.h"
+}
+
+#include "MEM_guardedalloc.h"
+
+#include <cmath>
+#include <cstring>
+
+/// Maximum number of values in a pose table, bigger actions are always sampled from curves.
+static const size_t POSE_TABLE_MAX_VALUES = 1 << 22;
+
+/// Return true if the F-Curve is evaluated, see animsys_evaluate_fcurves.
+static bool fcurve_is_evaluated(FCurve *fcu)
+{
+  if (fcu->grp && (fcu->grp->flag & AGRP_MUTED)) {
+    return false;
+  }
+  if (fcu->flag & (FCURVE_MUTED | FCURVE_DISABLED)) {
+    return false;
+  }
+  return !BKE_fcurve_is_empty(fcu);
+}
+
+/// Return the pose channel transform value animated by an F-Curve or nullptr.
+static float *get_pose_channel_value(bPose *pose, FCurve *fcu)
+{
+  const char *path = fcu->rna_path;
+  const int index = fcu->array_index;
+
+  // Only paths like pose.bones["name"].property are handled.
+  if (!pose || index < 0 || !STRPREFIX(path, "pose.bones[") ||
+      strchr(path, '[') != strrchr(path, '[')) {
+    return nullptr;
+  }
+
+  const char *prop = strrchr(path, '.');
+  if (*(prop - 1) != ']') {
+    return nullptr;
+  }
+
+  char *name = BLI_str_quoted_substrN(path, "pose.bones[");
+  bPoseChannel *pchan = BKE_pose_channel_find_name(pose, name);
+  MEM_freeN(name);
+
+  if (!pchan) {
+    return nullptr;
+  }
+
+  if (STREQ(prop, ".location") && index < 3) {
+    return &pchan->loc[index];
+  }
+  if (STREQ(prop, ".rotation_quaternion") && index < 4) {
+    return &pchan->quat[index];
+  }
+  if (STREQ(prop, ".rotation_euler") && index < 3) {
+    return &pchan->eul[index];
+  }
+  if (STREQ(prop, ".scale") && index < 3) {
+    return &pchan->size[index];
+  }
+  if (STREQ(prop, ".rotation_axis_angle") && index < 4) {
+    return (index == 0) ? &pchan->rotAngle : &pchan->rotAxis[index - 1];
+  }
+
+  return nullptr;
+}
+
+BL_ActionPoseTable::BL_ActionPoseTable(bAction *action) : m_start(0), m_end(-1), m_numCurves(0)
+{
+  float start, end;
+  calc_action_range(action, &start, &end, 0);
+
+  m_numCurves = BLI_listbase_count(&action->curves);
+  const int numFrames = (int)std::ceil(end) - (int)std::floor(start) + 1;
+  if (m_numCurves == 0 || numFrames <= 0 ||
+      (size_t)numFrames * m_numCurves > POSE_TABLE_MAX_VALUES) {
+    return;
+  }
+
+  m_start = (int)std::floor(start);
+  m_end = m_start + numFrames - 1;
+  m_values.resize(numFrames * m_numCurves, 0.0f);
+
+  unsigned int index = 0;
+  for (FCurve *fcu = (FCurve *)action->curves.first; fcu; fcu = fcu->next, ++index) {
+    // Driven curves are never sampled from the table.
+    if (fcu->driver || BKE_fcurve_is_empty(fcu)) {
+      continue;
+    }
+    for (int frame = 0; frame < numFrames; ++frame) {
+      m_values[frame * m_numCurves + index] = evaluate_fcurve(fcu, (float)(m_start + frame));
+    }
+  }
+}
+
+bool BL_ActionPoseTable::Sample(float frame, std::vector<float> &values) const
+{
+  if (m_values.empty() || frame < m_start || frame > m_end) {
+    return false;
+  }
+
+  const float offset = frame - m_start;
+  unsigned int prev = (unsigned int)offset;
+  float factor = offset - prev;
+  // Last frame.
+  if ((int)prev >= m_end - m_start) {
+    prev = m_end - m_start;
+    factor = 0.0f;
+  }
+  const unsigned int next = (factor > 0.0f) ? prev + 1 : prev;
+
+  values.resize(m_numCurves);
+  const float *prevValues = &m_values[prev * m_numCurves];
+  const float *nextValues = &m_values[next * m_numCurves];
+  for (unsigned int i = 0; i < m_numCurves; ++i) {
+    values[i] = prevValues[i] + (nextValues[i] - prevValues[i]) * factor;
+  }
+
+  return true;
+}
+
+const BL_ActionPoseTable *BL_ActionPoseTableList::GetTable(bAction *action)
+{
+  m_mutex.Lock();
+  std::unique_ptr<BL_ActionPoseTable> &table = m_tables[action];
+  if (!table) {
+    table.reset(new BL_ActionPoseTable(action));
+  }
+  m_mutex.Unlock();
+
+  return table.get();
+}
+
+void BL_ActionPoseTableList::RemoveTaggedTables()
+{
+  m_mutex.Lock();
+  for (std::map<bAction *, std::unique_ptr<BL_ActionPoseTable>>::iterator it = m_tables.begin();
+       it != m_tables.end();) {
+    if (it->first->id.tag & LIB_TAG_DOIT) {
+      it = m_tables.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+  m_mutex.Unlock();
+}
+
+BL_ArmatureActionCache::BL_ArmatureActionCache(Object *armature, bAction *action)
+    : m_table(nullptr)
+{
+  PointerRNA ptrrna;
+  RNA_id_pointer_create(&armature->id, &ptrrna);
+
+  unsigned int index = 0;
+  for (FCurve *fcu = (FCurve *)action->curves.first; fcu; fcu = fcu->next, ++index) {
+    if (!fcu->rna_path) {
+      continue;
+    }
+
+    float *value = (fcu->driver) ? nullptr : get_pose_channel_value(armature->pose, fcu);
+    if (value) {
+      m_channels.push_back({index, fcu, value});
+      continue;
+    }
+
+    // Fall back to the RNA setting for other properties, resolved only once.
+    RnaChannel channel = {index, fcu};
+    if (BKE_animsys_store_rna_setting(&ptrrna, fcu->rna_path, fcu->array_index, &channel.m_rna)) {
+      m_rnaChannels.push_back(channel);
+    }
+  }
+}
+
+void BL_ArmatureActionCache::SetPoseTable(const BL_ActionPoseTable *table)
+{
+  m_table = table;
+}
+
+bool BL_ArmatureActionCache::HasPoseTable() const
+{
+  return m_table != nullptr;
+}
+
+void BL_ArmatureActionCache::Evaluate(float frame)
+{
+  const bool useTable = m_table && m_table->Sample(frame, m_tableValues);
+
+  for (const Channel &channel : m_channels) {
+    if (!fcurve_is_evaluated(channel.m_fcurve)) {
+      continue;
+    }
+    *channel.m_value = (useTable) ? m_tableValues[channel.m_index] :
+                                    evaluate_fcurve(channel.m_fcurve, frame);
+  }
+
+  for (RnaChannel &channel : m_rnaChannels) {
+    if (!fcurve_is_evaluated(channel.m_fcurve)) {
+      continue;
+    }
+    const float value = calculate_fcurve(&channel.m_rna, channel.m_fcurve, frame);
+    BKE_animsys_write_rna_setting(&channel.m_rna, value);
+  }
+}
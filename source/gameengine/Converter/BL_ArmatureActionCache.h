@@ -0,0 +1,124 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file BL_ArmatureActionCache.h
+ *  \ingroup bgeconv
+ */
+
+#ifndef __BL_ARMATUREACTIONCACHE_H__
+#define __BL_ARMATUREACTIONCACHE_H__
+
+#include "CM_Thread.h"
+
+#include "RNA_types.h"
+
+#include <map>
+#include <memory>
+#include <vector>
+
+struct bAction;
+struct FCurve;
+struct Object;
+
+/** Dense table of the values of an action F-Curves sampled at each frame.
+ * The table only depends on the action and is shared by all the armatures playing it.
+ */
+class BL_ActionPoseTable {
+ private:
+  /// First and last sampled frames.
+  int m_start;
+  int m_end;
+  /// Number of sampled F-Curves per frame.
+  unsigned int m_numCurves;
+  /// Sampled values, frame by frame.
+  std::vector<float> m_values;
+
+ public:
+  BL_ActionPoseTable(bAction *action);
+  ~BL_ActionPoseTable() = default;
+
+  /** Get the values of all the F-Curves at a given frame.
+   * \param frame The frame to sample, can be between two sampled frames.
+   * \param values The array of values to fill, indexed by the F-Curve index in the action.
+   * \return False if the frame is outside of the sampled range.
+   */
+  bool Sample(float frame, std::vector<float> &values) const;
+};
+
+/// List of the pose tables of an armature and its replicas.
+class BL_ActionPoseTableList {
+ private:
+  std::map<bAction *, std::unique_ptr<BL_ActionPoseTable>> m_tables;
+  /// The replicas can request a table from the animation threads.
+  CM_ThreadMutex m_mutex;
+
+ public:
+  BL_ActionPoseTableList() = default;
+  ~BL_ActionPoseTableList() = default;
+
+  /// Return the pose table of an action, bake it if needed.
+  const BL_ActionPoseTable *GetTable(bAction *action);
+  /// Free the tables of the actions tagged to be freed with their library.
+  void RemoveTaggedTables();
+};
+
+/** Action F-Curves compiled for an armature object: the F-Curves animating a pose
+ * channel transform are linked to the channel value, the others keep their RNA path
+ * resolved once.
+ */
+class BL_ArmatureActionCache {
+ private:
+  struct Channel {
+    /// Index of the F-Curve in the action.
+    unsigned int m_index;
+    FCurve *m_fcurve;
+    /// Pose channel value written directly.
+    float *m_value;
+  };
+
+  struct RnaChannel {
+    unsigned int m_index;
+    FCurve *m_fcurve;
+    /// Resolved RNA property of the F-Curve.
+    PathResolvedRNA m_rna;
+  };
+
+  std::vector<Channel> m_channels;
+  std::vector<RnaChannel> m_rnaChannels;
+  /// Baked values of the action, optional.
+  const BL_ActionPoseTable *m_table;
+  /// Temporary values sampled from the table.
+  std::vector<float> m_tableValues;
+
+ public:
+  BL_ArmatureActionCache(Object *armature, bAction *action);
+  ~BL_ArmatureActionCache() = default;
+
+  /// Use a baked pose table to sample the pose channels F-Curves.
+  void SetPoseTable(const BL_ActionPoseTable *table);
+  bool HasPoseTable() const;
+
+  /// Write the action values at the given frame into the armature pose.
+  void Evaluate(float frame);
+};
+
+#endif  // __BL_ARMATUREACTIONCACHE_H__
@@ -52,6 +52,7 @@ extern "C" {
 }
 
 #include "BL_ArmatureObject.h"
+#include "BL_ArmatureActionCache.h"
 #include "BL_ActionActuator.h"
 #include "BL_Action.h"
 #include "KX_BlenderSceneConverter.h"
@@ -221,7 +222,8 @@ BL_ArmatureObject::BL_ArmatureObject(void *sgReplicationInfo,
       m_timestep(0.040),
       m_vert_deform_type(vert_deform_type),
       m_drawDebug(false),
-      m_lastapplyframe(0.0)
+      m_lastapplyframe(0.0),
+      m_poseTables(new BL_ActionPoseTableList())
 {
   m_controlledConstraints = new CListValue<BL_ArmatureConstraint>();
   m_poseChannels = new CListValue<BL_ArmatureChannel>();
@@ -243,6 +245,8 @@ BL_ArmatureObject::~BL_ArmatureObject()
   m_poseChannels->Release();
   m_controlledConstraints->Release();
 
+  ClearActionCaches();
+
   // if (m_objArma) {
   //	BKE_id_free(G.main, m_objArma->data);
   //	/* avoid BKE_libblock_free(G.main, m_objArma)
@@ -403,6 +407,9 @@ void BL_ArmatureObject::ProcessReplica()
 
   m_objArma = m_pBlenderObject;
   m_pose = m_objArma->pose;
+
+  // The compiled actions point to the pose of the original object.
+  m_actionCaches.clear();
 }
 
 int BL_ArmatureObject::GetGameObjectType() const
@@ -436,6 +443,24 @@ bool BL_ArmatureObject::UnlinkObject(SCA_IObject *clientobj)
   return res;
 }
 
+void BL_ArmatureObject::RemoveTaggedActions()
+{
+  KX_GameObject::RemoveTaggedActions();
+
+  // Forget the compiled and baked actions being freed, their addresses can be reused.
+  for (std::map<bAction *, BL_ArmatureActionCache *>::iterator it = m_actionCaches.begin();
+       it != m_actionCaches.end();) {
+    if (IS_TAGGED(it->first)) {
+      delete it->second;
+      it = m_actionCaches.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+  m_poseTables->RemoveTaggedTables();
+}
+
 void BL_ArmatureObject::ApplyPose()
 {
   m_armpose = m_objArma->pose;
@@ -453,6 +478,10 @@ void BL_ArmatureObject::ApplyPose()
     UpdateBlenderObjectMatrix(m_objArma);
     ViewLayer *view_layer = BKE_view_layer_default_view(m_scene);
     Depsgraph *depsgraph = BKE_scene_get_depsgraph(G_MAIN, m_scene, view_layer, false);
+    // The pose rebuild can free the channels referenced by the compiled actions.
+    if (m_pose->flag & POSE_RECALC) {
+      ClearActionCaches();
+    }
     BKE_pose_where_is(depsgraph, m_scene, m_objArma);
     // restore ourself
     memcpy(m_objArma->obmat, m_obmat, sizeof(m_obmat));
@@ -472,14 +501,27 @@ void BL_ArmatureObject::SetPose(bPose *pose)
   m_lastapplyframe = -1.0;
 }
 
-void BL_ArmatureObject::SetPoseByAction(bAction *action, float localtime)
+void BL_ArmatureObject::SetPoseByAction(bAction *action, float localtime, bool useTable)
 {
-  Object *arm = GetArmatureObject();
+  // Compile the action the first time it is played to avoid resolving the RNA paths every frame.
+  BL_ArmatureActionCache *&cache = m_actionCaches[action];
+  if (!cache) {
+    cache = new BL_ArmatureActionCache(GetArmatureObject(), action);
+  }
+
+  if (useTable && !cache->HasPoseTable()) {
+    cache->SetPoseTable(m_poseTables->GetTable(action));
+  }
 
-  PointerRNA ptrrna;
-  RNA_id_pointer_create(&arm->id, &ptrrna);
+  cache->Evaluate(localtime);
+}
 
-  animsys_evaluate_action(&ptrrna, action, localtime, false);
+void BL_ArmatureObject::ClearActionCaches()
+{
+  for (const auto &pair : m_actionCaches) {
+    delete pair.second;
+  }
+  m_actionCaches.clear();
 }
 
 void BL_ArmatureObject::BlendInPose(bPose *blend_pose, float weight, short mode)
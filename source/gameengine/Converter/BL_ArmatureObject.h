@@ -36,6 +36,9 @@
 #include "BL_ArmatureConstraint.h"
 #include "BL_ArmatureChannel.h"
 
+#include <memory>
+
+struct bAction;
 struct bArmature;
 struct Bone;
 struct bPose;
@@ -44,6 +47,8 @@ struct Object;
 class MT_Matrix4x4;
 class KX_BlenderSceneConverter;
 class RAS_DebugDraw;
+class BL_ArmatureActionCache;
+class BL_ActionPoseTableList;
 
 class BL_ArmatureObject : public KX_GameObject {
   Py_Header
@@ -72,6 +77,11 @@ class BL_ArmatureObject : public KX_GameObject {
 
   double m_lastapplyframe;
 
+  /// Actions compiled for this armature, owned by the armature and not shared with replicas.
+  std::map<bAction *, BL_ArmatureActionCache *> m_actionCaches;
+  /// Baked actions shared with the replicas.
+  std::shared_ptr<BL_ActionPoseTableList> m_poseTables;
+
  public:
   BL_ArmatureObject(void *sgReplicationInfo,
                     SG_Callbacks callbacks,
@@ -86,6 +96,7 @@ class BL_ArmatureObject : public KX_GameObject {
   virtual void ReParentLogic();
   virtual void Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_map);
   virtual bool UnlinkObject(SCA_IObject *clientobj);
+  virtual void RemoveTaggedActions();
 
   double GetLastFrame();
 
@@ -94,7 +105,12 @@ class BL_ArmatureObject : public KX_GameObject {
   /// Never edit this, only for accessing names.
   bPose *GetOrigPose();
   void ApplyPose();
-  void SetPoseByAction(bAction *action, float localtime);
+  /** Set the pose from the action at the given frame.
+   * \param useTable Sample the bone transforms from a table baked for all the frames of the action.
+   */
+  void SetPoseByAction(bAction *action, float localtime, bool useTable);
+  /// Free the compiled actions, they are compiled again the next time they are played.
+  void ClearActionCaches();
   void BlendInPose(bPose *blend_pose, float weight, short mode);
   void RestorePose();
 
@@ -1670,6 +1670,10 @@ void BL_ConvertBlenderObjects(struct Main *maggie,
     Object *blenderobj = gameobj->GetBlenderObject();
     BL_ConvertComponentsObject(gameobj, blenderobj);
   }
+  // Only the components of the active objects are updated.
+  for (KX_GameObject *gameobj : objectlist) {
+    kxscene->RegisterComponents(gameobj);
+  }
 
   // cleanup converted set of group objects
   convertedlist->Release();
@@ -85,6 +85,9 @@ extern "C" {
 #include "BLI_task.h"
 #include "CM_Message.h"
 
+#include "MEM_guardedalloc.h"
+#include "PIL_time.h"
+
 #include <cstring>
 
 KX_BlenderConverter::SceneSlot::SceneSlot() = default;
@@ -121,7 +124,10 @@ void KX_BlenderConverter::SceneSlot::Merge(const KX_BlenderSceneConverter &conve
 }
 
 KX_BlenderConverter::KX_BlenderConverter(Main *maggie, KX_KetsjiEngine *engine)
-    : m_maggie(maggie), m_ketsjiEngine(engine), m_alwaysUseExpandFraming(false)
+    : m_maggie(maggie),
+      m_ketsjiEngine(engine),
+      m_alwaysUseExpandFraming(false),
+      m_mergeTimeBudget(0.0)
 {
   BKE_main_id_tag_all(maggie, LIB_TAG_DOIT, false);  // avoid re-tagging later on
   m_threadinfo.m_pool = BLI_task_pool_create(engine->GetTaskScheduler(), nullptr);
@@ -136,6 +142,8 @@ KX_BlenderConverter::~KX_BlenderConverter()
 
   m_DynamicMaggie.clear();
 
+  FreeFailedLoads(true);
+
   /* Thread infos like mutex must be freed after FreeBlendFile function.
      Because it needs to lock the mutex, even if there's no active task when it's
      in the scene converter destructor. */
@@ -310,32 +318,143 @@ Main *KX_BlenderConverter::GetMainDynamicPath(const std::string &path) const
   return nullptr;
 }
 
+/// Data of an asynchronous library loading, deleted once the library is merged.
+struct AsyncLibLoadData {
+  /// Handle of a library loaded from memory, the file is opened by the loading task otherwise.
+  BlendHandle *m_handle;
+  /// Copy of the library memory, freed once the library is read.
+  void *m_buffer;
+  int m_idcode;
+  short m_options;
+  /// The linked library, nullptr if it couldn't be read.
+  Main *m_main;
+  /// The converted scenes to merge.
+  std::vector<KX_Scene *> m_scenes;
+  /// Number of merge steps done, the first one registers the library.
+  unsigned int m_mergeStep;
+  /// Next mesh to convert of a mesh library, the meshes are converted one per step.
+  ID *m_mesh;
+  unsigned int m_numMeshes;
+  /// Converter shared by the mesh steps, so that the materials are converted once.
+  KX_BlenderSceneConverter m_sceneConverter;
+};
+
+/// Part of the progress of an asynchronous loading for reading, converting and merging.
+static const float LIB_LOAD_READ_PROGRESS = 0.3f;
+static const float LIB_LOAD_CONVERT_PROGRESS = 0.6f;
+static const float LIB_LOAD_MERGE_PROGRESS = 0.1f;
+
+bool KX_BlenderConverter::MergeAsyncLoad(KX_LibLoadStatus *status)
+{
+  AsyncLibLoadData *data = (AsyncLibLoadData *)status->GetData();
+  KX_Scene *scene_merge = status->GetMergeScene();
+
+  if (!data->m_main) {
+    CM_Error("could not open blendfile \"" << status->GetLibraryName() << "\"");
+    return true;
+  }
+
+  if (data->m_mergeStep == 0) {
+    // Lookups of the library are allowed only once it's registered.
+    m_DynamicMaggie.push_back(data->m_main);
+    if (data->m_idcode == ID_ME) {
+      data->m_mesh = (ID *)data->m_main->meshes.first;
+      data->m_numMeshes = BLI_listbase_count(&data->m_main->meshes);
+    }
+    else {
+      ConvertLibraryData(data->m_main, data->m_idcode, scene_merge, data->m_options);
+    }
+  }
+  else if (data->m_mesh) {
+    KX_BlenderSceneConverter &sceneConverter = data->m_sceneConverter;
+    ConvertLibraryMesh((Mesh *)data->m_mesh, scene_merge, sceneConverter, data->m_options);
+    data->m_mesh = (ID *)data->m_mesh->next;
+
+    // The scene owns the converted data from now, the converter only keeps its lookups.
+    m_sceneSlots[scene_merge].Merge(sceneConverter);
+    sceneConverter.m_materials.clear();
+    sceneConverter.m_meshobjects.clear();
+
+    status->AddProgress(LIB_LOAD_MERGE_PROGRESS / data->m_numMeshes);
+  }
+  else {
+    KX_Scene *other = data->m_scenes[data->m_mergeStep - 1];
+    scene_merge->MergeScene(other);
+    delete other;
+
+    status->AddProgress(LIB_LOAD_MERGE_PROGRESS / data->m_scenes.size());
+  }
+
+  ++data->m_mergeStep;
+  // A library has either meshes or scenes to merge.
+  return (!data->m_mesh && data->m_mergeStep > data->m_scenes.size());
+}
+
+void KX_BlenderConverter::FreeFailedLoads(bool force)
+{
+  for (std::vector<KX_LibLoadStatus *>::iterator it = m_failedStatus.begin();
+       it != m_failedStatus.end();) {
+    KX_LibLoadStatus *status = *it;
+    if (force || !status->IsUsedByPython()) {
+      delete status;
+      it = m_failedStatus.erase(it);
+    }
+    else {
+      ++it;
+    }
+  }
+}
+
 void KX_BlenderConverter::MergeAsyncLoads()
 {
-  std::vector<KX_Scene *> *merge_scenes;
+  FreeFailedLoads(false);
 
-  std::vector<KX_LibLoadStatus *>::iterator mit;
-  std::vector<KX_Scene *>::iterator sit;
+  const double starttime = PIL_check_seconds_timer();
+  bool merged = false;
 
-  m_threadinfo.m_mutex.Lock();
+  while (true) {
+    // Only the loading tasks append to the queue, the front is not modified meanwhile.
+    m_threadinfo.m_mutex.Lock();
+    KX_LibLoadStatus *status = (m_mergequeue.empty()) ? nullptr : m_mergequeue.front();
+    m_threadinfo.m_mutex.Unlock();
 
-  for (mit = m_mergequeue.begin(); mit != m_mergequeue.end(); ++mit) {
-    merge_scenes = (std::vector<KX_Scene *> *)(*mit)->GetData();
+    if (!status) {
+      break;
+    }
 
-    for (sit = merge_scenes->begin(); sit != merge_scenes->end(); ++sit) {
-      (*mit)->GetMergeScene()->MergeScene(*sit);
-      delete (*sit);
+    // Merge at least one step per frame, then until the time budget is spent.
+    if (merged && m_mergeTimeBudget > 0.0 &&
+        (PIL_check_seconds_timer() - starttime) > m_mergeTimeBudget) {
+      break;
     }
 
-    delete merge_scenes;
-    (*mit)->SetData(nullptr);
+    const bool finished = MergeAsyncLoad(status);
+    merged = true;
 
-    (*mit)->Finish();
-  }
+    if (!finished) {
+      continue;
+    }
 
-  m_mergequeue.clear();
+    m_threadinfo.m_mutex.Lock();
+    m_mergequeue.erase(m_mergequeue.begin());
+    m_threadinfo.m_mutex.Unlock();
 
-  m_threadinfo.m_mutex.Unlock();
+    AsyncLibLoadData *data = (AsyncLibLoadData *)status->GetData();
+    Main *maggie = data->m_main;
+    delete data;
+    status->SetData(nullptr);
+
+    if (maggie) {
+      status->Finish();
+    }
+    else {
+      status->Fail();
+      /* A library which failed to be read can be loaded again, its status is kept until
+       * python releases it. */
+      m_status_map.erase(status->GetLibraryName());
+      m_failedStatus.push_back(status);
+    }
+  }
 }
 
 void KX_BlenderConverter::FinalizeAsyncLoads()
@@ -343,7 +462,10 @@ void KX_BlenderConverter::FinalizeAsyncLoads()
   // Finish all loading libraries.
   BLI_task_pool_work_and_wait(m_threadinfo.m_pool);
   // Merge all libraries data in the current scene, to avoid memory leak of unmerged scenes.
+  const double budget = m_mergeTimeBudget;
+  m_mergeTimeBudget = 0.0;
   MergeAsyncLoads();
+  m_mergeTimeBudget = budget;
 }
 
 void KX_BlenderConverter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
@@ -353,27 +475,96 @@ void KX_BlenderConverter::AddScenesToMergeQueue(KX_LibLoadStatus *status)
   m_threadinfo.m_mutex.Unlock();
 }
 
-static void async_convert(TaskPool *pool, void *ptr, int UNUSED(threadid))
+void KX_BlenderConverter::SetMergeTimeBudget(double budget)
 {
-  KX_Scene *new_scene = nullptr;
-  KX_LibLoadStatus *status = (KX_LibLoadStatus *)ptr;
-  std::vector<Scene *> *scenes = (std::vector<Scene *> *)status->GetData();
-  std::vector<KX_Scene *> *merge_scenes =
-      new std::vector<KX_Scene *>();  // Deleted in MergeAsyncLoads
+  m_mergeTimeBudget = budget;
+}
+
+double KX_BlenderConverter::GetMergeTimeBudget() const
+{
+  return m_mergeTimeBudget;
+}
 
-  for (unsigned int i = 0; i < scenes->size(); ++i) {
-    new_scene = status->GetEngine()->CreateScene((*scenes)[i], true);
+static void load_datablocks(Main *main_tmp, BlendHandle *bpy_openlib, const char *path, int idcode)
+{
+  LinkNode *names = nullptr;
 
-    if (new_scene) {
-      merge_scenes->push_back(new_scene);
-    }
+  int totnames_dummy;
+  names = BLO_blendhandle_get_datablock_names(bpy_openlib, idcode, &totnames_dummy);
 
-    status->AddProgress((1.0f / scenes->size()) *
-                        0.9f);  // We'll call conversion 90% and merging 10% for now
+  int i = 0;
+  LinkNode *n = names;
+  while (n) {
+    BLO_library_link_named_part(main_tmp, &bpy_openlib, idcode, (char *)n->link);
+    n = (LinkNode *)n->next;
+    i++;
+  }
+  BLI_linklist_free(names, free);  // free linklist *and* each node's data
+}
+
+/// Link all the datablocks of a library into a new main, the handle is closed.
+static Main *link_blend_file(BlendHandle *bpy_openlib, const char *path, int idcode, short options)
+{
+  Main *main_newlib = BKE_main_new();  // stored as a dynamic 'main' until we free it
+
+  short flag = 0;  // don't need any special options
+  // created only for linking, then freed
+  Main *main_tmp = BLO_library_link_begin(main_newlib, &bpy_openlib, (char *)path);
+
+  load_datablocks(main_tmp, bpy_openlib, path, idcode);
+
+  if (idcode == ID_SCE && options & KX_BlenderConverter::LIB_LOAD_LOAD_SCRIPTS) {
+    load_datablocks(main_tmp, bpy_openlib, path, ID_TXT);
+  }
+
+  // now do another round of linking for Scenes so all actions are properly loaded
+  if (idcode == ID_SCE && options & KX_BlenderConverter::LIB_LOAD_LOAD_ACTIONS) {
+    load_datablocks(main_tmp, bpy_openlib, path, ID_AC);
+  }
+
+  BLO_library_link_end(main_tmp, &bpy_openlib, flag, main_newlib, nullptr, nullptr, nullptr);
+
+  BLO_blendhandle_close(bpy_openlib);
+  // done linking
+
+  BLI_strncpy(main_newlib->name, path, sizeof(main_newlib->name));
+
+  return main_newlib;
+}
+
+static void async_load(TaskPool *pool, void *ptr, int UNUSED(threadid))
+{
+  KX_LibLoadStatus *status = (KX_LibLoadStatus *)ptr;
+  AsyncLibLoadData *data = (AsyncLibLoadData *)status->GetData();
+  const char *path = status->GetLibraryName().c_str();
+
+  BlendHandle *bpy_openlib = (data->m_handle) ? data->m_handle :
+                                                BLO_blendhandle_from_file(path, nullptr);
+  if (bpy_openlib) {
+    data->m_main = link_blend_file(bpy_openlib, path, data->m_idcode, data->m_options);
+  }
+  data->m_handle = nullptr;
+
+  if (data->m_buffer) {
+    MEM_freeN(data->m_buffer);
+    data->m_buffer = nullptr;
   }
 
-  delete scenes;
-  status->SetData(merge_scenes);
+  status->AddProgress(LIB_LOAD_READ_PROGRESS);
+
+  if (data->m_main && data->m_idcode == ID_SCE) {
+    const unsigned int numScenes = BLI_listbase_count(&data->m_main->scenes);
+    for (Scene *scene = (Scene *)data->m_main->scenes.first; scene;
+         scene = (Scene *)scene->id.next) {
+      KX_Scene *new_scene = status->GetEngine()->CreateScene(scene, true);
+
+      if (new_scene) {
+        data->m_scenes.push_back(new_scene);
+      }
+
+      status->AddProgress(LIB_LOAD_CONVERT_PROGRESS / numScenes);
+    }
+  }
 
   status->GetConverter()->AddScenesToMergeQueue(status);
 }
@@ -386,6 +577,15 @@ KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFileMemory(void *data,
                                                            char **err_str,
                                                            short options)
 {
+  if (options & LIB_LOAD_ASYNC) {
+    // The memory is released by the caller, keep a copy until the library is read.
+    void *buffer = MEM_mallocN(length, __func__);
+    memcpy(buffer, data, length);
+    BlendHandle *bpy_openlib = BLO_blendhandle_from_memory(buffer, length);
+
+    return LinkBlendFileAsync(bpy_openlib, buffer, path, group, scene_merge, err_str, options);
+  }
+
   BlendHandle *bpy_openlib = BLO_blendhandle_from_memory(data, length);
 
   // Error checking is done in LinkBlendFile
@@ -395,27 +595,122 @@ KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFileMemory(void *data,
 KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFilePath(
     const char *filepath, char *group, KX_Scene *scene_merge, char **err_str, short options)
 {
+  if (options & LIB_LOAD_ASYNC) {
+    // The file is opened and read by the loading task.
+    return LinkBlendFileAsync(nullptr, nullptr, filepath, group, scene_merge, err_str, options);
+  }
+
   BlendHandle *bpy_openlib = BLO_blendhandle_from_file(filepath, nullptr);
 
   // Error checking is done in LinkBlendFile
   return LinkBlendFile(bpy_openlib, filepath, group, scene_merge, err_str, options);
 }
 
-static void load_datablocks(Main *main_tmp, BlendHandle *bpy_openlib, const char *path, int idcode)
+bool KX_BlenderConverter::IsBlendFileLinked(const char *path) const
 {
-  LinkNode *names = nullptr;
+  // Asynchronous loadings register their library only once it's read.
+  return (GetMainDynamicPath(path) || m_status_map.count(path));
+}
 
-  int totnames_dummy;
-  names = BLO_blendhandle_get_datablock_names(bpy_openlib, idcode, &totnames_dummy);
+void KX_BlenderConverter::ConvertLibraryData(Main *main_newlib,
+                                             int idcode,
+                                             KX_Scene *scene_merge,
+                                             short options)
+{
+  if (idcode == ID_ME) {
+    // Convert all new meshes into BGE meshes
+    KX_BlenderSceneConverter sceneConverter;
+    for (ID *mesh = (ID *)main_newlib->meshes.first; mesh; mesh = (ID *)mesh->next) {
+      ConvertLibraryMesh((Mesh *)mesh, scene_merge, sceneConverter, options);
+    }
+    m_sceneSlots[scene_merge].Merge(sceneConverter);
+  }
+  else if (idcode == ID_AC || (idcode == ID_SCE && options & LIB_LOAD_LOAD_ACTIONS)) {
+    // Convert all actions
+    ID *action;
 
-  int i = 0;
-  LinkNode *n = names;
-  while (n) {
-    BLO_library_link_named_part(main_tmp, &bpy_openlib, idcode, (char *)n->link);
-    n = (LinkNode *)n->next;
-    i++;
+    for (action = (ID *)main_newlib->actions.first; action; action = (ID *)action->next) {
+      if (options & LIB_LOAD_VERBOSE) {
+        CM_Debug("action name: " << action->name + 2);
+      }
+      scene_merge->GetLogicManager()->RegisterActionName(action->name + 2, action);
+    }
   }
-  BLI_linklist_free(names, free);  // free linklist *and* each node's data
+
+#ifdef WITH_PYTHON
+  // Handle any text datablocks
+  if (idcode == ID_SCE && options & LIB_LOAD_LOAD_SCRIPTS) {
+    addImportMain(main_newlib);
+  }
+#endif
+}
+
+void KX_BlenderConverter::ConvertLibraryMesh(Mesh *mesh,
+                                             KX_Scene *scene_merge,
+                                             KX_BlenderSceneConverter &sceneConverter,
+                                             short options)
+{
+  if (options & LIB_LOAD_VERBOSE) {
+    CM_Debug("mesh name: " << mesh->id.name + 2);
+  }
+  RAS_MeshObject *meshobj = BL_ConvertMesh(
+      mesh,
+      nullptr,
+      scene_merge,
+      m_ketsjiEngine->GetRasterizer(),
+      sceneConverter,
+      false);  // For now only use the libloading option for scenes, which need to handle
+               // materials/shaders
+  scene_merge->GetLogicManager()->RegisterMeshName(meshobj->GetName(), meshobj);
+}
+
+KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFileAsync(BlendHandle *bpy_openlib,
+                                                          void *buffer,
+                                                          const char *path,
+                                                          char *group,
+                                                          KX_Scene *scene_merge,
+                                                          char **err_str,
+                                                          short options)
+{
+  const int idcode = BKE_idcode_from_name(group);
+  static char err_local[255];
+
+  const char *err_format = nullptr;
+  // only scene and mesh supported right now
+  if (idcode != ID_SCE && idcode != ID_ME && idcode != ID_AC) {
+    snprintf(err_local, sizeof(err_local), "invalid ID type given \"%s\"\n", group);
+  }
+  else if (IsBlendFileLinked(path)) {
+    err_format = "blend file already open \"%s\"\n";
+  }
+  else if (buffer ? !bpy_openlib : !BLI_is_file(path)) {
+    err_format = "could not open blendfile \"%s\"\n";
+  }
+  else {
+    KX_LibLoadStatus *status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene_merge, path);
+    // Deleted in MergeAsyncLoads.
+    status->SetData(
+        new AsyncLibLoadData{bpy_openlib, buffer, idcode, options, nullptr, {}, 0, nullptr, 0});
+    m_status_map[path] = status;
+
+    BLI_task_pool_push(m_threadinfo.m_pool, async_load, (void *)status, false, TASK_PRIORITY_LOW);
+
+    return status;
+  }
+
+  if (err_format) {
+    snprintf(err_local, sizeof(err_local), err_format, path);
+  }
+  *err_str = err_local;
+
+  if (bpy_openlib) {
+    BLO_blendhandle_close(bpy_openlib);
+  }
+  if (buffer) {
+    MEM_freeN(buffer);
+  }
+
+  return nullptr;
 }
 
 KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib,
@@ -425,13 +720,9 @@ KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib,
                                                      char **err_str,
                                                      short options)
 {
-  Main *main_newlib;  // stored as a dynamic 'main' until we free it
   const int idcode = BKE_idcode_from_name(group);
-  ReportList reports;
   static char err_local[255];
 
-  KX_LibLoadStatus *status;
-
   // only scene and mesh supported right now
   if (idcode != ID_SCE && idcode != ID_ME && idcode != ID_AC) {
     snprintf(err_local, sizeof(err_local), "invalid ID type given \"%s\"\n", group);
@@ -440,7 +731,7 @@ KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib,
     return nullptr;
   }
 
-  if (GetMainDynamicPath(path)) {
+  if (IsBlendFileLinked(path)) {
     snprintf(err_local, sizeof(err_local), "blend file already open \"%s\"\n", path);
     *err_str = err_local;
     BLO_blendhandle_close(bpy_openlib);
@@ -453,124 +744,33 @@ KX_LibLoadStatus *KX_BlenderConverter::LinkBlendFile(BlendHandle *bpy_openlib,
     return nullptr;
   }
 
-  main_newlib = BKE_main_new();
-  BKE_reports_init(&reports, RPT_STORE);
-
-  short flag = 0;  // don't need any special options
-  // created only for linking, then freed
-  Main *main_tmp = BLO_library_link_begin(main_newlib, &bpy_openlib, (char *)path);
-
-  load_datablocks(main_tmp, bpy_openlib, path, idcode);
-
-  if (idcode == ID_SCE && options & LIB_LOAD_LOAD_SCRIPTS) {
-    load_datablocks(main_tmp, bpy_openlib, path, ID_TXT);
-  }
-
-  // now do another round of linking for Scenes so all actions are properly loaded
-  if (idcode == ID_SCE && options & LIB_LOAD_LOAD_ACTIONS) {
-    load_datablocks(main_tmp, bpy_openlib, path, ID_AC);
-  }
-
-  BLO_library_link_end(main_tmp, &bpy_openlib, flag, main_newlib, nullptr, nullptr, nullptr);
-
-  BLO_blendhandle_close(bpy_openlib);
-
-  BKE_reports_clear(&reports);
-  // done linking
+  Main *main_newlib = link_blend_file(bpy_openlib, path, idcode, options);
 
   // needed for lookups
   m_DynamicMaggie.push_back(main_newlib);
-  BLI_strncpy(main_newlib->name, path, sizeof(main_newlib->name));
 
-  status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene_merge, path);
+  KX_LibLoadStatus *status = new KX_LibLoadStatus(this, m_ketsjiEngine, scene_merge, path);
 
-  if (idcode == ID_ME) {
-    // Convert all new meshes into BGE meshes
-    ID *mesh;
+  ConvertLibraryData(main_newlib, idcode, scene_merge, options);
 
-    KX_BlenderSceneConverter sceneConverter;
-    for (mesh = (ID *)main_newlib->meshes.first; mesh; mesh = (ID *)mesh->next) {
-      if (options & LIB_LOAD_VERBOSE) {
-        CM_Debug("mesh name: " << mesh->name + 2);
-      }
-      RAS_MeshObject *meshobj = BL_ConvertMesh(
-          (Mesh *)mesh,
-          nullptr,
-          scene_merge,
-          m_ketsjiEngine->GetRasterizer(),
-          sceneConverter,
-          false);  // For now only use the libloading option for scenes, which need to handle
-                   // materials/shaders
-      scene_merge->GetLogicManager()->RegisterMeshName(meshobj->GetName(), meshobj);
-    }
-    m_sceneSlots[scene_merge].Merge(sceneConverter);
-  }
-  else if (idcode == ID_AC) {
-    // Convert all actions
-    ID *action;
-
-    for (action = (ID *)main_newlib->actions.first; action; action = (ID *)action->next) {
-      if (options & LIB_LOAD_VERBOSE) {
-        CM_Debug("action name: " << action->name + 2);
-      }
-      scene_merge->GetLogicManager()->RegisterActionName(action->name + 2, action);
-    }
-  }
-  else if (idcode == ID_SCE) {
+  if (idcode == ID_SCE) {
     // Merge all new linked in scene into the existing one
-    ID *scene;
-    // scenes gets deleted by the thread when it's done using it (look in async_convert())
-    std::vector<Scene *> *scenes = (options & LIB_LOAD_ASYNC) ? new std::vector<Scene *>() :
-                                                                nullptr;
-
-    for (scene = (ID *)main_newlib->scenes.first; scene; scene = (ID *)scene->next) {
+    for (ID *scene = (ID *)main_newlib->scenes.first; scene; scene = (ID *)scene->next) {
       if (options & LIB_LOAD_VERBOSE) {
         CM_Debug("scene name: " << scene->name + 2);
       }
 
-      if (options & LIB_LOAD_ASYNC) {
-        scenes->push_back((Scene *)scene);
-      }
-      else {
-        // merge into the base  scene
-        KX_Scene *other = m_ketsjiEngine->CreateScene((Scene *)scene, true);
-        scene_merge->MergeScene(other);
+      // merge into the base  scene
+      KX_Scene *other = m_ketsjiEngine->CreateScene((Scene *)scene, true);
+      scene_merge->MergeScene(other);
 
-        // RemoveScene(other); // Don't run this, it frees the entire scene converter data, just
-        // delete the scene
-        delete other;
-      }
-    }
-
-    if (options & LIB_LOAD_ASYNC) {
-      status->SetData(scenes);
-      BLI_task_pool_push(
-          m_threadinfo.m_pool, async_convert, (void *)status, false, TASK_PRIORITY_LOW);
-    }
-
-#ifdef WITH_PYTHON
-    // Handle any text datablocks
-    if (options & LIB_LOAD_LOAD_SCRIPTS) {
-      addImportMain(main_newlib);
-    }
-#endif
-
-    // Now handle all the actions
-    if (options & LIB_LOAD_LOAD_ACTIONS) {
-      ID *action;
-
-      for (action = (ID *)main_newlib->actions.first; action; action = (ID *)action->next) {
-        if (options & LIB_LOAD_VERBOSE) {
-          CM_Debug("action name: " << action->name + 2);
-        }
-        scene_merge->GetLogicManager()->RegisterActionName(action->name + 2, action);
-      }
+      // RemoveScene(other); // Don't run this, it frees the entire scene converter data, just
+      // delete the scene
+      delete other;
     }
   }
 
-  if (!(options & LIB_LOAD_ASYNC)) {
-    status->Finish();
-  }
+  status->Finish();
 
   m_status_map[main_newlib->name] = status;
   return status;
@@ -652,6 +852,9 @@ bool KX_BlenderConverter::FreeBlendFile(Main *maggie)
         }
       }
 
+      // Free the hidden copies of the tagged objects.
+      scene->FreeReplicaObjectPool(true);
+
       // removed tagged objects and meshes
       CListValue<KX_GameObject> *obj_lists[] = {
           scene->GetObjectList(), scene->GetInactiveList(), nullptr};
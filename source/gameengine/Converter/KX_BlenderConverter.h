@@ -95,6 +95,8 @@ class KX_BlenderConverter {
   // Saved KX_LibLoadStatus objects
   std::map<std::string, KX_LibLoadStatus *> m_status_map;
   std::vector<KX_LibLoadStatus *> m_mergequeue;
+  /// Status of the libraries which failed to be read, freed once python releases them.
+  std::vector<KX_LibLoadStatus *> m_failedStatus;
 
   Main *m_maggie;
   std::vector<Main *> m_DynamicMaggie;
@@ -102,6 +104,24 @@ class KX_BlenderConverter {
   KX_KetsjiEngine *m_ketsjiEngine;
   bool m_alwaysUseExpandFraming;
 
+  /// Maximum time spent per frame to merge asynchronously loaded libraries, 0 for no limit.
+  double m_mergeTimeBudget;
+
+  /// Register the meshes, actions and scripts of a linked library in a scene.
+  void ConvertLibraryData(Main *main_newlib, int idcode, KX_Scene *scene_merge, short options);
+  /// Convert and register a mesh of a linked library in a scene.
+  void ConvertLibraryMesh(Mesh *mesh,
+                          KX_Scene *scene_merge,
+                          KX_BlenderSceneConverter &sceneConverter,
+                          short options);
+  /** Do the next merge step of an asynchronously loaded library: register the library,
+   * convert one of its meshes or merge one of its scenes. A scene is merged in one step.
+   * \return True if the library is completely merged.
+   */
+  bool MergeAsyncLoad(KX_LibLoadStatus *status);
+  /// Free the status of the failed loadings not referenced by python anymore.
+  void FreeFailedLoads(bool force);
+
  public:
   KX_BlenderConverter(Main *maggie, KX_KetsjiEngine *engine);
   virtual ~KX_BlenderConverter();
@@ -146,6 +166,20 @@ class KX_BlenderConverter {
                                   KX_Scene *scene_merge,
                                   char **err_str,
                                   short options);
+  /** Read, link and convert a library in the task pool, the data is merged later
+   * by MergeAsyncLoads.
+   * \param bpy_openlib The handle of a library in memory or nullptr to read the file at path.
+   * \param buffer The memory of the library owned by the loading, can be nullptr.
+   */
+  KX_LibLoadStatus *LinkBlendFileAsync(BlendHandle *bpy_openlib,
+                                       void *buffer,
+                                       const char *path,
+                                       char *group,
+                                       KX_Scene *scene_merge,
+                                       char **err_str,
+                                       short options);
+  /// Return true if the library is loaded or being loaded.
+  bool IsBlendFileLinked(const char *path) const;
 
   bool FreeBlendFile(Main *maggie);
   bool FreeBlendFile(const std::string &path);
@@ -154,10 +188,14 @@ class KX_BlenderConverter {
 
   void MergeScene(KX_Scene *to, KX_Scene *from);
 
+  /// Merge the asynchronously loaded libraries, within the merge time budget.
   void MergeAsyncLoads();
   void FinalizeAsyncLoads();
   void AddScenesToMergeQueue(KX_LibLoadStatus *status);
 
+  void SetMergeTimeBudget(double budget);
+  double GetMergeTimeBudget() const;
+
   void PrintStats();
 
   // LibLoad Options.
@@ -443,6 +443,11 @@ void BL_ConvertActuators(const char *maggiename,
                 editobact->angVelocity,
                 (editobact->localflag & ACT_EDOB_LOCAL_ANGV) != 0);
 
+            // Prewarm the hidden copies of the added object.
+            if (originalval && editobact->pool_size > 0) {
+              scene->SetReplicaPoolSize(originalval, editobact->pool_size);
+            }
+
             // editobact->ob to gameobj
             baseact = tmpaddact;
           } break;
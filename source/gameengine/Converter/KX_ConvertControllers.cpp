@@ -152,6 +152,7 @@ void BL_ConvertControllers(struct Object *blenderobject,
               MEM_freeN(buf);
             }
           }
+          pyctrl->SetUseFunction(pycont->flag & CONT_PY_FUNCTION);
         }
         else {
           /* let the controller print any warnings here when importing */
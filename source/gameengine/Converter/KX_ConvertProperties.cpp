@@ -115,7 +115,7 @@ void BL_ConvertProperties(Object *object,
         // we can register the replica of this property
         // at the time a game object is replicated (AddObjectActuator triggers this)
         CValue *bval = new CBoolValue(true);
-        timeval->SetProperty("timer", bval);
+        timeval->SetProperty(SCA_TimeEventManager::sTimerKey, bval);
         bval->Release();
         if (isInActiveLayer) {
           timemgr->AddTimeProperty(timeval);
@@ -182,7 +182,7 @@ void BL_ConvertTextProperty(Object *object,
                             SCA_IScene *scene,
                             bool isInActiveLayer)
 {
-  CValue *tprop = fontobj->GetProperty("Text");
+  CValue *tprop = fontobj->GetProperty(KX_FontObject::sTextKey);
   if (!tprop)
     return;
   bProperty *prop = BKE_bproperty_object_get(object, "Text");
@@ -226,7 +226,7 @@ void BL_ConvertTextProperty(Object *object,
       // we can register the replica of this property
       // at the time a game object is replicated (AddObjectActuator triggers this)
       CValue *bval = new CBoolValue(true);
-      propval->SetProperty("timer", bval);
+      propval->SetProperty(SCA_TimeEventManager::sTimerKey, bval);
       bval->Release();
       if (isInActiveLayer) {
         timemgr->AddTimeProperty(propval);
@@ -37,7 +37,8 @@ KX_LibLoadStatus::KX_LibLoadStatus(class KX_BlenderConverter *kx_converter,
       m_data(nullptr),
       m_libname(path),
       m_progress(0.0f),
-      m_finished(false)
+      m_finished(false),
+      m_failed(false)
 #ifdef WITH_PYTHON
       ,
       m_finish_cb(nullptr),
@@ -57,6 +58,22 @@ void KX_LibLoadStatus::Finish()
   RunProgressCallback();
 }
 
+void KX_LibLoadStatus::Fail()
+{
+  m_failed = true;
+  m_endtime = PIL_check_seconds_timer();
+}
+
+bool KX_LibLoadStatus::IsUsedByPython() const
+{
+#ifdef WITH_PYTHON
+  // The proxy holds a reference for the status itself.
+  return (m_proxy && Py_REFCNT(m_proxy) > 1);
+#else
+  return false;
+#endif
+}
+
 void KX_LibLoadStatus::RunFinishCallback()
 {
 #ifdef WITH_PYTHON
@@ -109,6 +126,11 @@ class KX_Scene *KX_LibLoadStatus::GetMergeScene()
   return m_mergescene;
 }
 
+const std::string &KX_LibLoadStatus::GetLibraryName() const
+{
+  return m_libname;
+}
+
 void KX_LibLoadStatus::SetData(void *data)
 {
   m_data = data;
@@ -151,6 +173,7 @@ PyAttributeDef KX_LibLoadStatus::Attributes[] = {
     KX_PYATTRIBUTE_STRING_RO("libraryName", KX_LibLoadStatus, m_libname),
     KX_PYATTRIBUTE_RO_FUNCTION("timeTaken", KX_LibLoadStatus, pyattr_get_timetaken),
     KX_PYATTRIBUTE_BOOL_RO("finished", KX_LibLoadStatus, m_finished),
+    KX_PYATTRIBUTE_BOOL_RO("failed", KX_LibLoadStatus, m_failed),
     KX_PYATTRIBUTE_NULL  // Sentinel
 };
 
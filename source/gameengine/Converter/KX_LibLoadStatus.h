@@ -42,6 +42,8 @@ class KX_LibLoadStatus : public PyObjectPlus {
 
   // The current status of this libload, used by the scene converter.
   bool m_finished;
+  /// True if the library couldn't be read, the libload is then never finished.
+  bool m_failed;
 
 #ifdef WITH_PYTHON
   PyObject *m_finish_cb;
@@ -55,12 +57,15 @@ class KX_LibLoadStatus : public PyObjectPlus {
                    const std::string &path);
 
   void Finish();  // Called when the libload is done
+  /// Called when the library couldn't be read, the finish callback is not run.
+  void Fail();
   void RunFinishCallback();
   void RunProgressCallback();
 
   class KX_BlenderConverter *GetConverter();
   class KX_KetsjiEngine *GetEngine();
   class KX_Scene *GetMergeScene();
+  const std::string &GetLibraryName() const;
 
   void SetData(void *data);
   void *GetData();
@@ -70,6 +75,14 @@ class KX_LibLoadStatus : public PyObjectPlus {
     return m_finished;
   }
 
+  inline bool IsFailed() const
+  {
+    return m_failed;
+  }
+
+  /// Return true if a python object still references the status.
+  bool IsUsedByPython() const;
+
   void SetProgress(float progress);
   float GetProgress();
   void AddProgress(float progress);
@@ -37,6 +37,7 @@ class CBoolValue : public CPropValue {
   virtual double GetNumber();
   virtual int GetValueType();
   bool GetBool();
+  void SetBool(bool inBool);
   virtual void SetValue(CValue *newval);
 
   virtual CValue *Calc(VALUE_OPERATOR op, CValue *val);
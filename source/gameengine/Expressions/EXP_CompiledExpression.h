@@ -0,0 +1,152 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file EXP_CompiledExpression.h
+ *  \ingroup expressions
+ */
+
+#ifndef __EXP_COMPILEDEXPRESSION_H__
+#define __EXP_COMPILEDEXPRESSION_H__
+
+#include "EXP_IntValue.h"
+
+#include <string>
+#include <vector>
+
+class CExpression;
+
+/** Expression compiled into a typed postfix program evaluated without allocating values.
+ * Only the integer, float and boolean values are supported, an expression using other
+ * constants can't be compiled and the evaluation fails when an identifier or an operation
+ * produces an other value (e.g an error), the caller then calculates the expression tree.
+ * The identifiers are resolved by the caller, their values are passed to Evaluate().
+ * A program doesn't depend on the owner of the expression, the replicas of a logic brick
+ * share the program compiled by the first evaluated one. The evaluation only reads the program,
+ * each caller passes its own stack.
+ */
+class CCompiledExpression {
+ public:
+  enum Status {
+    /// No expression was compiled yet.
+    STATUS_EMPTY,
+    STATUS_COMPILED,
+    /// The expression can't be compiled, its tree must be calculated.
+    STATUS_UNSUPPORTED
+  };
+
+  /// Integer, float or boolean value.
+  struct Value {
+    /// VALUE_INT_TYPE, VALUE_FLOAT_TYPE, VALUE_BOOL_TYPE or VALUE_NO_TYPE if unsupported.
+    VALUE_DATA_TYPE m_type;
+    union {
+      cInt m_int;
+      float m_float;
+      bool m_bool;
+    };
+
+    Value();
+
+    /// Copy the value of <value>, return false and set VALUE_NO_TYPE if it's not supported.
+    bool Set(CValue *value);
+    /// Return the value as CValue::GetNumber() does.
+    double GetNumber() const;
+    /// Return true if the values have the same type and the same representation.
+    bool IsIdentical(const Value &other) const;
+    /// Return a new CValue of the same type, nullptr if unsupported.
+    CValue *NewValue() const;
+    /** Set the value of an integer, float or boolean CValue as CValue::SetValue() does without
+     * allocating a new value, return false for the other types.
+     */
+    bool AssignTo(CValue *value) const;
+  };
+
+ private:
+  enum Opcode {
+    /// Push a constant.
+    OP_CONSTANT,
+    /// Push the value of an identifier.
+    OP_IDENTIFIER,
+    /// Replace the top value by the result of an unary operator.
+    OP_UNARY,
+    /// Replace the two top values by the result of a binary operator.
+    OP_BINARY,
+    /// Pop a boolean and jump if it's false.
+    OP_JUMP_IF_FALSE,
+    OP_JUMP
+  };
+
+  struct Instruction {
+    Opcode m_opcode;
+    /// Operator of OP_UNARY and OP_BINARY.
+    VALUE_OPERATOR m_operator;
+    /// Identifier index of OP_IDENTIFIER or target instruction of the jumps.
+    unsigned int m_index;
+    /// Value of OP_CONSTANT.
+    Value m_constant;
+  };
+
+  Status m_status;
+  std::vector<Instruction> m_instructions;
+  std::vector<std::string> m_identifiers;
+
+  void AddInstruction(Opcode opcode, VALUE_OPERATOR op, unsigned int index);
+
+  /// Apply an operator as CValue::Calc() does, return false if the result is not supported.
+  static bool CalcUnary(VALUE_OPERATOR op, Value &value);
+  static bool CalcBinary(VALUE_OPERATOR op, Value &left, const Value &right);
+
+ public:
+  CCompiledExpression();
+  ~CCompiledExpression();
+
+  /** Compile an expression tree with CExpression::Compile().
+   * \param expression The tree to compile, nullptr if the expression couldn't be parsed.
+   * \return False and set STATUS_UNSUPPORTED if the expression can't be compiled.
+   */
+  bool Compile(CExpression *expression);
+  Status GetStatus() const;
+
+  /// Add a constant, return false if its type is not supported.
+  bool AddConstant(CValue *value);
+  /// Add an identifier, all the identifiers of a same name share the same index.
+  void AddIdentifier(const std::string &name);
+  void AddUnaryOperator(VALUE_OPERATOR op);
+  void AddBinaryOperator(VALUE_OPERATOR op);
+  /// Add a jump and return its index to set its target once known.
+  unsigned int AddJump(bool conditional);
+  /// Set the target of a jump to the next added instruction.
+  void SetJumpTarget(unsigned int jump);
+
+  const std::vector<std::string> &GetIdentifiers() const;
+
+  /** Evaluate the program.
+   * \param identifiers The values of the identifiers in the order of GetIdentifiers().
+   * \param stack The evaluation stack of the caller, resized when too small.
+   * \param result The result of the expression.
+   * \return False if a value or the result of an operation is not supported.
+   */
+  bool Evaluate(const std::vector<Value> &identifiers,
+                std::vector<Value> &stack,
+                Value &result) const;
+};
+
+#endif  // __EXP_COMPILEDEXPRESSION_H__
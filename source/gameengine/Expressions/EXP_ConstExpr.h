@@ -31,6 +31,7 @@ class CConstExpr : public CExpression {
   virtual unsigned char GetExpressionID();
   virtual double GetNumber();
   virtual CValue *Calculate();
+  virtual bool Compile(CCompiledExpression &program);
 
  private:
   CValue *m_value;
@@ -21,6 +21,8 @@
 
 #include "EXP_Value.h"
 
+class CCompiledExpression;
+
 class CExpression : public CM_RefCount<CExpression> {
  public:
   enum {
@@ -40,6 +42,8 @@ class CExpression : public CM_RefCount<CExpression> {
 
   virtual CValue *Calculate() = 0;
   virtual unsigned char GetExpressionID() = 0;
+  /// Append the expression to a compiled program, return false if it can't be compiled.
+  virtual bool Compile(CCompiledExpression &program);
 };
 
 #endif  // __EXP_EXPRESSION_H__
@@ -44,6 +44,8 @@ class CIdentifierExpr : public CExpression {
   virtual ~CIdentifierExpr();
 
   virtual CValue *Calculate();
+
+  virtual bool Compile(CCompiledExpression &program);
   virtual unsigned char GetExpressionID();
 };
 
@@ -34,6 +34,7 @@ class CIfExpr : public CExpression {
 
   virtual unsigned char GetExpressionID();
   virtual CValue *Calculate();
+  virtual bool Compile(CCompiledExpression &program);
 };
 
 #endif  // __EXP_IFEXPR_H__
@@ -29,6 +29,7 @@ class COperator1Expr : public CExpression {
 
   virtual unsigned char GetExpressionID();
   virtual CValue *Calculate();
+  virtual bool Compile(CCompiledExpression &program);
 
  private:
   VALUE_OPERATOR m_op;
@@ -30,6 +30,7 @@ class COperator2Expr : public CExpression {
 
   virtual unsigned char GetExpressionID();
   virtual CValue *Calculate();
+  virtual bool Compile(CCompiledExpression &program);
 
  protected:
   CExpression *m_rhs;
@@ -0,0 +1,76 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file EXP_PropertyKey.h
+ *  \ingroup expressions
+ */
+
+#ifndef __EXP_PROPERTYKEY_H__
+#define __EXP_PROPERTYKEY_H__
+
+#include <string>
+
+/** Interned property name, two keys of the same name share the same string
+ * and are compared by address instead of by characters.
+ * The interned names are never freed, they are shared by all the values.
+ */
+class CPropertyKey {
+ private:
+  /// Interned name, nullptr for an invalid key.
+  const std::string *m_name;
+
+  explicit CPropertyKey(const std::string *name);
+
+ public:
+  /// Construct an invalid key.
+  CPropertyKey();
+  /// Construct the key of a name, interning the name if needed.
+  explicit CPropertyKey(const std::string &name);
+
+  /** Return the key of an already interned name without interning it.
+   * Used for lookups: a name never interned can't be the name of a property.
+   * \return An invalid key if the name was never interned.
+   */
+  static CPropertyKey Find(const std::string &name);
+
+  inline bool IsValid() const
+  {
+    return (m_name != nullptr);
+  }
+
+  inline const std::string &GetName() const
+  {
+    return *m_name;
+  }
+
+  inline bool operator==(const CPropertyKey &other) const
+  {
+    return (m_name == other.m_name);
+  }
+
+  inline bool operator!=(const CPropertyKey &other) const
+  {
+    return (m_name != other.m_name);
+  }
+};
+
+#endif  // __EXP_PROPERTYKEY_H__
@@ -24,8 +24,9 @@
 #endif
 
 #include "CM_RefCount.h"
+#include "EXP_PropertyKey.h"
 
-#include <map>  // Array functionality for the property list.
+#include <map>
 #include <vector>
 #include <string>  // std::string class.
 
@@ -126,6 +127,10 @@ class CValue : public PyObjectPlus, public CM_RefCount<CValue> {
   /// needed.
   virtual void SetProperty(const std::string &name, CValue *ioProperty);
   virtual CValue *GetProperty(const std::string &inName);
+  /// Same as SetProperty(name, ioProperty) with a key resolved once by the caller.
+  void SetProperty(const CPropertyKey &key, CValue *ioProperty);
+  /// Get the property of key <key> without comparing strings, returns nullptr if not found.
+  CValue *GetProperty(const CPropertyKey &key);
   /// Get text description of property with name <inName>, returns an empty string if there is no
   /// property named <inName>.
   const std::string GetPropertyText(const std::string &inName);
@@ -133,9 +138,15 @@ class CValue : public PyObjectPlus, public CM_RefCount<CValue> {
   /// Remove the property named <inName>, returns true if the property was succesfully removed,
   /// false if property was not found or could not be removed.
   virtual bool RemoveProperty(const std::string &inName);
+  bool RemoveProperty(const CPropertyKey &key);
   virtual std::vector<std::string> GetPropertyNames();
   /// Clear all properties.
   virtual void ClearProperties();
+  /** Notify that the property of key <key> was set, removed or modified in place, an invalid key
+   * if all the properties were removed. Called after any change of the properties, the callers
+   * modifying a property value in place with SetValue() must call it too.
+   */
+  virtual void PropertyModified(const CPropertyKey &key);
 
   /// Get property number <inIndex>.
   virtual CValue *GetProperty(int inIndex);
@@ -175,8 +186,11 @@ class CValue : public PyObjectPlus, public CM_RefCount<CValue> {
   virtual void DestructFromPython();
 
  private:
-  /// Properties for user/game etc.
-  std::map<std::string, CValue *> *m_pNamedPropertyArray;
+  /// Return the index of the property of key <key> or -1.
+  int FindPropertyIndex(const CPropertyKey &key) const;
+
+  /// Properties for user/game etc, sorted by name.
+  std::vector<std::pair<CPropertyKey, CValue *>> m_properties;
   bool m_error;
 };
 
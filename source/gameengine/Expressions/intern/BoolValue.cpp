@@ -37,6 +37,11 @@ CBoolValue::CBoolValue(bool innie, const std::string &name) : m_bool(innie)
   SetName(name);
 }
 
+void CBoolValue::SetBool(bool inBool)
+{
+  m_bool = inBool;
+}
+
 void CBoolValue::SetValue(CValue *newval)
 {
   m_bool = (newval->GetNumber() != 0);
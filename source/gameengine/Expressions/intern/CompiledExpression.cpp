@@ -0,0 +1,483 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CompiledExpression.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_CompiledExpression.h"
+#include "EXP_Expression.h"
+#include "EXP_BoolValue.h"
+#include "EXP_FloatValue.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+CCompiledExpression::Value::Value() : m_type(VALUE_NO_TYPE), m_int(0)
+{
+}
+
+bool CCompiledExpression::Value::Set(CValue *value)
+{
+  switch (value->GetValueType()) {
+    case VALUE_INT_TYPE: {
+      m_type = VALUE_INT_TYPE;
+      m_int = static_cast<CIntValue *>(value)->GetInt();
+      return true;
+    }
+    case VALUE_FLOAT_TYPE: {
+      m_type = VALUE_FLOAT_TYPE;
+      m_float = static_cast<CFloatValue *>(value)->GetFloat();
+      return true;
+    }
+    case VALUE_BOOL_TYPE: {
+      m_type = VALUE_BOOL_TYPE;
+      m_bool = static_cast<CBoolValue *>(value)->GetBool();
+      return true;
+    }
+    default: {
+      m_type = VALUE_NO_TYPE;
+      return false;
+    }
+  }
+}
+
+double CCompiledExpression::Value::GetNumber() const
+{
+  switch (m_type) {
+    case VALUE_INT_TYPE: {
+      return (double)m_int;
+    }
+    case VALUE_FLOAT_TYPE: {
+      return (double)m_float;
+    }
+    case VALUE_BOOL_TYPE: {
+      return m_bool ? 1.0 : 0.0;
+    }
+    default: {
+      return -1.0;
+    }
+  }
+}
+
+bool CCompiledExpression::Value::IsIdentical(const Value &other) const
+{
+  if (m_type != other.m_type) {
+    return false;
+  }
+
+  switch (m_type) {
+    case VALUE_INT_TYPE: {
+      return (m_int == other.m_int);
+    }
+    case VALUE_FLOAT_TYPE: {
+      // Compare the bits to distinguish the signed zeros and to match the NaN.
+      return (memcmp(&m_float, &other.m_float, sizeof(float)) == 0);
+    }
+    case VALUE_BOOL_TYPE: {
+      return (m_bool == other.m_bool);
+    }
+    default: {
+      return true;
+    }
+  }
+}
+
+CValue *CCompiledExpression::Value::NewValue() const
+{
+  switch (m_type) {
+    case VALUE_INT_TYPE: {
+      return new CIntValue(m_int);
+    }
+    case VALUE_FLOAT_TYPE: {
+      return new CFloatValue(m_float);
+    }
+    case VALUE_BOOL_TYPE: {
+      return new CBoolValue(m_bool);
+    }
+    default: {
+      return nullptr;
+    }
+  }
+}
+
+bool CCompiledExpression::Value::AssignTo(CValue *value) const
+{
+  switch (value->GetValueType()) {
+    case VALUE_INT_TYPE: {
+      static_cast<CIntValue *>(value)->SetInt((cInt)GetNumber());
+      return true;
+    }
+    case VALUE_FLOAT_TYPE: {
+      static_cast<CFloatValue *>(value)->SetFloat((float)GetNumber());
+      return true;
+    }
+    case VALUE_BOOL_TYPE: {
+      static_cast<CBoolValue *>(value)->SetBool(GetNumber() != 0.0);
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+CCompiledExpression::CCompiledExpression() : m_status(STATUS_EMPTY)
+{
+}
+
+CCompiledExpression::~CCompiledExpression()
+{
+}
+
+bool CCompiledExpression::Compile(CExpression *expression)
+{
+  if (expression && expression->Compile(*this)) {
+    m_status = STATUS_COMPILED;
+    return true;
+  }
+
+  m_status = STATUS_UNSUPPORTED;
+  m_instructions.clear();
+  m_identifiers.clear();
+  return false;
+}
+
+CCompiledExpression::Status CCompiledExpression::GetStatus() const
+{
+  return m_status;
+}
+
+void CCompiledExpression::AddInstruction(Opcode opcode, VALUE_OPERATOR op, unsigned int index)
+{
+  Instruction instruction;
+  instruction.m_opcode = opcode;
+  instruction.m_operator = op;
+  instruction.m_index = index;
+  m_instructions.push_back(instruction);
+}
+
+bool CCompiledExpression::AddConstant(CValue *value)
+{
+  AddInstruction(OP_CONSTANT, VALUE_NO_OPERATOR, 0);
+  return m_instructions.back().m_constant.Set(value);
+}
+
+void CCompiledExpression::AddIdentifier(const std::string &name)
+{
+  const std::vector<std::string>::const_iterator it = std::find(
+      m_identifiers.begin(), m_identifiers.end(), name);
+  const unsigned int index = it - m_identifiers.begin();
+  if (it == m_identifiers.end()) {
+    m_identifiers.push_back(name);
+  }
+
+  AddInstruction(OP_IDENTIFIER, VALUE_NO_OPERATOR, index);
+}
+
+void CCompiledExpression::AddUnaryOperator(VALUE_OPERATOR op)
+{
+  AddInstruction(OP_UNARY, op, 0);
+}
+
+void CCompiledExpression::AddBinaryOperator(VALUE_OPERATOR op)
+{
+  AddInstruction(OP_BINARY, op, 0);
+}
+
+unsigned int CCompiledExpression::AddJump(bool conditional)
+{
+  AddInstruction(conditional ? OP_JUMP_IF_FALSE : OP_JUMP, VALUE_NO_OPERATOR, 0);
+  return m_instructions.size() - 1;
+}
+
+void CCompiledExpression::SetJumpTarget(unsigned int jump)
+{
+  m_instructions[jump].m_index = m_instructions.size();
+}
+
+const std::vector<std::string> &CCompiledExpression::GetIdentifiers() const
+{
+  return m_identifiers;
+}
+
+bool CCompiledExpression::CalcUnary(VALUE_OPERATOR op, Value &value)
+{
+  switch (value.m_type) {
+    case VALUE_INT_TYPE: {
+      switch (op) {
+        case VALUE_NEG_OPERATOR: {
+          value.m_int = -value.m_int;
+          return true;
+        }
+        case VALUE_POS_OPERATOR: {
+          return true;
+        }
+        case VALUE_NOT_OPERATOR: {
+          value.m_type = VALUE_BOOL_TYPE;
+          value.m_bool = (value.m_int == 0);
+          return true;
+        }
+        default: {
+          return false;
+        }
+      }
+    }
+    case VALUE_FLOAT_TYPE: {
+      switch (op) {
+        case VALUE_NEG_OPERATOR: {
+          value.m_float = -value.m_float;
+          return true;
+        }
+        case VALUE_POS_OPERATOR: {
+          return true;
+        }
+        case VALUE_NOT_OPERATOR: {
+          value.m_type = VALUE_BOOL_TYPE;
+          value.m_bool = (value.m_float == 0.0f);
+          return true;
+        }
+        default: {
+          return false;
+        }
+      }
+    }
+    case VALUE_BOOL_TYPE: {
+      if (op == VALUE_NOT_OPERATOR) {
+        value.m_bool = !value.m_bool;
+        return true;
+      }
+      return false;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+/// Apply a comparison operator, return false if the operator is not a comparison.
+template<class Type>
+static bool calc_comparison(VALUE_OPERATOR op, Type left, Type right, bool &result)
+{
+  switch (op) {
+    case VALUE_EQL_OPERATOR: {
+      result = (left == right);
+      return true;
+    }
+    case VALUE_NEQ_OPERATOR: {
+      result = (left != right);
+      return true;
+    }
+    case VALUE_GRE_OPERATOR: {
+      result = (left > right);
+      return true;
+    }
+    case VALUE_LES_OPERATOR: {
+      result = (left < right);
+      return true;
+    }
+    case VALUE_GEQ_OPERATOR: {
+      result = (left >= right);
+      return true;
+    }
+    case VALUE_LEQ_OPERATOR: {
+      result = (left <= right);
+      return true;
+    }
+    default: {
+      return false;
+    }
+  }
+}
+
+bool CCompiledExpression::CalcBinary(VALUE_OPERATOR op, Value &left, const Value &right)
+{
+  if (left.m_type == VALUE_INT_TYPE && right.m_type == VALUE_INT_TYPE) {
+    const cInt a = left.m_int;
+    const cInt b = right.m_int;
+    switch (op) {
+      case VALUE_MOD_OPERATOR: {
+        if (b == 0) {
+          return false;
+        }
+        left.m_int = a % b;
+        return true;
+      }
+      case VALUE_ADD_OPERATOR: {
+        left.m_int = a + b;
+        return true;
+      }
+      case VALUE_SUB_OPERATOR: {
+        left.m_int = a - b;
+        return true;
+      }
+      case VALUE_MUL_OPERATOR: {
+        left.m_int = a * b;
+        return true;
+      }
+      case VALUE_DIV_OPERATOR: {
+        // The expression tree returns the division by zero error.
+        if (b == 0) {
+          return false;
+        }
+        left.m_int = a / b;
+        return true;
+      }
+      default: {
+        left.m_type = VALUE_BOOL_TYPE;
+        return calc_comparison(op, a, b, left.m_bool);
+      }
+    }
+  }
+
+  if (left.m_type == VALUE_BOOL_TYPE || right.m_type == VALUE_BOOL_TYPE) {
+    if (left.m_type != right.m_type) {
+      return false;
+    }
+
+    const bool a = left.m_bool;
+    const bool b = right.m_bool;
+    switch (op) {
+      case VALUE_AND_OPERATOR: {
+        left.m_bool = a && b;
+        return true;
+      }
+      case VALUE_OR_OPERATOR: {
+        left.m_bool = a || b;
+        return true;
+      }
+      case VALUE_EQL_OPERATOR: {
+        left.m_bool = (a == b);
+        return true;
+      }
+      case VALUE_NEQ_OPERATOR: {
+        left.m_bool = (a != b);
+        return true;
+      }
+      default: {
+        return false;
+      }
+    }
+  }
+
+  // An integer and a float or two floats, computed in float precision as CFloatValue.
+  const float a = (left.m_type == VALUE_INT_TYPE) ? (float)left.m_int : left.m_float;
+  const float b = (right.m_type == VALUE_INT_TYPE) ? (float)right.m_int : right.m_float;
+  left.m_type = VALUE_FLOAT_TYPE;
+  switch (op) {
+    case VALUE_MOD_OPERATOR: {
+      left.m_float = std::fmod(a, b);
+      return true;
+    }
+    case VALUE_ADD_OPERATOR: {
+      left.m_float = a + b;
+      return true;
+    }
+    case VALUE_SUB_OPERATOR: {
+      left.m_float = a - b;
+      return true;
+    }
+    case VALUE_MUL_OPERATOR: {
+      left.m_float = a * b;
+      return true;
+    }
+    case VALUE_DIV_OPERATOR: {
+      if (b == 0.0f) {
+        return false;
+      }
+      left.m_float = a / b;
+      return true;
+    }
+    default: {
+      left.m_type = VALUE_BOOL_TYPE;
+      return calc_comparison(op, a, b, left.m_bool);
+    }
+  }
+}
+
+bool CCompiledExpression::Evaluate(const std::vector<Value> &identifiers,
+                                   std::vector<Value> &stack,
+                                   Value &result) const
+{
+  // The stack is never deeper than the number of instructions.
+  if (stack.size() < m_instructions.size()) {
+    stack.resize(m_instructions.size());
+  }
+
+  unsigned int size = 0;
+  unsigned int index = 0;
+  const unsigned int numInstructions = m_instructions.size();
+
+  while (index < numInstructions) {
+    const Instruction &instruction = m_instructions[index++];
+    switch (instruction.m_opcode) {
+      case OP_CONSTANT: {
+        stack[size++] = instruction.m_constant;
+        break;
+      }
+      case OP_IDENTIFIER: {
+        const Value &value = identifiers[instruction.m_index];
+        if (value.m_type == VALUE_NO_TYPE) {
+          return false;
+        }
+        stack[size++] = value;
+        break;
+      }
+      case OP_UNARY: {
+        if (!CalcUnary(instruction.m_operator, stack[size - 1])) {
+          return false;
+        }
+        break;
+      }
+      case OP_BINARY: {
+        --size;
+        if (!CalcBinary(instruction.m_operator, stack[size - 1], stack[size])) {
+          return false;
+        }
+        break;
+      }
+      case OP_JUMP_IF_FALSE: {
+        // The guard of a condition must be a boolean.
+        const Value &guard = stack[--size];
+        if (guard.m_type != VALUE_BOOL_TYPE) {
+          return false;
+        }
+        if (!guard.m_bool) {
+          index = instruction.m_index;
+        }
+        break;
+      }
+      case OP_JUMP: {
+        index = instruction.m_index;
+        break;
+      }
+    }
+  }
+
+  if (size != 1) {
+    return false;
+  }
+
+  result = stack[0];
+  return true;
+}
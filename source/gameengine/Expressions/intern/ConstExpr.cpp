@@ -18,6 +18,7 @@
 
 #include "EXP_Value.h"
 #include "EXP_ConstExpr.h"
+#include "EXP_CompiledExpression.h"
 
 CConstExpr::CConstExpr()
 {
@@ -49,3 +50,8 @@ double CConstExpr::GetNumber()
 {
   return -1.0;
 }
+
+bool CConstExpr::Compile(CCompiledExpression &program)
+{
+  return program.AddConstant(m_value);
+}
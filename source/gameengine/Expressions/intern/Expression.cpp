@@ -18,6 +18,8 @@
 #include "EXP_Expression.h"
 #include "EXP_ErrorValue.h"
 
+#include "BLI_utildefines.h"
+
 CExpression::CExpression()
 {
 }
@@ -25,3 +27,8 @@ CExpression::CExpression()
 CExpression::~CExpression()
 {
 }
+
+bool CExpression::Compile(CCompiledExpression &UNUSED(program))
+{
+  return false;
+}
@@ -30,6 +30,7 @@
  */
 
 #include "EXP_IdentifierExpr.h"
+#include "EXP_CompiledExpression.h"
 
 CIdentifierExpr::CIdentifierExpr(const std::string &identifier, CValue *id_context)
     : m_identifier(identifier)
@@ -63,3 +64,10 @@ unsigned char CIdentifierExpr::GetExpressionID()
 {
   return CIDENTIFIEREXPRESSIONID;
 }
+
+bool CIdentifierExpr::Compile(CCompiledExpression &program)
+{
+  // The identifiers are resolved by the owner of the program.
+  program.AddIdentifier(m_identifier);
+  return true;
+}
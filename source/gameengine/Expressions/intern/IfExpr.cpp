@@ -19,6 +19,7 @@
 #include "EXP_EmptyValue.h"
 #include "EXP_ErrorValue.h"
 #include "EXP_BoolValue.h"
+#include "EXP_CompiledExpression.h"
 
 CIfExpr::CIfExpr()
 {
@@ -65,3 +66,24 @@ unsigned char CIfExpr::GetExpressionID()
 {
   return CIFEXPRESSIONID;
 }
+
+bool CIfExpr::Compile(CCompiledExpression &program)
+{
+  if (!m_guard->Compile(program)) {
+    return false;
+  }
+
+  const unsigned int elseJump = program.AddJump(true);
+  if (!m_e1->Compile(program)) {
+    return false;
+  }
+
+  const unsigned int endJump = program.AddJump(false);
+  program.SetJumpTarget(elseJump);
+  if (!m_e2->Compile(program)) {
+    return false;
+  }
+
+  program.SetJumpTarget(endJump);
+  return true;
+}
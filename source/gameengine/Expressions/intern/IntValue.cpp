@@ -280,6 +280,11 @@ CValue *CIntValue::GetReplica()
   return replica;
 }
 
+void CIntValue::SetInt(cInt innie)
+{
+  m_int = innie;
+}
+
 void CIntValue::SetValue(CValue *newval)
 {
   m_int = (cInt)newval->GetNumber();
@@ -16,6 +16,7 @@
  */
 
 #include "EXP_Operator2Expr.h"
+#include "EXP_CompiledExpression.h"
 #include "EXP_StringValue.h"
 
 COperator2Expr::COperator2Expr(VALUE_OPERATOR op, CExpression *lhs, CExpression *rhs)
@@ -55,3 +56,13 @@ CValue *COperator2Expr::Calculate()
 
   return calculate;
 }
+
+bool COperator2Expr::Compile(CCompiledExpression &program)
+{
+  if (!m_lhs->Compile(program) || !m_rhs->Compile(program)) {
+    return false;
+  }
+
+  program.AddBinaryOperator(m_op);
+  return true;
+}
@@ -0,0 +1,88 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file PropertyKey.cpp
+ *  \ingroup expressions
+ */
+
+#include "EXP_PropertyKey.h"
+
+#include "BLI_threads.h"
+
+#include <unordered_set>
+
+namespace {
+
+/// Table of the interned names, the strings of an unordered set keep their address.
+struct PropertyNameTable {
+  std::unordered_set<std::string> m_names;
+  /// Keys can be created from the logic of scenes updated in parallel.
+  ThreadRWMutex m_mutex;
+
+  PropertyNameTable()
+  {
+    BLI_rw_mutex_init(&m_mutex);
+  }
+
+  ~PropertyNameTable()
+  {
+    BLI_rw_mutex_end(&m_mutex);
+  }
+};
+
+}  // namespace
+
+/// Construct the table on first use to allow static keys in other translation units.
+static PropertyNameTable &get_name_table()
+{
+  static PropertyNameTable table;
+  return table;
+}
+
+CPropertyKey::CPropertyKey(const std::string *name) : m_name(name)
+{
+}
+
+CPropertyKey::CPropertyKey() : m_name(nullptr)
+{
+}
+
+CPropertyKey::CPropertyKey(const std::string &name)
+{
+  PropertyNameTable &table = get_name_table();
+
+  BLI_rw_mutex_lock(&table.m_mutex, THREAD_LOCK_WRITE);
+  m_name = &*table.m_names.insert(name).first;
+  BLI_rw_mutex_unlock(&table.m_mutex);
+}
+
+CPropertyKey CPropertyKey::Find(const std::string &name)
+{
+  PropertyNameTable &table = get_name_table();
+
+  BLI_rw_mutex_lock(&table.m_mutex, THREAD_LOCK_READ);
+  std::unordered_set<std::string>::const_iterator it = table.m_names.find(name);
+  const std::string *interned = (it != table.m_names.end()) ? &*it : nullptr;
+  BLI_rw_mutex_unlock(&table.m_mutex);
+
+  return CPropertyKey(interned);
+}
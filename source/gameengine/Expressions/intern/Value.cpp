@@ -25,6 +25,8 @@
 #include "EXP_ErrorValue.h"
 #include "EXP_ListValue.h"
 
+#include "BLI_utildefines.h"
+
 #ifdef WITH_PYTHON
 
 PyTypeObject CValue::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "CValue",
@@ -70,7 +72,7 @@ PyMethodDef CValue::Methods[] = {
 };
 #endif  // WITH_PYTHON
 
-CValue::CValue() : m_pNamedPropertyArray(nullptr), m_error(false)
+CValue::CValue() : m_error(false)
 {
 }
 
@@ -146,6 +148,11 @@ std::string CValue::op2str(VALUE_OPERATOR op)
 /// Set property <ioProperty>, overwrites and releases a previous property with the same name if
 /// needed.
 void CValue::SetProperty(const std::string &name, CValue *ioProperty)
+{
+  SetProperty(CPropertyKey(name), ioProperty);
+}
+
+void CValue::SetProperty(const CPropertyKey &key, CValue *ioProperty)
 {
   // Check if somebody is setting an empty property.
   if (ioProperty == nullptr) {
@@ -154,32 +161,49 @@ void CValue::SetProperty(const std::string &name, CValue *ioProperty)
   }
 
   // Try to replace property (if so -> exit as soon as we replaced it).
-  if (m_pNamedPropertyArray) {
-    CValue *oldval = (*m_pNamedPropertyArray)[name];
-    if (oldval) {
-      oldval->Release();
-    }
+  const int index = FindPropertyIndex(key);
+  if (index != -1) {
+    CValue *oldval = m_properties[index].second;
+    m_properties[index].second = ioProperty->AddRef();
+    oldval->Release();
+    PropertyModified(key);
+    return;
   }
-  // Make sure we have a property array.
-  else {
-    m_pNamedPropertyArray = new std::map<std::string, CValue *>;
+
+  // Insert the property keeping the names sorted.
+  const std::string &name = key.GetName();
+  std::vector<std::pair<CPropertyKey, CValue *>>::iterator it = m_properties.begin();
+  while (it != m_properties.end() && it->first.GetName() < name) {
+    ++it;
   }
+  m_properties.emplace(it, key, ioProperty->AddRef());
+  PropertyModified(key);
+}
 
-  // Add property at end of array.
-  (*m_pNamedPropertyArray)[name] = ioProperty->AddRef();
+int CValue::FindPropertyIndex(const CPropertyKey &key) const
+{
+  for (unsigned int i = 0, size = m_properties.size(); i < size; ++i) {
+    if (m_properties[i].first == key) {
+      return i;
+    }
+  }
+  return -1;
 }
 
 /// Get pointer to a property with name <inName>, returns nullptr if there is no property named
 /// <inName>.
 CValue *CValue::GetProperty(const std::string &inName)
 {
-  if (m_pNamedPropertyArray) {
-    std::map<std::string, CValue *>::iterator it = m_pNamedPropertyArray->find(inName);
-    if (it != m_pNamedPropertyArray->end()) {
-      return (*it).second;
-    }
+  if (m_properties.empty()) {
+    return nullptr;
   }
-  return nullptr;
+  return GetProperty(CPropertyKey::Find(inName));
+}
+
+CValue *CValue::GetProperty(const CPropertyKey &key)
+{
+  const int index = FindPropertyIndex(key);
+  return (index != -1) ? m_properties[index].second : nullptr;
 }
 
 /// Get text description of property with name <inName>, returns an empty string if there is no
@@ -206,35 +230,38 @@ float CValue::GetPropertyNumber(const std::string &inName, float defnumber)
   }
 }
 
-/// Remove the property named <inName>, returns true if the property was succesfully removed, false
-/// if property was not found or could not be removed.
+/// Remove the property named <inName>, returns true if the property was succesfully removed,
+/// false if property was not found or could not be removed.
 bool CValue::RemoveProperty(const std::string &inName)
 {
   // Check if there are properties at all which can be removed.
-  if (m_pNamedPropertyArray) {
-    std::map<std::string, CValue *>::iterator it = m_pNamedPropertyArray->find(inName);
-    if (it != m_pNamedPropertyArray->end()) {
-      ((*it).second)->Release();
-      m_pNamedPropertyArray->erase(it);
-      return true;
-    }
+  if (m_properties.empty()) {
+    return false;
+  }
+  return RemoveProperty(CPropertyKey::Find(inName));
+}
+
+bool CValue::RemoveProperty(const CPropertyKey &key)
+{
+  const int index = FindPropertyIndex(key);
+  if (index == -1) {
+    return false;
   }
 
-  return false;
+  m_properties[index].second->Release();
+  m_properties.erase(m_properties.begin() + index);
+  PropertyModified(key);
+  return true;
 }
 
 /// Get Property Names.
 std::vector<std::string> CValue::GetPropertyNames()
 {
   std::vector<std::string> result;
-  if (!m_pNamedPropertyArray) {
-    return result;
-  }
-  result.reserve(m_pNamedPropertyArray->size());
+  result.reserve(m_properties.size());
 
-  std::map<std::string, CValue *>::iterator it;
-  for (it = m_pNamedPropertyArray->begin(); (it != m_pNamedPropertyArray->end()); it++) {
-    result.push_back((*it).first);
+  for (const std::pair<CPropertyKey, CValue *> &pair : m_properties) {
+    result.push_back(pair.first.GetName());
   }
   return result;
 }
@@ -242,50 +269,32 @@ std::vector<std::string> CValue::GetPropertyNames()
 /// Clear all properties.
 void CValue::ClearProperties()
 {
-  // Check if we have any properties.
-  if (m_pNamedPropertyArray == nullptr) {
-    return;
-  }
-
   // Remove all properties.
-  std::map<std::string, CValue *>::iterator it;
-  for (it = m_pNamedPropertyArray->begin(); (it != m_pNamedPropertyArray->end()); it++) {
-    CValue *tmpval = (*it).second;
-    tmpval->Release();
+  for (std::pair<CPropertyKey, CValue *> &pair : m_properties) {
+    pair.second->Release();
   }
 
-  // Delete property array.
-  delete m_pNamedPropertyArray;
-  m_pNamedPropertyArray = nullptr;
+  m_properties.clear();
+  PropertyModified(CPropertyKey());
+}
+
+void CValue::PropertyModified(const CPropertyKey &UNUSED(key))
+{
 }
 
 /// Get property number <inIndex>.
 CValue *CValue::GetProperty(int inIndex)
 {
-  int count = 0;
-  CValue *result = nullptr;
-
-  if (m_pNamedPropertyArray) {
-    std::map<std::string, CValue *>::iterator it;
-    for (it = m_pNamedPropertyArray->begin(); (it != m_pNamedPropertyArray->end()); it++) {
-      if (count++ == inIndex) {
-        result = (*it).second;
-        break;
-      }
-    }
+  if (inIndex < 0 || inIndex >= (int)m_properties.size()) {
+    return nullptr;
   }
-  return result;
+  return m_properties[inIndex].second;
 }
 
 /// Get the amount of properties assiocated with this value.
 int CValue::GetPropertyCount()
 {
-  if (m_pNamedPropertyArray) {
-    return m_pNamedPropertyArray->size();
-  }
-  else {
-    return 0;
-  }
+  return m_properties.size();
 }
 
 void CValue::DestructFromPython()
@@ -301,16 +310,9 @@ void CValue::ProcessReplica()
 {
   PyObjectPlus::ProcessReplica();
 
-  // Copy all props.
-  if (m_pNamedPropertyArray) {
-    std::map<std::string, CValue *> *pOldArray = m_pNamedPropertyArray;
-    m_pNamedPropertyArray = nullptr;
-    std::map<std::string, CValue *>::iterator it;
-    for (it = pOldArray->begin(); (it != pOldArray->end()); it++) {
-      CValue *val = (*it).second->GetReplica();
-      SetProperty((*it).first, val);
-      val->Release();
-    }
+  // Copy all props, the keys and the order are kept.
+  for (std::pair<CPropertyKey, CValue *> &pair : m_properties) {
+    pair.second = pair.second->GetReplica();
   }
 }
 
@@ -410,20 +412,14 @@ CValue *CValue::ConvertPythonToValue(PyObject *pyobj,
 
 PyObject *CValue::ConvertKeysToPython(void)
 {
-  if (m_pNamedPropertyArray) {
-    PyObject *pylist = PyList_New(m_pNamedPropertyArray->size());
-    Py_ssize_t i = 0;
+  PyObject *pylist = PyList_New(m_properties.size());
+  Py_ssize_t i = 0;
 
-    std::map<std::string, CValue *>::iterator it;
-    for (it = m_pNamedPropertyArray->begin(); (it != m_pNamedPropertyArray->end()); it++) {
-      PyList_SET_ITEM(pylist, i++, PyUnicode_FromStdString((*it).first));
-    }
-
-    return pylist;
-  }
-  else {
-    return PyList_New(0);
+  for (const std::pair<CPropertyKey, CValue *> &pair : m_properties) {
+    PyList_SET_ITEM(pylist, i++, PyUnicode_FromStdString(pair.first.GetName()));
   }
+
+  return pylist;
 }
 
 #endif  // WITH_PYTHON
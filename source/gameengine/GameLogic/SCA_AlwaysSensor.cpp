@@ -42,6 +42,63 @@
 #include "SCA_LogicManager.h"
 #include "SCA_EventManager.h"
 
+/* ------------------------------------------------------------------------- */
+/* Batch functions                                                           */
+/* ------------------------------------------------------------------------- */
+
+SCA_AlwaysSensorBatch::SCA_AlwaysSensorBatch()
+{
+}
+
+SCA_AlwaysSensorBatch::~SCA_AlwaysSensorBatch()
+{
+}
+
+void SCA_AlwaysSensorBatch::AppendState(SCA_ISensor *sensor,
+                                        const SCA_SensorBatch *other,
+                                        unsigned int index)
+{
+  const SCA_AlwaysSensorBatch *batch = static_cast<const SCA_AlwaysSensorBatch *>(other);
+  m_alwaysResults.push_back(batch ? batch->m_alwaysResults[index] : true);
+}
+
+void SCA_AlwaysSensorBatch::MoveState(unsigned int from, unsigned int to)
+{
+  m_alwaysResults[to] = m_alwaysResults[from];
+}
+
+void SCA_AlwaysSensorBatch::PopState()
+{
+  m_alwaysResults.pop_back();
+}
+
+void SCA_AlwaysSensorBatch::Evaluate()
+{
+  for (unsigned int i = 0, size = m_sensors.size(); i < size; ++i) {
+    if (m_states[i] == STATE_EVALUATED) {
+      m_results[i] = EvaluateSensor(i);
+    }
+  }
+}
+
+void SCA_AlwaysSensorBatch::Init(unsigned int index)
+{
+  m_alwaysResults[index] = true;
+}
+
+unsigned char SCA_AlwaysSensorBatch::EvaluateSensor(unsigned int index)
+{
+  // Only the pulses are sent after the first evaluation.
+  const unsigned char result = m_alwaysResults[index] ? RESULT_CHANGED : 0;
+  m_alwaysResults[index] = false;
+  return result | RESULT_POSITIVE | RESULT_IDLE;
+}
+
+bool SCA_AlwaysSensorBatch::IsIdle(unsigned int index) const
+{
+  return !m_alwaysResults[index];
+}
+
 /* ------------------------------------------------------------------------- */
 /* Native functions                                                          */
 /* ------------------------------------------------------------------------- */
@@ -50,12 +107,18 @@ SCA_AlwaysSensor::SCA_AlwaysSensor(class SCA_EventManager *eventmgr, SCA_IObject
     : SCA_ISensor(gameobj, eventmgr)
 {
   // SetDrawColor(255,0,0);
+  ResetBatch();
   Init();
 }
 
+SCA_AlwaysSensorBatch *SCA_AlwaysSensor::GetAlwaysBatch() const
+{
+  return static_cast<SCA_AlwaysSensorBatch *>(m_batch.get());
+}
+
 void SCA_AlwaysSensor::Init()
 {
-  m_alwaysresult = true;
+  GetAlwaysBatch()->Init(m_batchIndex);
 }
 
 SCA_AlwaysSensor::~SCA_AlwaysSensor()
@@ -79,15 +142,17 @@ bool SCA_AlwaysSensor::IsPositiveTrigger()
 
 bool SCA_AlwaysSensor::Evaluate()
 {
-  /* Nice! :) */
-  // return true;
-  /* even nicer ;) */
-  // return false;
+  return (GetAlwaysBatch()->EvaluateSensor(m_batchIndex) & SCA_SensorBatch::RESULT_CHANGED);
+}
 
-  /* nicest ! */
-  bool result = m_alwaysresult;
-  m_alwaysresult = false;
-  return result;
+bool SCA_AlwaysSensor::IsIdle()
+{
+  return GetAlwaysBatch()->IsIdle(m_batchIndex);
+}
+
+SCA_SensorBatch *SCA_AlwaysSensor::NewBatch()
+{
+  return new SCA_AlwaysSensorBatch();
 }
 
 #ifdef WITH_PYTHON
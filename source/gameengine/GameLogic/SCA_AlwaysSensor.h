@@ -35,17 +35,46 @@
 #ifndef __SCA_ALWAYSSENSOR_H__
 #define __SCA_ALWAYSSENSOR_H__
 #include "SCA_ISensor.h"
+#include "SCA_SensorBatch.h"
 
-class SCA_AlwaysSensor : public SCA_ISensor {
-  Py_Header bool m_alwaysresult;
+/// Always sensors positive at their first evaluation after a reset.
+class SCA_AlwaysSensorBatch : public SCA_SensorBatch {
+ private:
+  /// True if the sensor wasn't evaluated since its reset.
+  std::vector<unsigned char> m_alwaysResults;
+
+ protected:
+  virtual void AppendState(SCA_ISensor *sensor,
+                           const SCA_SensorBatch *other,
+                           unsigned int index);
+  virtual void MoveState(unsigned int from, unsigned int to);
+  virtual void PopState();
+  virtual void Evaluate();
 
  public:
-  SCA_AlwaysSensor(class SCA_EventManager *eventmgr, SCA_IObject *gameobj);
+  SCA_AlwaysSensorBatch();
+  virtual ~SCA_AlwaysSensorBatch();
+
+  void Init(unsigned int index);
+  /// Evaluate a sensor and return the flags of SCA_SensorBatch::Result.
+  unsigned char EvaluateSensor(unsigned int index);
+  bool IsIdle(unsigned int index) const;
+};
+
+class SCA_AlwaysSensor : public SCA_ISensor {
+  Py_Header
+
+      public : SCA_AlwaysSensor(class SCA_EventManager *eventmgr, SCA_IObject *gameobj);
   virtual ~SCA_AlwaysSensor();
   virtual CValue *GetReplica();
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
   virtual void Init();
+  virtual bool IsIdle();
+  virtual SCA_SensorBatch *NewBatch();
+
+ private:
+  SCA_AlwaysSensorBatch *GetAlwaysBatch() const;
 };
 
 #endif /* __SCA_ALWAYSSENSOR_H__ */
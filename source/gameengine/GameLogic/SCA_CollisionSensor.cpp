@@ -100,6 +100,12 @@ bool SCA_CollisionSensor::Evaluate()
   return result;
 }
 
+bool SCA_CollisionSensor::IsIdle()
+{
+  // The end of the collisions must still be evaluated.
+  return (!m_bTriggered && !m_bLastTriggered);
+}
+
 SCA_CollisionSensor::SCA_CollisionSensor(SCA_EventManager *eventmgr,
                                          KX_GameObject *gameobj,
                                          bool bFindMaterial,
@@ -171,7 +177,11 @@ void SCA_CollisionSensor::RegisterSumo(KX_CollisionEventManager *collisionman)
     if (collisionman->GetPhysicsEnvironment()->RequestCollisionCallback(m_physCtrl)) {
       KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
           m_physCtrl->GetNewClientInfo());
-      if (client_info->isSensor()) {
+      // Near and Radar sensors are only queried after the physics step.
+      if (client_info->m_type == KX_ClientObjectInfo::SENSOR) {
+        collisionman->GetPhysicsEnvironment()->AddProximitySensor(m_physCtrl);
+      }
+      else if (client_info->isSensor()) {
         collisionman->GetPhysicsEnvironment()->AddSensor(m_physCtrl);
       }
     }
@@ -184,7 +194,10 @@ void SCA_CollisionSensor::UnregisterSumo(KX_CollisionEventManager *collisionman)
       // no more sensor on the controller, can remove it if it is a sensor object
       KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
           m_physCtrl->GetNewClientInfo());
-      if (client_info->isSensor()) {
+      if (client_info->m_type == KX_ClientObjectInfo::SENSOR) {
+        collisionman->GetPhysicsEnvironment()->RemoveProximitySensor(m_physCtrl);
+      }
+      else if (client_info->isSensor()) {
         collisionman->GetPhysicsEnvironment()->RemoveSensor(m_physCtrl);
       }
     }
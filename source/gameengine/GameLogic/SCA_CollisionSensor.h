@@ -88,6 +88,8 @@ class SCA_CollisionSensor : public SCA_ISensor {
   virtual void SynchronizeTransform();
   virtual bool Evaluate();
   virtual void Init();
+  /// The sensor is woken by the collision event manager when a collision is handled.
+  virtual bool IsIdle();
   virtual void ReParent(SCA_IObject *parent);
 
   virtual void RegisterSumo(KX_CollisionEventManager *collisionman);
@@ -45,79 +45,191 @@
 #include "SCA_EventManager.h"
 
 /* ------------------------------------------------------------------------- */
-/* Native functions                                                          */
+/* Batch functions                                                           */
 /* ------------------------------------------------------------------------- */
 
-SCA_DelaySensor::SCA_DelaySensor(
-    class SCA_EventManager *eventmgr, SCA_IObject *gameobj, int delay, int duration, bool repeat)
-    : SCA_ISensor(gameobj, eventmgr), m_repeat(repeat), m_delay(delay), m_duration(duration)
+SCA_DelaySensorBatch::SCA_DelaySensorBatch(int delay, int duration, bool repeat)
+    : m_delay(delay), m_duration(duration), m_repeat(repeat)
 {
-  Init();
 }
 
-void SCA_DelaySensor::Init()
+SCA_DelaySensorBatch::~SCA_DelaySensorBatch()
 {
-  m_lastResult = false;
-  m_frameCount = -1;
-  m_reset = true;
 }
 
-SCA_DelaySensor::~SCA_DelaySensor()
+void SCA_DelaySensorBatch::AppendState(SCA_ISensor *sensor,
+                                       const SCA_SensorBatch *other,
+                                       unsigned int index)
 {
-  /* intentionally empty */
+  const SCA_DelaySensorBatch *batch = static_cast<const SCA_DelaySensorBatch *>(other);
+  if (batch) {
+    m_frameCounts.push_back(batch->m_frameCounts[index]);
+    m_lastResults.push_back(batch->m_lastResults[index]);
+    m_resets.push_back(batch->m_resets[index]);
+  }
+  else {
+    m_frameCounts.push_back(-1);
+    m_lastResults.push_back(false);
+    m_resets.push_back(true);
+  }
 }
 
-CValue *SCA_DelaySensor::GetReplica()
+void SCA_DelaySensorBatch::MoveState(unsigned int from, unsigned int to)
 {
-  CValue *replica = new SCA_DelaySensor(*this);
-  // this will copy properties and so on...
-  replica->ProcessReplica();
+  m_frameCounts[to] = m_frameCounts[from];
+  m_lastResults[to] = m_lastResults[from];
+  m_resets[to] = m_resets[from];
+}
 
-  return replica;
+void SCA_DelaySensorBatch::PopState()
+{
+  m_frameCounts.pop_back();
+  m_lastResults.pop_back();
+  m_resets.pop_back();
 }
 
-bool SCA_DelaySensor::IsPositiveTrigger()
+void SCA_DelaySensorBatch::Evaluate()
 {
-  return (m_invert ? !m_lastResult : m_lastResult);
+  for (unsigned int i = 0, size = m_sensors.size(); i < size; ++i) {
+    if (m_states[i] == STATE_EVALUATED) {
+      m_results[i] = EvaluateSensor(i);
+    }
+  }
 }
 
-bool SCA_DelaySensor::Evaluate()
+void SCA_DelaySensorBatch::Init(unsigned int index)
 {
-  bool trigger = false;
+  m_lastResults[index] = false;
+  m_frameCounts[index] = -1;
+  m_resets[index] = true;
+}
+
+unsigned char SCA_DelaySensorBatch::EvaluateSensor(unsigned int index)
+{
+  int &frameCount = m_frameCounts[index];
   bool result;
 
-  if (m_frameCount == -1) {
+  if (frameCount == -1) {
     // this is needed to ensure ON trigger in case delay==0
     // and avoid spurious OFF trigger when duration==0
-    m_lastResult = false;
-    m_frameCount = 0;
+    m_lastResults[index] = false;
+    frameCount = 0;
   }
 
-  if (m_frameCount < m_delay) {
-    m_frameCount++;
+  if (frameCount < m_delay) {
+    frameCount++;
     result = false;
   }
   else if (m_duration > 0) {
-    if (m_frameCount < m_delay + m_duration) {
-      m_frameCount++;
+    if (frameCount < m_delay + m_duration) {
+      frameCount++;
       result = true;
     }
     else {
       result = false;
       if (m_repeat)
-        m_frameCount = -1;
+        frameCount = -1;
     }
   }
   else {
     result = true;
     if (m_repeat)
-      m_frameCount = -1;
+      frameCount = -1;
+  }
+
+  unsigned char flags = 0;
+  if (result != (bool)m_lastResults[index]) {
+    flags |= RESULT_CHANGED;
+  }
+  if (m_resets[index]) {
+    flags |= RESULT_RESET;
+  }
+  if (result) {
+    flags |= RESULT_POSITIVE;
+  }
+  m_resets[index] = false;
+  m_lastResults[index] = result;
+
+  if (IsIdle(index)) {
+    flags |= RESULT_IDLE;
+  }
+
+  return flags;
+}
+
+bool SCA_DelaySensorBatch::IsIdle(unsigned int index) const
+{
+  if (m_repeat || m_resets[index]) {
+    return false;
   }
-  if ((m_reset && m_level) || result != m_lastResult)
-    trigger = true;
-  m_reset = false;
-  m_lastResult = result;
-  return trigger;
+
+  // The last result is negative after a duration and positive without duration.
+  return (m_frameCounts[index] >= m_delay + m_duration &&
+          (bool)m_lastResults[index] == (m_duration == 0));
+}
+
+bool SCA_DelaySensorBatch::GetLastResult(unsigned int index) const
+{
+  return m_lastResults[index];
+}
+
+/* ------------------------------------------------------------------------- */
+/* Native functions                                                          */
+/* ------------------------------------------------------------------------- */
+
+SCA_DelaySensor::SCA_DelaySensor(
+    class SCA_EventManager *eventmgr, SCA_IObject *gameobj, int delay, int duration, bool repeat)
+    : SCA_ISensor(gameobj, eventmgr), m_repeat(repeat), m_delay(delay), m_duration(duration)
+{
+  ResetBatch();
+  Init();
+}
+
+SCA_DelaySensorBatch *SCA_DelaySensor::GetDelayBatch() const
+{
+  return static_cast<SCA_DelaySensorBatch *>(m_batch.get());
+}
+
+void SCA_DelaySensor::Init()
+{
+  GetDelayBatch()->Init(m_batchIndex);
+}
+
+SCA_DelaySensor::~SCA_DelaySensor()
+{
+  /* intentionally empty */
+}
+
+CValue *SCA_DelaySensor::GetReplica()
+{
+  CValue *replica = new SCA_DelaySensor(*this);
+  // this will copy properties and so on...
+  replica->ProcessReplica();
+
+  return replica;
+}
+
+bool SCA_DelaySensor::IsPositiveTrigger()
+{
+  const bool lastResult = GetDelayBatch()->GetLastResult(m_batchIndex);
+  return (m_invert ? !lastResult : lastResult);
+}
+
+bool SCA_DelaySensor::Evaluate()
+{
+  const unsigned char result = GetDelayBatch()->EvaluateSensor(m_batchIndex);
+  return (result & SCA_SensorBatch::RESULT_CHANGED) ||
+         ((result & SCA_SensorBatch::RESULT_RESET) && m_level);
+}
+
+bool SCA_DelaySensor::IsIdle()
+{
+  return GetDelayBatch()->IsIdle(m_batchIndex);
+}
+
+SCA_SensorBatch *SCA_DelaySensor::NewBatch()
+{
+  return new SCA_DelaySensorBatch(m_delay, m_duration, m_repeat);
 }
 
 #ifdef WITH_PYTHON
@@ -126,6 +238,15 @@ bool SCA_DelaySensor::Evaluate()
 /* Python functions                                                          */
 /* ------------------------------------------------------------------------- */
 
+int SCA_DelaySensor::pyattr_check_parameters(PyObjectPlus *self_v,
+                                             const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  SCA_DelaySensor *self = static_cast<SCA_DelaySensor *>(self_v);
+  self->ResetBatch();
+  self->Wake();
+  return 0;
+}
+
 /* Integration hooks ------------------------------------------------------- */
 PyTypeObject SCA_DelaySensor::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "SCA_DelaySensor",
                                       sizeof(PyObjectPlus_Proxy),
@@ -170,9 +291,12 @@ PyMethodDef SCA_DelaySensor::Methods[] = {
 };
 
 PyAttributeDef SCA_DelaySensor::Attributes[] = {
-    KX_PYATTRIBUTE_INT_RW("delay", 0, 100000, true, SCA_DelaySensor, m_delay),
-    KX_PYATTRIBUTE_INT_RW("duration", 0, 100000, true, SCA_DelaySensor, m_duration),
-    KX_PYATTRIBUTE_BOOL_RW("repeat", SCA_DelaySensor, m_repeat),
+    KX_PYATTRIBUTE_INT_RW_CHECK(
+        "delay", 0, 100000, true, SCA_DelaySensor, m_delay, pyattr_check_parameters),
+    KX_PYATTRIBUTE_INT_RW_CHECK(
+        "duration", 0, 100000, true, SCA_DelaySensor, m_duration, pyattr_check_parameters),
+    KX_PYATTRIBUTE_BOOL_RW_CHECK(
+        "repeat", SCA_DelaySensor, m_repeat, pyattr_check_parameters),
     KX_PYATTRIBUTE_NULL  // Sentinel
 };
 
@@ -35,13 +35,43 @@
 #ifndef __SCA_DELAYSENSOR_H__
 #define __SCA_DELAYSENSOR_H__
 #include "SCA_ISensor.h"
+#include "SCA_SensorBatch.h"
+
+/// Delay sensors of same delay, duration and repeat.
+class SCA_DelaySensorBatch : public SCA_SensorBatch {
+ private:
+  const int m_delay;
+  const int m_duration;
+  const bool m_repeat;
+  std::vector<int> m_frameCounts;
+  std::vector<unsigned char> m_lastResults;
+  std::vector<unsigned char> m_resets;
+
+ protected:
+  virtual void AppendState(SCA_ISensor *sensor,
+                           const SCA_SensorBatch *other,
+                           unsigned int index);
+  virtual void MoveState(unsigned int from, unsigned int to);
+  virtual void PopState();
+  virtual void Evaluate();
+
+ public:
+  SCA_DelaySensorBatch(int delay, int duration, bool repeat);
+  virtual ~SCA_DelaySensorBatch();
+
+  void Init(unsigned int index);
+  /// Evaluate a sensor and return the flags of SCA_SensorBatch::Result.
+  unsigned char EvaluateSensor(unsigned int index);
+  bool IsIdle(unsigned int index) const;
+  bool GetLastResult(unsigned int index) const;
+};
 
 class SCA_DelaySensor : public SCA_ISensor {
-  Py_Header bool m_lastResult;
-  bool m_repeat;
+  Py_Header bool m_repeat;
   int m_delay;
   int m_duration;
-  int m_frameCount;
+
+  SCA_DelaySensorBatch *GetDelayBatch() const;
 
  public:
   SCA_DelaySensor(class SCA_EventManager *eventmgr,
@@ -54,6 +84,14 @@ class SCA_DelaySensor : public SCA_ISensor {
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
   virtual void Init();
+  /// A sensor without repeat is idle once its delay and duration elapsed.
+  virtual bool IsIdle();
+  virtual SCA_SensorBatch *NewBatch();
+
+#ifdef WITH_PYTHON
+  /// Move the sensor to a batch of its new parameters.
+  static int pyattr_check_parameters(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+#endif  // WITH_PYTHON
 
   /* --------------------------------------------------------------------- */
   /* Python interface ---------------------------------------------------- */
@@ -31,6 +31,7 @@
 
 #include "SCA_EventManager.h"
 #include "SCA_ISensor.h"
+#include "SCA_SensorBatch.h"
 
 SCA_EventManager::SCA_EventManager(SCA_LogicManager *logicmgr, EVENT_MANAGER_TYPE mgrtype)
     : m_logicmgr(logicmgr), m_mgrtype(mgrtype)
@@ -41,12 +42,31 @@ SCA_EventManager::~SCA_EventManager()
 {
   // all sensors should be removed
   BLI_assert(m_sensors.size() == 0);
+  BLI_assert(m_activeSensors.size() == 0);
+  BLI_assert(m_batches.size() == 0);
 }
 
 bool SCA_EventManager::RegisterSensor(class SCA_ISensor *sensor)
 {
   if (std::find(m_sensors.begin(), m_sensors.end(), sensor) == m_sensors.end()) {
     m_sensors.push_back(sensor);
+
+    SCA_SensorBatch *batch = sensor->GetBatch();
+    if (batch) {
+      // A sensor moved to another scene leaves the batch of its original.
+      if (batch->GetEventManager() && batch->GetEventManager() != this) {
+        sensor->ResetBatch();
+        batch = sensor->GetBatch();
+      }
+      if (batch->RegisterSensor(sensor->GetBatchIndex(), this)) {
+        m_batches.push_back(batch);
+      }
+    }
+    else {
+      // A newly registered sensor is evaluated at least once.
+      m_activeSensors.push_back(sensor);
+      sensor->SetSleeping(false);
+    }
     return true;
   }
 
@@ -58,12 +78,63 @@ bool SCA_EventManager::RemoveSensor(class SCA_ISensor *sensor)
   std::vector<SCA_ISensor *>::iterator it = std::find(m_sensors.begin(), m_sensors.end(), sensor);
   if (it != m_sensors.end()) {
     m_sensors.erase(it);
+    SCA_SensorBatch *batch = sensor->GetBatch();
+    if (batch) {
+      if (batch->UnregisterSensor(sensor->GetBatchIndex())) {
+        m_batches.erase(std::find(m_batches.begin(), m_batches.end(), batch));
+      }
+    }
+    else if (sensor->IsSleeping()) {
+      sensor->SetSleeping(false);
+    }
+    else {
+      m_activeSensors.erase(std::find(m_activeSensors.begin(), m_activeSensors.end(), sensor));
+    }
     return true;
   }
 
   return false;
 }
 
+void SCA_EventManager::WakeSensor(SCA_ISensor *sensor)
+{
+  if (sensor->IsSleeping()) {
+    sensor->SetSleeping(false);
+    m_activeSensors.push_back(sensor);
+  }
+}
+
+void SCA_EventManager::WakeAllSensors()
+{
+  for (SCA_ISensor *sensor : m_sensors) {
+    sensor->Wake();
+  }
+}
+
+void SCA_EventManager::ActivateSensors()
+{
+  for (SCA_SensorBatch *batch : m_batches) {
+    batch->Activate(m_logicmgr);
+  }
+
+  /* The sensors woken by the activation of an other sensor are appended after the sensors
+   * activated in this loop, they are kept for the next frame. */
+  const unsigned int size = m_activeSensors.size();
+  unsigned int numAwake = 0;
+  for (unsigned int i = 0; i < size; ++i) {
+    SCA_ISensor *sensor = m_activeSensors[i];
+    sensor->Activate(m_logicmgr);
+    if (sensor->CanSleep()) {
+      sensor->SetSleeping(true);
+    }
+    else {
+      m_activeSensors[numAwake++] = sensor;
+    }
+  }
+
+  m_activeSensors.erase(m_activeSensors.begin() + numAwake, m_activeSensors.begin() + size);
+}
+
 void SCA_EventManager::NextFrame(double curtime, double fixedtime)
 {
   NextFrame();
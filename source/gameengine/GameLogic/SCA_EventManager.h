@@ -37,6 +37,7 @@
 #include <algorithm>
 
 class SCA_ISensor;
+class SCA_SensorBatch;
 
 class SCA_EventManager {
  protected:
@@ -44,6 +45,17 @@ class SCA_EventManager {
       *m_logicmgr; /* all event manager subclasses use this (other then TimeEventManager) */
 
   std::vector<SCA_ISensor *> m_sensors;
+  /** Registered sensors evaluated at each frame, the other registered sensors are sleeping until
+   * they are woken by an event.
+   */
+  std::vector<SCA_ISensor *> m_activeSensors;
+  /// Batches of the registered sensors evaluated in batches.
+  std::vector<SCA_SensorBatch *> m_batches;
+
+  /** Activate the batches and the awake sensors and put to sleep the ones without any pending
+   * event.
+   */
+  void ActivateSensors();
 
  public:
   enum EVENT_MANAGER_TYPE {
@@ -70,6 +82,9 @@ class SCA_EventManager {
   virtual void UpdateFrame();
   virtual void EndFrame();
   virtual bool RegisterSensor(class SCA_ISensor *sensor);
+  /// Evaluate again a sleeping sensor from the next activation.
+  void WakeSensor(SCA_ISensor *sensor);
+  void WakeAllSensors();
   int GetType();
   // SG_DList &GetSensors() { return m_sensors; }
 
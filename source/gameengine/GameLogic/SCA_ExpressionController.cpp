@@ -41,13 +41,18 @@
 
 #include "CM_Message.h"
 
+#include <algorithm>
+
 /* ------------------------------------------------------------------------- */
 /* Native functions                                                          */
 /* ------------------------------------------------------------------------- */
 
 SCA_ExpressionController::SCA_ExpressionController(SCA_IObject *gameobj,
                                                    const std::string &exprtext)
-    : SCA_IController(gameobj), m_exprText(exprtext), m_exprCache(nullptr)
+    : SCA_IController(gameobj),
+      m_exprText(exprtext),
+      m_exprCache(nullptr),
+      m_compiledExpr(std::make_shared<CCompiledExpression>())
 {
 }
 
@@ -62,6 +67,10 @@ CValue *SCA_ExpressionController::GetReplica()
   SCA_ExpressionController *replica = new SCA_ExpressionController(*this);
   replica->m_exprText = m_exprText;
   replica->m_exprCache = nullptr;
+  // The program is shared, the identifiers are bound to the sensors of the replica when triggered.
+  replica->m_identifierSensors.clear();
+  replica->m_identifierKeys.clear();
+  replica->m_identifierValues.clear();
   // this will copy properties and so on...
   replica->ProcessReplica();
 
@@ -79,16 +88,102 @@ void SCA_ExpressionController::Delete()
   Release();
 }
 
+void SCA_ExpressionController::ParseExpression()
+{
+  CParser parser;
+  parser.SetContext(this->AddRef());
+  m_exprCache = parser.ProcessText(m_exprText);
+}
+
+void SCA_ExpressionController::BindIdentifiers()
+{
+  const std::vector<std::string> &identifiers = m_compiledExpr->GetIdentifiers();
+  const unsigned int size = identifiers.size();
+  m_identifierSensors.assign(size, nullptr);
+  m_identifierKeys.assign(size, CPropertyKey());
+  m_identifierValues.resize(size);
+
+  // Same lookup as FindIdentifier.
+  for (unsigned int i = 0; i < size; ++i) {
+    const std::string &name = identifiers[i];
+    for (SCA_ISensor *sensor : m_linkedsensors) {
+      if (sensor->GetName() == name) {
+        m_identifierSensors[i] = sensor;
+        break;
+      }
+    }
+
+    if (!m_identifierSensors[i] && name.find('.') == std::string::npos) {
+      m_identifierKeys[i] = CPropertyKey(name);
+    }
+  }
+}
+
+void SCA_ExpressionController::UpdateIdentifierValues()
+{
+  for (unsigned int i = 0, size = m_identifierValues.size(); i < size; ++i) {
+    CCompiledExpression::Value &value = m_identifierValues[i];
+    SCA_ISensor *sensor = m_identifierSensors[i];
+
+    if (sensor) {
+      // The sensors can be unlinked, resolve the identifiers again in this case.
+      if (std::find(m_linkedsensors.begin(), m_linkedsensors.end(), sensor) ==
+          m_linkedsensors.end()) {
+        BindIdentifiers();
+        UpdateIdentifierValues();
+        return;
+      }
+
+      value.m_type = VALUE_BOOL_TYPE;
+      value.m_bool = sensor->GetState();
+    }
+    else if (m_identifierKeys[i].IsValid()) {
+      CValue *prop = GetParent()->GetProperty(m_identifierKeys[i]);
+      if (prop) {
+        value.Set(prop);
+      }
+      else {
+        value.m_type = VALUE_NO_TYPE;
+      }
+    }
+    else {
+      CValue *prop = GetParent()->FindIdentifier(m_compiledExpr->GetIdentifiers()[i]);
+      value.Set(prop);
+      prop->Release();
+    }
+  }
+}
+
 void SCA_ExpressionController::Trigger(SCA_LogicManager *logicmgr)
 {
 
   bool expressionresult = false;
-  if (!m_exprCache) {
-    CParser parser;
-    parser.SetContext(this->AddRef());
-    m_exprCache = parser.ProcessText(m_exprText);
+  bool evaluated = false;
+  if (m_compiledExpr->GetStatus() == CCompiledExpression::STATUS_EMPTY) {
+    // The first triggered replica compiles the program for all the replicas.
+    ParseExpression();
+    m_compiledExpr->Compile(m_exprCache);
   }
-  if (m_exprCache) {
+
+  /* The compiled expression only handles the numbers and booleans, the expression tree is
+   * calculated for the other values and to report the errors. */
+  if (m_compiledExpr->GetStatus() == CCompiledExpression::STATUS_COMPILED) {
+    if (m_identifierValues.size() != m_compiledExpr->GetIdentifiers().size()) {
+      BindIdentifiers();
+    }
+    UpdateIdentifierValues();
+    CCompiledExpression::Value result;
+    if (m_compiledExpr->Evaluate(m_identifierValues, m_evaluationStack, result)) {
+      expressionresult = !MT_fuzzyZero((float)result.GetNumber());
+      evaluated = true;
+    }
+  }
+
+  if (!evaluated && !m_exprCache) {
+    ParseExpression();
+  }
+
+  if (m_exprCache && !evaluated) {
     CValue *value = m_exprCache->Calculate();
     if (value) {
       if (value->IsError()) {
@@ -36,6 +36,9 @@
 #define __SCA_EXPRESSIONCONTROLLER_H__
 
 #include "SCA_IController.h"
+#include "EXP_CompiledExpression.h"
+
+#include <memory>
 
 class CExpression;
 
@@ -43,6 +46,23 @@ class SCA_ExpressionController : public SCA_IController {
   //	Py_Header
   std::string m_exprText;
   CExpression *m_exprCache;
+  /// Program of m_exprText shared by the replicas of the controller.
+  std::shared_ptr<CCompiledExpression> m_compiledExpr;
+  /// Linked sensors of the identifiers of m_compiledExpr, nullptr for the properties.
+  std::vector<SCA_ISensor *> m_identifierSensors;
+  /// Keys of the property identifiers, invalid for the sensors and the sub properties paths.
+  std::vector<CPropertyKey> m_identifierKeys;
+  /// Values of the identifiers passed to m_compiledExpr.
+  std::vector<CCompiledExpression::Value> m_identifierValues;
+  /// Evaluation stack of m_compiledExpr.
+  std::vector<CCompiledExpression::Value> m_evaluationStack;
+
+  /// Parse m_exprText into m_exprCache.
+  void ParseExpression();
+  /// Resolve the identifiers of m_compiledExpr to the linked sensors or the properties.
+  void BindIdentifiers();
+  /// Fill m_identifierValues from the sensors and properties.
+  void UpdateIdentifierValues();
 
  public:
   SCA_ExpressionController(SCA_IObject *gameobj, const std::string &exprtext);
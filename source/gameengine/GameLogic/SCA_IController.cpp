@@ -147,6 +147,8 @@ void SCA_IController::ApplyState(unsigned int state)
 
       for (SCA_ISensor *sensor : m_linkedsensors) {
         sensor->IncLink();
+        // A level sensor sends its state to the just activated controller.
+        sensor->Wake();
       }
       SetActive(true);
       m_justActivated = true;
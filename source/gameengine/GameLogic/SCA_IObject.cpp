@@ -86,6 +86,13 @@ void SCA_IObject::AddSensor(SCA_ISensor *act)
   m_sensors.push_back(act);
 }
 
+void SCA_IObject::PropertyModified(const CPropertyKey &key)
+{
+  for (SCA_ISensor *sensor : m_sensors) {
+    sensor->ParentPropertyModified(key);
+  }
+}
+
 void SCA_IObject::AddController(SCA_IController *act)
 {
   act->AddRef();
@@ -131,6 +131,8 @@ class SCA_IObject : public CValue {
   }
 
   void AddSensor(SCA_ISensor *act);
+  /// Forward the modification of a property to the sensors.
+  virtual void PropertyModified(const CPropertyKey &key);
   void AddController(SCA_IController *act);
   void AddActuator(SCA_IActuator *act);
   void RegisterActuator(SCA_IActuator *act);
@@ -175,6 +177,12 @@ class SCA_IObject : public CValue {
     return m_ignore_activity_culling;
   }
 
+  /// Return true if the object is suspended by the activity culling.
+  bool IsActivitySuspended() const
+  {
+    return m_suspended;
+  }
+
   /**
    * Suspend all progress.
    */
@@ -35,11 +35,14 @@
 #include "SCA_ISensor.h"
 #include "SCA_EventManager.h"
 #include "SCA_LogicManager.h"
+#include "SCA_SensorBatch.h"
 // needed for IsTriggered()
 #include "SCA_PythonController.h"
 
 #include "CM_Message.h"
 
+#include "BLI_utildefines.h"
+
 void SCA_ISensor::ReParent(SCA_IObject *parent)
 {
   SCA_ILogicBrick::ReParent(parent);
@@ -60,18 +63,28 @@ SCA_ISensor::SCA_ISensor(SCA_IObject *gameobj, SCA_EventManager *eventmgr)
       m_suspended(false),
       m_links(0),
       m_state(false),
-      m_prev_state(false)
+      m_prev_state(false),
+      m_sleeping(false),
+      m_batchIndex(0)
 {
 }
 
 SCA_ISensor::~SCA_ISensor()
 {
+  if (m_batch) {
+    m_batch->RemoveSensor(m_batchIndex);
+  }
 }
 
 void SCA_ISensor::ProcessReplica()
 {
   SCA_ILogicBrick::ProcessReplica();
   m_linkedcontrollers.clear();
+  m_sleeping = false;
+  // The replica joins the batch of its original with a copy of its state.
+  if (m_batch) {
+    m_batchIndex = m_batch->AddSensor(this, m_batch.get(), m_batchIndex);
+  }
 }
 
 bool SCA_ISensor::IsPositiveTrigger()
@@ -123,6 +136,9 @@ SCA_ISensor::sensortype SCA_ISensor::GetSensorType()
 void SCA_ISensor::Suspend()
 {
   m_suspended = true;
+  if (m_batch) {
+    m_batch->SleepSensor(m_batchIndex);
+  }
 }
 
 bool SCA_ISensor::IsSuspended()
@@ -133,6 +149,7 @@ bool SCA_ISensor::IsSuspended()
 void SCA_ISensor::Resume()
 {
   m_suspended = false;
+  Wake();
 }
 
 bool SCA_ISensor::GetState()
@@ -155,6 +172,102 @@ int SCA_ISensor::GetNegTicks()
   return m_neg_ticks;
 }
 
+bool SCA_ISensor::IsIdle()
+{
+  return false;
+}
+
+bool SCA_ISensor::IsStable() const
+{
+  /* The pulses are sent without any event and the tap negative pulse is sent the frame after
+   * the positive pulse. The state must also be stable for the status of the sensor. */
+  return !(m_pos_pulsemode || m_neg_pulsemode || (m_tap && m_state) || m_state != m_prev_state);
+}
+
+bool SCA_ISensor::CanSleep()
+{
+  // A suspended sensor does nothing until it's resumed.
+  if (m_suspended) {
+    return true;
+  }
+
+  return IsStable() && IsIdle();
+}
+
+bool SCA_ISensor::IsSleeping() const
+{
+  return m_sleeping;
+}
+
+void SCA_ISensor::SetSleeping(bool sleeping)
+{
+  m_sleeping = sleeping;
+}
+
+void SCA_ISensor::Wake()
+{
+  // Resume() wakes the sensor.
+  if (m_suspended) {
+    return;
+  }
+
+  if (m_batch) {
+    m_batch->WakeSensor(m_batchIndex);
+  }
+  else if (m_sleeping) {
+    m_eventmgr->WakeSensor(this);
+  }
+}
+
+void SCA_ISensor::ParentPropertyModified(const CPropertyKey &UNUSED(key))
+{
+}
+
+SCA_SensorBatch *SCA_ISensor::NewBatch()
+{
+  return nullptr;
+}
+
+void SCA_ISensor::ResetBatch()
+{
+  std::shared_ptr<SCA_SensorBatch> batch(NewBatch());
+  if (!batch) {
+    return;
+  }
+
+  // The registration is moved to the new batch.
+  const bool registered = m_batch && m_batch->IsRegistered(m_batchIndex);
+  if (registered) {
+    m_eventmgr->RemoveSensor(this);
+  }
+
+  const unsigned int index = batch->AddSensor(this, m_batch.get(), m_batchIndex);
+  if (m_batch) {
+    m_batch->RemoveSensor(m_batchIndex);
+  }
+  m_batch = batch;
+  m_batchIndex = index;
+
+  if (registered) {
+    m_eventmgr->RegisterSensor(this);
+  }
+}
+
+SCA_SensorBatch *SCA_ISensor::GetBatch() const
+{
+  return m_batch.get();
+}
+
+unsigned int SCA_ISensor::GetBatchIndex() const
+{
+  return m_batchIndex;
+}
+
+void SCA_ISensor::SetBatchIndex(unsigned int index)
+{
+  m_batchIndex = index;
+}
+
 void SCA_ISensor::ClrLink()
 {
   m_links = 0;
@@ -262,68 +375,87 @@ void SCA_ISensor::Activate(class SCA_LogicManager *logicmgr)
    * don't evaluate a sensor that is not connected to any controller
    */
   if (m_links && !m_suspended) {
-    bool result = this->Evaluate();
-    // store the state for the rest of the logic system
-    m_prev_state = m_state;
-    m_state = this->IsPositiveTrigger();
-    if (result) {
-      // the sensor triggered this frame
-      if (m_state || !m_tap) {
-        ActivateControllers(logicmgr);
-        // reset these counters so that pulse are synchronized with transition
-        m_pos_ticks = 0;
-        m_neg_ticks = 0;
-      }
-      else {
-        result = false;
-      }
+    const bool result = this->Evaluate();
+    ActivateResult(logicmgr, result, this->IsPositiveTrigger());
+  }
+}
+
+bool SCA_ISensor::Activate(SCA_LogicManager *logicmgr, unsigned char result)
+{
+  if (!m_links || m_suspended) {
+    return true;
+  }
+
+  const bool trigger = (result & SCA_SensorBatch::RESULT_CHANGED) ||
+                       ((result & SCA_SensorBatch::RESULT_RESET) && m_level);
+  const bool positive = ((result & SCA_SensorBatch::RESULT_POSITIVE) != 0) != m_invert;
+  ActivateResult(logicmgr, trigger, positive);
+
+  return IsStable() && (result & SCA_SensorBatch::RESULT_IDLE);
+}
+
+void SCA_ISensor::ActivateResult(SCA_LogicManager *logicmgr, bool result, bool positive)
+{
+  // store the state for the rest of the logic system
+  m_prev_state = m_state;
+  m_state = positive;
+  if (result) {
+    // the sensor triggered this frame
+    if (m_state || !m_tap) {
+      ActivateControllers(logicmgr);
+      // reset these counters so that pulse are synchronized with transition
+      m_pos_ticks = 0;
+      m_neg_ticks = 0;
     }
     else {
-      /* First, the pulsing behavior, if pulse mode is
-       * active. It seems something goes wrong if pulse mode is
-       * not set :( */
-      if (m_pos_pulsemode) {
-        m_pos_ticks++;
-        if (m_pos_ticks > m_skipped_ticks) {
-          if (m_state) {
-            ActivateControllers(logicmgr);
-            result = true;
-          }
-          m_pos_ticks = 0;
-        }
-      }
-      // negative pulse doesn't make sense in tap mode, skip
-      if (m_neg_pulsemode && !m_tap) {
-        m_neg_ticks++;
-        if (m_neg_ticks > m_skipped_ticks) {
-          if (!m_state) {
-            ActivateControllers(logicmgr);
-            result = true;
-          }
-          m_neg_ticks = 0;
+      result = false;
+    }
+  }
+  else {
+    /* First, the pulsing behavior, if pulse mode is
+     * active. It seems something goes wrong if pulse mode is
+     * not set :( */
+    if (m_pos_pulsemode) {
+      m_pos_ticks++;
+      if (m_pos_ticks > m_skipped_ticks) {
+        if (m_state) {
+          ActivateControllers(logicmgr);
+          result = true;
         }
+        m_pos_ticks = 0;
       }
     }
-    if (m_tap) {
-      // in tap mode: we send always a negative pulse immediately after a positive pulse
-      if (!result) {
-        // the sensor did not trigger on this frame
-        if (m_prev_state) {
-          // but it triggered on previous frame => send a negative pulse
+    // negative pulse doesn't make sense in tap mode, skip
+    if (m_neg_pulsemode && !m_tap) {
+      m_neg_ticks++;
+      if (m_neg_ticks > m_skipped_ticks) {
+        if (!m_state) {
           ActivateControllers(logicmgr);
           result = true;
         }
-        // in any case, absence of trigger means sensor off
-        m_state = false;
+        m_neg_ticks = 0;
       }
     }
-    if (!result && m_level) {
-      // This level sensor is connected to at least one controller that was just made
-      // active but it did not generate an event yet, do it now to those controllers only
-      for (SCA_IController *controller : m_linkedcontrollers) {
-        if (controller->IsJustActivated()) {
-          logicmgr->AddTriggeredController(controller, this);
-        }
+  }
+  if (m_tap) {
+    // in tap mode: we send always a negative pulse immediately after a positive pulse
+    if (!result) {
+      // the sensor did not trigger on this frame
+      if (m_prev_state) {
+        // but it triggered on previous frame => send a negative pulse
+        ActivateControllers(logicmgr);
+        result = true;
+      }
+      // in any case, absence of trigger means sensor off
+      m_state = false;
+    }
+  }
+  if (!result && m_level) {
+    // This level sensor is connected to at least one controller that was just made
+    // active but it did not generate an event yet, do it now to those controllers only
+    for (SCA_IController *controller : m_linkedcontrollers) {
+      if (controller->IsJustActivated()) {
+        logicmgr->AddTriggeredController(controller, this);
       }
     }
   }
@@ -344,6 +476,7 @@ KX_PYMETHODDEF_DOC_NOARGS(
 {
   Init();
   m_prev_state = false;
+  Wake();
   Py_RETURN_NONE;
 }
 
@@ -394,10 +527,12 @@ PyMethodDef SCA_ISensor::Methods[] = {
 };
 
 PyAttributeDef SCA_ISensor::Attributes[] = {
-    KX_PYATTRIBUTE_BOOL_RW("usePosPulseMode", SCA_ISensor, m_pos_pulsemode),
-    KX_PYATTRIBUTE_BOOL_RW("useNegPulseMode", SCA_ISensor, m_neg_pulsemode),
+    KX_PYATTRIBUTE_BOOL_RW_CHECK(
+        "usePosPulseMode", SCA_ISensor, m_pos_pulsemode, pyattr_check_wake),
+    KX_PYATTRIBUTE_BOOL_RW_CHECK(
+        "useNegPulseMode", SCA_ISensor, m_neg_pulsemode, pyattr_check_wake),
     KX_PYATTRIBUTE_INT_RW("skippedTicks", 0, 100000, true, SCA_ISensor, m_skipped_ticks),
-    KX_PYATTRIBUTE_BOOL_RW("invert", SCA_ISensor, m_invert),
+    KX_PYATTRIBUTE_BOOL_RW_CHECK("invert", SCA_ISensor, m_invert, pyattr_check_wake),
     KX_PYATTRIBUTE_BOOL_RW_CHECK("level", SCA_ISensor, m_level, pyattr_check_level),
     KX_PYATTRIBUTE_BOOL_RW_CHECK("tap", SCA_ISensor, m_tap, pyattr_check_tap),
     KX_PYATTRIBUTE_RO_FUNCTION("triggered", SCA_ISensor, pyattr_get_triggered),
@@ -463,6 +598,7 @@ int SCA_ISensor::pyattr_check_level(PyObjectPlus *self_v, const KX_PYATTRIBUTE_D
   if (self->m_level) {
     self->m_tap = false;
   }
+  self->Wake();
   return 0;
 }
 
@@ -472,6 +608,14 @@ int SCA_ISensor::pyattr_check_tap(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF
   if (self->m_tap) {
     self->m_level = false;
   }
+  self->Wake();
+  return 0;
+}
+
+int SCA_ISensor::pyattr_check_wake(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  SCA_ISensor *self = static_cast<SCA_ISensor *>(self_v);
+  self->Wake();
   return 0;
 }
 
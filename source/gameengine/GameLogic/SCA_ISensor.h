@@ -36,7 +36,10 @@
 
 #include "SCA_IController.h"
 
+#include <memory>
+
 class SCA_EventManager;
+class SCA_SensorBatch;
 
 /**
  * Interface Class for all logic Sensors. Implements
@@ -88,8 +91,21 @@ class SCA_ISensor : public SCA_ILogicBrick {
   /// Previous state (for tap option).
   bool m_prev_state;
 
+  /// Sensor registered but not evaluated until it's woken.
+  bool m_sleeping;
+
+  /// Batch evaluating the sensor with its replicas, nullptr if the sensor is evaluated alone.
+  std::shared_ptr<SCA_SensorBatch> m_batch;
+  /// Index of the sensor state in its batch.
+  unsigned int m_batchIndex;
+
   std::vector<SCA_IController *> m_linkedcontrollers;
 
+  /// Send the result of an evaluation to the controllers and manage the pulses.
+  void ActivateResult(SCA_LogicManager *logicmgr, bool result, bool positive);
+  /// Return true if the state of the sensor is stable and it doesn't send pulses.
+  bool IsStable() const;
+
  public:
   enum sensortype {
     ST_NONE = 0,
@@ -109,10 +125,41 @@ class SCA_ISensor : public SCA_ILogicBrick {
   /* level of individual sensors. Mapping the old activate()s is easy.     */
   /* The IsPosTrig() also has to change, to keep things consistent.        */
   void Activate(SCA_LogicManager *logicmgr);
+  /** Activate the sensor with the result of its evaluation by its batch.
+   * \param result The flags of SCA_SensorBatch::Result.
+   * \return True if the sensor can sleep.
+   */
+  bool Activate(SCA_LogicManager *logicmgr, unsigned char result);
   virtual bool Evaluate() = 0;
   virtual bool IsPositiveTrigger();
   virtual void Init();
 
+  /** Return true if Evaluate() would return false and keep the sensor state until an event
+   * wakes the sensor, the event managers then skip the sensor. By default a sensor is always
+   * evaluated.
+   */
+  virtual bool IsIdle();
+  /// Return true if the activation of the sensor can be skipped until it's woken.
+  bool CanSleep();
+  bool IsSleeping() const;
+  void SetSleeping(bool sleeping);
+  /// Evaluate again the sensor if it was sleeping, unless it is suspended.
+  void Wake();
+  /// Notify that a property of the parent was set or removed, an invalid key for all properties.
+  virtual void ParentPropertyModified(const CPropertyKey &key);
+
+  /** Create an empty batch for the parameters of the sensor, nullptr if the sensor type is not
+   * evaluated in batches.
+   */
+  virtual SCA_SensorBatch *NewBatch();
+  /** Move the sensor and its state to a new batch, the replicas made before stay in the previous
+   * batch. Called at the construction and after a change of the parameters of the batch.
+   */
+  void ResetBatch();
+  SCA_SensorBatch *GetBatch() const;
+  unsigned int GetBatchIndex() const;
+  void SetBatchIndex(unsigned int index);
+
   virtual CValue *GetReplica() = 0;
 
   /** Set parameters for the pulsing behavior.
@@ -183,6 +230,8 @@ class SCA_ISensor : public SCA_ILogicBrick {
 
   static int pyattr_check_level(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
   static int pyattr_check_tap(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+  /// Wake the sensor after the change of an attribute used by the activation.
+  static int pyattr_check_wake(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
 
   enum SensorStatus {
     KX_SENSOR_INACTIVE = 0,
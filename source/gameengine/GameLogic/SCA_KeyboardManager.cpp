@@ -54,7 +54,14 @@ SCA_IInputDevice *SCA_KeyboardManager::GetInputDevice()
 
 void SCA_KeyboardManager::NextFrame()
 {
-  for (SCA_ISensor *sensor : m_sensors) {
-    sensor->Activate(m_logicmgr);
+  // The keyboard sensors are only evaluated again when a key changed.
+  for (int i = SCA_IInputDevice::BEGINKEY; i <= SCA_IInputDevice::ENDKEY; ++i) {
+    const SCA_InputEvent &input = m_inputDevice->GetInput((SCA_IInputDevice::SCA_EnumInputs)i);
+    if (input.m_queue.size() > 0) {
+      WakeAllSensors();
+      break;
+    }
   }
+
+  ActivateSensors();
 }
@@ -206,6 +206,19 @@ bool SCA_KeyboardSensor::Evaluate()
   return result;
 }
 
+bool SCA_KeyboardSensor::IsIdle()
+{
+  return !m_reset;
+}
+
+void SCA_KeyboardSensor::ParentPropertyModified(const CPropertyKey &key)
+{
+  // Log the keystrokes as soon as the toggle property is enabled.
+  if (!key.IsValid() || key.GetName() == m_toggleprop) {
+    Wake();
+  }
+}
+
 void SCA_KeyboardSensor::LogKeystrokes()
 {
   CValue *tprop = GetParent()->GetProperty(m_targetprop);
@@ -324,12 +337,28 @@ PyMethodDef SCA_KeyboardSensor::Methods[] = {
 PyAttributeDef SCA_KeyboardSensor::Attributes[] = {
     KX_PYATTRIBUTE_RO_FUNCTION("events", SCA_KeyboardSensor, pyattr_get_events),
     KX_PYATTRIBUTE_RO_FUNCTION("inputs", SCA_KeyboardSensor, pyattr_get_inputs),
-    KX_PYATTRIBUTE_BOOL_RW("useAllKeys", SCA_KeyboardSensor, m_bAllKeys),
-    KX_PYATTRIBUTE_INT_RW("key", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_hotkey),
-    KX_PYATTRIBUTE_SHORT_RW(
-        "hold1", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_qual),
-    KX_PYATTRIBUTE_SHORT_RW(
-        "hold2", 0, SCA_IInputDevice::ENDKEY, true, SCA_KeyboardSensor, m_qual2),
+    KX_PYATTRIBUTE_BOOL_RW_CHECK("useAllKeys", SCA_KeyboardSensor, m_bAllKeys, pyattr_check_wake),
+    KX_PYATTRIBUTE_INT_RW_CHECK("key",
+                                0,
+                                SCA_IInputDevice::ENDKEY,
+                                true,
+                                SCA_KeyboardSensor,
+                                m_hotkey,
+                                pyattr_check_wake),
+    KX_PYATTRIBUTE_SHORT_RW_CHECK("hold1",
+                                  0,
+                                  SCA_IInputDevice::ENDKEY,
+                                  true,
+                                  SCA_KeyboardSensor,
+                                  m_qual,
+                                  pyattr_check_wake),
+    KX_PYATTRIBUTE_SHORT_RW_CHECK("hold2",
+                                  0,
+                                  SCA_IInputDevice::ENDKEY,
+                                  true,
+                                  SCA_KeyboardSensor,
+                                  m_qual2,
+                                  pyattr_check_wake),
     KX_PYATTRIBUTE_STRING_RW(
         "toggleProperty", 0, MAX_PROP_NAME, false, SCA_KeyboardSensor, m_toggleprop),
     KX_PYATTRIBUTE_STRING_RW(
@@ -92,6 +92,9 @@ class SCA_KeyboardSensor : public SCA_ISensor {
 
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
+  /// The sensor is woken by the keyboard manager when a key changed.
+  virtual bool IsIdle();
+  virtual void ParentPropertyModified(const CPropertyKey &key);
 
 #ifdef WITH_PYTHON
   /* --------------------------------------------------------------------- */
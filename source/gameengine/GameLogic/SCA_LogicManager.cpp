@@ -37,6 +37,9 @@
 #include "SCA_IActuator.h"
 #include "SCA_EventManager.h"
 #include "SCA_PythonController.h"
+
+#include "CM_Profiler.h"
+
 #include <set>
 
 SCA_LogicManager::SCA_LogicManager()
@@ -52,6 +55,12 @@ SCA_LogicManager::~SCA_LogicManager()
   }
   m_eventmanagers.clear();
   BLI_assert(m_activeActuators.Empty());
+
+#ifdef WITH_PYTHON
+  for (const std::pair<const std::string, PyObject *> &pair : m_scriptBytecodes) {
+    Py_DECREF(pair.second);
+  }
+#endif
 }
 
 void SCA_LogicManager::RegisterEventManager(SCA_EventManager *eventmgr)
@@ -106,6 +115,22 @@ void *SCA_LogicManager::FindBlendObjByGameMeshName(const std::string &gamemeshna
   return m_map_gamemeshname_to_blendobj[mn];
 }
 
+#ifdef WITH_PYTHON
+PyObject *SCA_LogicManager::FindScriptBytecode(const std::string &key) const
+{
+  const std::map<std::string, PyObject *>::const_iterator it = m_scriptBytecodes.find(key);
+  return (it != m_scriptBytecodes.end()) ? it->second : nullptr;
+}
+
+void SCA_LogicManager::RegisterScriptBytecode(const std::string &key, PyObject *bytecode)
+{
+  PyObject *&entry = m_scriptBytecodes[key];
+  Py_XDECREF(entry);
+  Py_INCREF(bytecode);
+  entry = bytecode;
+}
+#endif  // WITH_PYTHON
+
 void SCA_LogicManager::RemoveSensor(SCA_ISensor *sensor)
 {
   sensor->UnlinkAllControllers();
@@ -140,6 +165,8 @@ void SCA_LogicManager::RegisterToActuator(SCA_IController *controller, SCA_IActu
 
 void SCA_LogicManager::BeginFrame(double curtime, double fixedtime)
 {
+  CM_ProfileScope profileScope("logic", "BeginFrame");
+
   for (std::vector<SCA_EventManager *>::const_iterator ie = m_eventmanagers.begin();
        !(ie == m_eventmanagers.end());
        ie++)
@@ -157,6 +184,8 @@ void SCA_LogicManager::BeginFrame(double curtime, double fixedtime)
 
 void SCA_LogicManager::UpdateFrame(double curtime)
 {
+  CM_ProfileScope profileScope("logic", "UpdateFrame");
+
   for (std::vector<SCA_EventManager *>::const_iterator ie = m_eventmanagers.begin();
        !(ie == m_eventmanagers.end());
        ie++)
@@ -172,7 +201,12 @@ void SCA_LogicManager::UpdateFrame(double curtime)
       SCA_IActuator *actua = *ia;
       // increment first to allow removal of inactive actuators.
       ++ia;
-      if (!actua->Update(curtime)) {
+      bool active;
+      {
+        CM_ProfileScope actuatorScope("actuator", actua);
+        active = actua->Update(curtime);
+      }
+      if (!active) {
         // this actuator is not active anymore, remove
         actua->QDelink();
         actua->SetActive(false);
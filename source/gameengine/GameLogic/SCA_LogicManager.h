@@ -82,6 +82,11 @@ class SCA_LogicManager {
   std::map<std::string, void *> m_map_gamemeshname_to_blendobj;
   std::map<void *, CValue *> m_map_blendobj_to_gameobj;
 
+#ifdef WITH_PYTHON
+  /// Bytecode of the python controller scripts, shared by the controllers running the same text.
+  std::map<std::string, PyObject *> m_scriptBytecodes;
+#endif
+
  public:
   SCA_LogicManager();
   virtual ~SCA_LogicManager();
@@ -142,6 +147,13 @@ class SCA_LogicManager {
   void RegisterGameObj(void *blendobj, CValue *gameobj);
   void UnregisterGameObj(void *blendobj, CValue *gameobj);
   CValue *FindGameObjByBlendObj(void *blendobj);
+
+#ifdef WITH_PYTHON
+  /// Return the borrowed bytecode of a script or nullptr if it was not compiled yet.
+  PyObject *FindScriptBytecode(const std::string &key) const;
+  /// Keep a reference to the bytecode of a script for the next controllers running it.
+  void RegisterScriptBytecode(const std::string &key, PyObject *bytecode);
+#endif
 };
 
 #endif /* __SCA_LOGICMANAGER_H__ */
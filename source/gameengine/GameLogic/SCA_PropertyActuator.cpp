@@ -38,6 +38,7 @@
 #include "EXP_InputParser.h"
 #include "EXP_Operator2Expr.h"
 #include "EXP_ConstExpr.h"
+#include "EXP_IdentifierExpr.h"
 
 /* ------------------------------------------------------------------------- */
 /* Native functions                                                          */
@@ -51,8 +52,10 @@ SCA_PropertyActuator::SCA_PropertyActuator(SCA_IObject *gameobj,
     : SCA_IActuator(gameobj, KX_ACT_PROPERTY),
       m_type(acttype),
       m_propname(propname),
+      m_propkey(propname),
       m_exprtxt(expr),
-      m_sourceObj(sourceObj)
+      m_sourceObj(sourceObj),
+      m_compiledExpr(std::make_shared<CCompiledExpression>())
 {
   // protect ourselves against someone else deleting the source object
   // don't protect against ourselves: it would create a dead lock
@@ -77,15 +80,23 @@ bool SCA_PropertyActuator::Update()
   if (bNegativeEvent) {
     if (m_type == KX_ACT_PROP_LEVEL) {
       CValue *newval = new CBoolValue(false);
-      CValue *oldprop = propowner->GetProperty(m_propname);
+      CValue *oldprop = propowner->GetProperty(m_propkey);
       if (oldprop) {
         oldprop->SetValue(newval);
+        propowner->PropertyModified(m_propkey);
       }
       newval->Release();
     }
     return false;
   }
 
+  /* The assigned and added expressions are evaluated by the program shared with the replicas,
+   * the expression is only parsed when its values are not supported. */
+  if ((m_type == KX_ACT_PROP_ASSIGN || m_type == KX_ACT_PROP_ADD) &&
+      UpdateCompiledExpression(propowner)) {
+    return result;
+  }
+
   CParser parser;
   parser.SetContext(propowner->AddRef());
 
@@ -94,25 +105,27 @@ bool SCA_PropertyActuator::Update()
   if (m_type == KX_ACT_PROP_TOGGLE) {
     /* don't use */
     CValue *newval;
-    CValue *oldprop = propowner->GetProperty(m_propname);
+    CValue *oldprop = propowner->GetProperty(m_propkey);
     if (oldprop) {
       newval = new CBoolValue((oldprop->GetNumber() == 0.0) ? true : false);
       oldprop->SetValue(newval);
+      propowner->PropertyModified(m_propkey);
     }
     else { /* as not been assigned, evaluate as false, so assign true */
       newval = new CBoolValue(true);
-      propowner->SetProperty(m_propname, newval);
+      propowner->SetProperty(m_propkey, newval);
     }
     newval->Release();
   }
   else if (m_type == KX_ACT_PROP_LEVEL) {
     CValue *newval = new CBoolValue(true);
-    CValue *oldprop = propowner->GetProperty(m_propname);
+    CValue *oldprop = propowner->GetProperty(m_propkey);
     if (oldprop) {
       oldprop->SetValue(newval);
+      propowner->PropertyModified(m_propkey);
     }
     else {
-      propowner->SetProperty(m_propname, newval);
+      propowner->SetProperty(m_propkey, newval);
     }
     newval->Release();
   }
@@ -122,18 +135,19 @@ bool SCA_PropertyActuator::Update()
       case KX_ACT_PROP_ASSIGN: {
 
         CValue *newval = userexpr->Calculate();
-        CValue *oldprop = propowner->GetProperty(m_propname);
+        CValue *oldprop = propowner->GetProperty(m_propkey);
         if (oldprop) {
           oldprop->SetValue(newval);
+          propowner->PropertyModified(m_propkey);
         }
         else {
-          propowner->SetProperty(m_propname, newval);
+          propowner->SetProperty(m_propkey, newval);
         }
         newval->Release();
         break;
       }
       case KX_ACT_PROP_ADD: {
-        CValue *oldprop = propowner->GetProperty(m_propname);
+        CValue *oldprop = propowner->GetProperty(m_propkey);
         if (oldprop) {
           // int waarde = (int)oldprop->GetNumber();  /*unused*/
           CExpression *expr = new COperator2Expr(
@@ -141,6 +155,7 @@ bool SCA_PropertyActuator::Update()
 
           CValue *newprop = expr->Calculate();
           oldprop->SetValue(newprop);
+          propowner->PropertyModified(m_propkey);
           newprop->Release();
           expr->Release();
         }
@@ -152,7 +167,7 @@ bool SCA_PropertyActuator::Update()
           CValue *copyprop = m_sourceObj->GetProperty(m_exprtxt);
           if (copyprop) {
             CValue *val = copyprop->GetReplica();
-            GetParent()->SetProperty(m_propname, val);
+            GetParent()->SetProperty(m_propkey, val);
             val->Release();
           }
         }
@@ -169,6 +184,105 @@ bool SCA_PropertyActuator::Update()
   return result;
 }
 
+void SCA_PropertyActuator::CompileExpression(CValue *propowner)
+{
+  CParser parser;
+  parser.SetContext(propowner->AddRef());
+  CExpression *userexpr = parser.ProcessText(m_exprtxt);
+  if (!userexpr) {
+    m_compiledExpr->Compile(nullptr);
+    return;
+  }
+
+  if (m_type == KX_ACT_PROP_ADD) {
+    // The paths to sub properties are not resolved as the added property.
+    if (m_propname.find('.') == std::string::npos) {
+      CExpression *expr = new COperator2Expr(
+          VALUE_ADD_OPERATOR, new CIdentifierExpr(m_propname, nullptr), userexpr->AddRef());
+      m_compiledExpr->Compile(expr);
+      expr->Release();
+    }
+    else {
+      m_compiledExpr->Compile(nullptr);
+    }
+  }
+  else {
+    m_compiledExpr->Compile(userexpr);
+  }
+
+  userexpr->Release();
+}
+
+void SCA_PropertyActuator::ResetCompiledExpression()
+{
+  m_compiledExpr = std::make_shared<CCompiledExpression>();
+  m_identifierKeys.clear();
+  m_identifierValues.clear();
+}
+
+bool SCA_PropertyActuator::UpdateCompiledExpression(CValue *propowner)
+{
+  if (m_compiledExpr->GetStatus() == CCompiledExpression::STATUS_EMPTY) {
+    // The first updated replica compiles the program for all the replicas.
+    CompileExpression(propowner);
+  }
+
+  if (m_compiledExpr->GetStatus() != CCompiledExpression::STATUS_COMPILED) {
+    return false;
+  }
+
+  const std::vector<std::string> &identifiers = m_compiledExpr->GetIdentifiers();
+  const unsigned int size = identifiers.size();
+  if (m_identifierKeys.size() != size) {
+    m_identifierKeys.resize(size);
+    m_identifierValues.resize(size);
+    for (unsigned int i = 0; i < size; ++i) {
+      if (identifiers[i].find('.') == std::string::npos) {
+        m_identifierKeys[i] = CPropertyKey(identifiers[i]);
+      }
+    }
+  }
+
+  // Same lookup as the identifiers of the expression tree.
+  for (unsigned int i = 0; i < size; ++i) {
+    CCompiledExpression::Value &value = m_identifierValues[i];
+    if (m_identifierKeys[i].IsValid()) {
+      CValue *prop = propowner->GetProperty(m_identifierKeys[i]);
+      if (!prop) {
+        return false;
+      }
+      value.Set(prop);
+    }
+    else {
+      CValue *prop = propowner->FindIdentifier(identifiers[i]);
+      value.Set(prop);
+      prop->Release();
+    }
+  }
+
+  CCompiledExpression::Value result;
+  if (!m_compiledExpr->Evaluate(m_identifierValues, m_evaluationStack, result)) {
+    return false;
+  }
+
+  CValue *oldprop = propowner->GetProperty(m_propkey);
+  if (oldprop) {
+    if (!result.AssignTo(oldprop)) {
+      CValue *newval = result.NewValue();
+      oldprop->SetValue(newval);
+      newval->Release();
+    }
+    propowner->PropertyModified(m_propkey);
+  }
+  else if (m_type == KX_ACT_PROP_ASSIGN) {
+    CValue *newval = result.NewValue();
+    propowner->SetProperty(m_propkey, newval);
+    newval->Release();
+  }
+
+  return true;
+}
+
 CValue *
 
 SCA_PropertyActuator::
@@ -218,6 +332,24 @@ void SCA_PropertyActuator::Relink(std::map<SCA_IObject *, SCA_IObject *> &obj_ma
 /* Python functions                                                          */
 /* ------------------------------------------------------------------------- */
 
+int SCA_PropertyActuator::CheckPropertyName(PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+  if (CheckProperty(self, attrdef) != 0) {
+    return 1;
+  }
+
+  SCA_PropertyActuator *actuator = static_cast<SCA_PropertyActuator *>(self);
+  actuator->m_propkey = CPropertyKey(actuator->m_propname);
+  actuator->ResetCompiledExpression();
+  return 0;
+}
+
+int SCA_PropertyActuator::CheckExpression(PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+  static_cast<SCA_PropertyActuator *>(self)->ResetCompiledExpression();
+  return 0;
+}
+
 /* Integration hooks ------------------------------------------------------- */
 PyTypeObject SCA_PropertyActuator::Type = {
     PyVarObject_HEAD_INIT(nullptr, 0) "SCA_PropertyActuator",
@@ -263,15 +395,22 @@ PyMethodDef SCA_PropertyActuator::Methods[] = {
 };
 
 PyAttributeDef SCA_PropertyActuator::Attributes[] = {
+    KX_PYATTRIBUTE_STRING_RW_CHECK("propName",
+                                   0,
+                                   MAX_PROP_NAME,
+                                   false,
+                                   SCA_PropertyActuator,
+                                   m_propname,
+                                   CheckPropertyName),
     KX_PYATTRIBUTE_STRING_RW_CHECK(
-        "propName", 0, MAX_PROP_NAME, false, SCA_PropertyActuator, m_propname, CheckProperty),
-    KX_PYATTRIBUTE_STRING_RW("value", 0, 100, false, SCA_PropertyActuator, m_exprtxt),
-    KX_PYATTRIBUTE_INT_RW("mode",
-                          KX_ACT_PROP_NODEF + 1,
-                          KX_ACT_PROP_MAX - 1,
-                          false,
-                          SCA_PropertyActuator,
-                          m_type), /* ATTR_TODO add constents to game logic dict */
+        "value", 0, 100, false, SCA_PropertyActuator, m_exprtxt, CheckExpression),
+    KX_PYATTRIBUTE_INT_RW_CHECK("mode",
+                                KX_ACT_PROP_NODEF + 1,
+                                KX_ACT_PROP_MAX - 1,
+                                false,
+                                SCA_PropertyActuator,
+                                m_type,
+                                CheckExpression), /* ATTR_TODO add constents to game logic dict */
     KX_PYATTRIBUTE_NULL            // Sentinel
 };
 
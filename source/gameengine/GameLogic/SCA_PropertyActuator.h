@@ -33,6 +33,9 @@
 #define __SCA_PROPERTYACTUATOR_H__
 
 #include "SCA_IActuator.h"
+#include "EXP_CompiledExpression.h"
+
+#include <memory>
 
 class SCA_PropertyActuator : public SCA_IActuator {
   Py_Header
@@ -49,8 +52,25 @@ class SCA_PropertyActuator : public SCA_IActuator {
 
   int m_type;
   std::string m_propname;
+  /// Key of m_propname resolved once.
+  CPropertyKey m_propkey;
   std::string m_exprtxt;
   SCA_IObject *m_sourceObj;  // for copy property actuator
+  /// Program of the assigned or added expression shared by the replicas of the actuator.
+  std::shared_ptr<CCompiledExpression> m_compiledExpr;
+  /// Keys of the identifiers of m_compiledExpr, invalid for the sub properties paths.
+  std::vector<CPropertyKey> m_identifierKeys;
+  /// Values of the identifiers passed to m_compiledExpr.
+  std::vector<CCompiledExpression::Value> m_identifierValues;
+  /// Evaluation stack of m_compiledExpr.
+  std::vector<CCompiledExpression::Value> m_evaluationStack;
+
+  /// Compile the expression of the assign or add mode into m_compiledExpr.
+  void CompileExpression(CValue *propowner);
+  /// Use a new program for this actuator once the expression, the property or the mode changed.
+  void ResetCompiledExpression();
+  /// Assign or add the compiled expression, return false if the expression tree must be used.
+  bool UpdateCompiledExpression(CValue *propowner);
 
  public:
   SCA_PropertyActuator(SCA_IObject *gameobj,
@@ -72,6 +92,13 @@ class SCA_PropertyActuator : public SCA_IActuator {
   /* --------------------------------------------------------------------- */
   /* Python interface ---------------------------------------------------- */
   /* --------------------------------------------------------------------- */
+
+#ifdef WITH_PYTHON
+  /// Check that the name is a property and update its key.
+  static int CheckPropertyName(PyObjectPlus *self, const PyAttributeDef *attrdef);
+  /// Compile again the expression after the change of the value or the mode.
+  static int CheckExpression(PyObjectPlus *self, const PyAttributeDef *attrdef);
+#endif
 };
 
 #endif /* __KX_PROPERTYACTUATOR_DOC */
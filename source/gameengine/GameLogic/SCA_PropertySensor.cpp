@@ -33,6 +33,7 @@
  */
 
 #include "SCA_PropertySensor.h"
+#include "SCA_TimeEventManager.h"
 #include "EXP_StringValue.h"
 #include "EXP_BoolValue.h"
 #include "EXP_FloatValue.h"
@@ -43,125 +44,212 @@
 
 #include <boost/algorithm/string.hpp>
 
-SCA_PropertySensor::SCA_PropertySensor(SCA_EventManager *eventmgr,
-                                       SCA_IObject *gameobj,
-                                       const std::string &propname,
-                                       const std::string &propval,
-                                       const std::string &propmaxval,
-                                       KX_PROPSENSOR_TYPE checktype)
-    : SCA_ISensor(gameobj, eventmgr),
-      m_checktype(checktype),
-      m_checkpropval(propval),
-      m_checkpropmaxval(propmaxval),
-      m_checkpropname(propname)
+/* ------------------------------------------------------------------------- */
+/* Batch functions                                                           */
+/* ------------------------------------------------------------------------- */
+
+SCA_PropertySensorBatch::SCA_PropertySensorBatch(int checktype,
+                                                 const std::string &propname,
+                                                 const std::string &propval,
+                                                 const std::string &propmaxval)
+    : m_checktype(checktype), m_checkpropval(propval), m_checkpropname(propname)
 {
-  // CParser pars;
-  // pars.SetContext(this->AddRef());
-  // CValue* resultval = m_rightexpr->Calculate();
+  // Paths to sub properties are still resolved by FindIdentifier.
+  if (m_checkpropname.find('.') == std::string::npos) {
+    m_checkpropkey = CPropertyKey(m_checkpropname);
+  }
 
-  CValue *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-  if (!orgprop->IsError()) {
-    m_previoustext = orgprop->GetText();
+  // An invalid text is parsed to zero.
+  m_checkfloatvalid = CM_StringTo(m_checkpropval, m_checkfloatval);
+  if (!m_checkfloatvalid) {
+    m_checkfloatval = 0.0f;
+  }
+  if (!CM_StringTo(propmaxval, m_checkmaxfloatval)) {
+    m_checkmaxfloatval = 0.0f;
   }
-  orgprop->Release();
+  m_checkfloattext = m_checkfloatvalid && (std::to_string(m_checkfloatval) == m_checkpropval);
 
-  Init();
+  m_checkintvalid = CM_StringTo(m_checkpropval, m_checkintval) &&
+                    (std::to_string(m_checkintval) == m_checkpropval);
+
+  const std::string upperval = boost::to_upper_copy(m_checkpropval);
+  if (upperval == CBoolValue::sTrueString) {
+    m_checkboolval = 1;
+  }
+  else if (upperval == CBoolValue::sFalseString) {
+    m_checkboolval = 0;
+  }
+  else {
+    m_checkboolval = -1;
+  }
 }
 
-void SCA_PropertySensor::Init()
+SCA_PropertySensorBatch::~SCA_PropertySensorBatch()
 {
-  m_recentresult = false;
-  m_lastresult = m_invert ? true : false;
-  m_reset = true;
 }
 
-CValue *SCA_PropertySensor::GetReplica()
+void SCA_PropertySensorBatch::AppendState(SCA_ISensor *sensor,
+                                          const SCA_SensorBatch *other,
+                                          unsigned int index)
 {
-  SCA_PropertySensor *replica = new SCA_PropertySensor(*this);
-  // m_range_expr must be recalculated on replica!
-  replica->ProcessReplica();
-  replica->Init();
+  m_parents.push_back(sensor->GetParent());
+
+  const SCA_PropertySensorBatch *batch = static_cast<const SCA_PropertySensorBatch *>(other);
+  if (batch) {
+    m_lastResults.push_back(batch->m_lastResults[index]);
+    m_recentResults.push_back(batch->m_recentResults[index]);
+    m_resets.push_back(batch->m_resets[index]);
+    m_previousTexts.push_back(batch->m_previousTexts[index]);
+    m_previousValues.push_back(batch->m_previousValues[index]);
+  }
+  else {
+    m_lastResults.push_back(false);
+    m_recentResults.push_back(false);
+    m_resets.push_back(true);
+    m_previousTexts.emplace_back();
+    m_previousValues.emplace_back();
+  }
+}
 
-  return replica;
+void SCA_PropertySensorBatch::MoveState(unsigned int from, unsigned int to)
+{
+  m_parents[to] = m_parents[from];
+  m_lastResults[to] = m_lastResults[from];
+  m_recentResults[to] = m_recentResults[from];
+  m_resets[to] = m_resets[from];
+  m_previousTexts[to] = std::move(m_previousTexts[from]);
+  m_previousValues[to] = m_previousValues[from];
 }
 
-bool SCA_PropertySensor::IsPositiveTrigger()
+void SCA_PropertySensorBatch::PopState()
 {
-  bool result = m_recentresult;  // CheckPropertyCondition();
-  if (m_invert)
-    result = !result;
+  m_parents.pop_back();
+  m_lastResults.pop_back();
+  m_recentResults.pop_back();
+  m_resets.pop_back();
+  m_previousTexts.pop_back();
+  m_previousValues.pop_back();
+}
 
-  return result;
+void SCA_PropertySensorBatch::Evaluate()
+{
+  for (unsigned int i = 0, size = m_sensors.size(); i < size; ++i) {
+    if (m_states[i] == STATE_EVALUATED) {
+      m_results[i] = EvaluateSensor(i);
+    }
+  }
 }
 
-SCA_PropertySensor::~SCA_PropertySensor()
+void SCA_PropertySensorBatch::Init(unsigned int index, bool invert)
 {
+  m_recentResults[index] = false;
+  m_lastResults[index] = invert;
+  m_resets[index] = true;
 }
 
-bool SCA_PropertySensor::Evaluate()
+void SCA_PropertySensorBatch::InitPreviousValue(unsigned int index)
+{
+  CValue *orgprop = FindCheckProperty(index);
+  if (orgprop) {
+    m_previousTexts[index] = orgprop->GetText();
+    m_previousValues[index].Set(orgprop);
+    orgprop->Release();
+  }
+}
+
+void SCA_PropertySensorBatch::SetParent(unsigned int index, SCA_IObject *parent)
+{
+  m_parents[index] = parent;
+}
+
+unsigned char SCA_PropertySensorBatch::EvaluateSensor(unsigned int index)
 {
-  bool result = CheckPropertyCondition();
-  bool reset = m_reset && m_level;
+  const bool result = CheckPropertyCondition(index);
 
-  m_reset = false;
-  if (m_lastresult != result) {
-    m_lastresult = result;
-    return true;
+  unsigned char flags = 0;
+  if (m_lastResults[index] != result) {
+    m_lastResults[index] = result;
+    flags |= RESULT_CHANGED;
   }
-  return (reset) ? true : false;
+  if (m_resets[index]) {
+    flags |= RESULT_RESET;
+  }
+  if (result) {
+    flags |= RESULT_POSITIVE;
+  }
+  m_resets[index] = false;
+
+  if (IsIdle(index)) {
+    flags |= RESULT_IDLE;
+  }
+
+  return flags;
 }
 
-bool SCA_PropertySensor::CheckPropertyCondition()
+bool SCA_PropertySensorBatch::CheckPropertyCondition(unsigned int index)
 {
-  m_recentresult = false;
   bool result = false;
   bool reverse = false;
   switch (m_checktype) {
-    case KX_PROPSENSOR_NOTEQUAL:
+    case SCA_PropertySensor::KX_PROPSENSOR_NOTEQUAL:
       reverse = true;
       ATTR_FALLTHROUGH;
-    case KX_PROPSENSOR_EQUAL: {
-      CValue *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
-        const std::string &testprop = orgprop->GetText();
-        // Force strings to upper case, to avoid confusion in
-        // bool tests. It's stupid the prop's identity is lost
-        // on the way here...
-        if ((testprop == CBoolValue::sTrueString) || (testprop == CBoolValue::sFalseString)) {
-          boost::to_upper(m_checkpropval);
-        }
-        result = (testprop == m_checkpropval);
-
-        /* Patch: floating point values cant use strings usefully since you can have "0.0" ==
-         * "0.0000" this could be made into a generic Value class function for comparing values
-         * with a string.
-         */
-        if (result == false && (orgprop->GetValueType() == VALUE_FLOAT_TYPE)) {
-          float f;
-          if (CM_StringTo(m_checkpropval, f)) {
-            result = (f == ((CFloatValue *)orgprop)->GetFloat());
+    case SCA_PropertySensor::KX_PROPSENSOR_EQUAL: {
+      CValue *orgprop = FindCheckProperty(index);
+      if (orgprop) {
+        /* The values are compared as if the property was converted to text, using the value
+         * parsed once instead of formatting the property. The boolean texts are compared
+         * ignoring the case and the floats are also compared to the parsed value as "0.0" is
+         * not the text of a zero float. */
+        switch (orgprop->GetValueType()) {
+          case VALUE_BOOL_TYPE: {
+            result = (m_checkboolval == (int)static_cast<CBoolValue *>(orgprop)->GetBool());
+            break;
+          }
+          case VALUE_INT_TYPE: {
+            result = (m_checkintvalid &&
+                      m_checkintval == static_cast<CIntValue *>(orgprop)->GetInt());
+            break;
+          }
+          case VALUE_FLOAT_TYPE: {
+            const float value = static_cast<CFloatValue *>(orgprop)->GetFloat();
+            result = (m_checkfloatvalid && m_checkfloatval == value) ||
+                     (m_checkfloattext && orgprop->GetText() == m_checkpropval);
+            break;
+          }
+          case VALUE_STRING_TYPE: {
+            CStringValue *strprop = static_cast<CStringValue *>(orgprop);
+            if (strprop->IsEqual(CBoolValue::sTrueString)) {
+              result = (m_checkboolval == 1);
+            }
+            else if (strprop->IsEqual(CBoolValue::sFalseString)) {
+              result = (m_checkboolval == 0);
+            }
+            else {
+              result = strprop->IsEqual(m_checkpropval);
+            }
+            break;
+          }
+          default: {
+            result = (orgprop->GetText() == m_checkpropval);
+            break;
           }
         }
-        /* end patch */
+        orgprop->Release();
       }
-      orgprop->Release();
 
       if (reverse)
         result = !result;
       break;
     }
 
-    case KX_PROPSENSOR_EXPRESSION: {
+    case SCA_PropertySensor::KX_PROPSENSOR_EXPRESSION: {
       break;
     }
-    case KX_PROPSENSOR_INTERVAL: {
-      CValue *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
-        float min;
-        float max;
+    case SCA_PropertySensor::KX_PROPSENSOR_INTERVAL: {
+      CValue *orgprop = FindCheckProperty(index);
+      if (orgprop) {
         float val;
-        CM_StringTo(m_checkpropval, min);
-        CM_StringTo(m_checkpropmaxval, max);
 
         if (orgprop->GetValueType() == VALUE_STRING_TYPE) {
           CM_StringTo(orgprop->GetText(), val);
@@ -170,33 +258,48 @@ bool SCA_PropertySensor::CheckPropertyCondition()
           val = orgprop->GetNumber();
         }
 
-        result = (min <= val) && (val <= max);
+        result = (m_checkfloatval <= val) && (val <= m_checkmaxfloatval);
+        orgprop->Release();
       }
-      orgprop->Release();
 
       break;
     }
-    case KX_PROPSENSOR_CHANGED: {
-      CValue *orgprop = GetParent()->FindIdentifier(m_checkpropname);
+    case SCA_PropertySensor::KX_PROPSENSOR_CHANGED: {
+      CValue *orgprop = FindCheckProperty(index);
+      if (orgprop) {
+        // The property is only converted to text when its value is not the previous one.
+        CCompiledExpression::Value value;
+        bool modified;
+        if (value.Set(orgprop)) {
+          modified = !value.IsIdentical(m_previousValues[index]);
+        }
+        else if (orgprop->GetValueType() == VALUE_STRING_TYPE) {
+          modified = !static_cast<CStringValue *>(orgprop)->IsEqual(m_previousTexts[index]);
+        }
+        else {
+          modified = true;
+        }
 
-      if (!orgprop->IsError()) {
-        if (m_previoustext != orgprop->GetText()) {
-          m_previoustext = orgprop->GetText();
-          result = true;
+        if (modified) {
+          const std::string text = orgprop->GetText();
+          if (m_previousTexts[index] != text) {
+            m_previousTexts[index] = text;
+            result = true;
+          }
+          m_previousValues[index] = value;
         }
+        orgprop->Release();
       }
-      orgprop->Release();
 
       break;
     }
-    case KX_PROPSENSOR_LESSTHAN:
+    case SCA_PropertySensor::KX_PROPSENSOR_LESSTHAN:
       reverse = true;
       ATTR_FALLTHROUGH;
-    case KX_PROPSENSOR_GREATERTHAN: {
-      CValue *orgprop = GetParent()->FindIdentifier(m_checkpropname);
-      if (!orgprop->IsError()) {
-        float ref;
-        CM_StringTo(m_checkpropval, ref);
+    case SCA_PropertySensor::KX_PROPSENSOR_GREATERTHAN: {
+      CValue *orgprop = FindCheckProperty(index);
+      if (orgprop) {
+        const float ref = m_checkfloatval;
         float val;
 
         if (orgprop->GetValueType() == VALUE_STRING_TYPE) {
@@ -212,8 +315,8 @@ bool SCA_PropertySensor::CheckPropertyCondition()
         else {
           result = val > ref;
         }
+        orgprop->Release();
       }
-      orgprop->Release();
 
       break;
     }
@@ -222,16 +325,145 @@ bool SCA_PropertySensor::CheckPropertyCondition()
 
   // the concept of Edge and Level triggering has unwanted effect for KX_PROPSENSOR_CHANGED
   // see Game Engine bugtracker [ #3809 ]
-  m_recentresult = result;
+  m_recentResults[index] = result;
+
+  return result;
+}
+
+bool SCA_PropertySensorBatch::IsIdle(unsigned int index) const
+{
+  // The sub properties are not notified and a change is reset at the next evaluation.
+  if (!m_checkpropkey.IsValid() || m_resets[index] ||
+      (m_checktype == SCA_PropertySensor::KX_PROPSENSOR_CHANGED && m_recentResults[index])) {
+    return false;
+  }
+
+  CValue *prop = m_parents[index]->GetProperty(m_checkpropkey);
+  // The timers are modified in place by the time event manager without notification.
+  return (!prop || !prop->GetProperty(SCA_TimeEventManager::sTimerKey));
+}
+
+bool SCA_PropertySensorBatch::GetRecentResult(unsigned int index) const
+{
+  return m_recentResults[index];
+}
+
+const CPropertyKey &SCA_PropertySensorBatch::GetCheckPropertyKey() const
+{
+  return m_checkpropkey;
+}
+
+CValue *SCA_PropertySensorBatch::FindCheckProperty(unsigned int index) const
+{
+  SCA_IObject *parent = m_parents[index];
+  if (m_checkpropkey.IsValid()) {
+    CValue *prop = parent->GetProperty(m_checkpropkey);
+    return prop ? prop->AddRef() : nullptr;
+  }
+
+  CValue *prop = parent->FindIdentifier(m_checkpropname);
+  if (prop->IsError()) {
+    prop->Release();
+    return nullptr;
+  }
+  return prop;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Native functions                                                          */
+/* ------------------------------------------------------------------------- */
+
+SCA_PropertySensor::SCA_PropertySensor(SCA_EventManager *eventmgr,
+                                       SCA_IObject *gameobj,
+                                       const std::string &propname,
+                                       const std::string &propval,
+                                       const std::string &propmaxval,
+                                       KX_PROPSENSOR_TYPE checktype)
+    : SCA_ISensor(gameobj, eventmgr),
+      m_checktype(checktype),
+      m_checkpropval(propval),
+      m_checkpropmaxval(propmaxval),
+      m_checkpropname(propname)
+{
+  // CParser pars;
+  // pars.SetContext(this->AddRef());
+  // CValue* resultval = m_rightexpr->Calculate();
+
+  ResetBatch();
+  GetPropertyBatch()->InitPreviousValue(m_batchIndex);
+
+  Init();
+}
+
+SCA_PropertySensorBatch *SCA_PropertySensor::GetPropertyBatch() const
+{
+  return static_cast<SCA_PropertySensorBatch *>(m_batch.get());
+}
+
+void SCA_PropertySensor::Init()
+{
+  GetPropertyBatch()->Init(m_batchIndex, m_invert);
+}
+
+CValue *SCA_PropertySensor::GetReplica()
+{
+  SCA_PropertySensor *replica = new SCA_PropertySensor(*this);
+  // m_range_expr must be recalculated on replica!
+  replica->ProcessReplica();
+  replica->Init();
+
+  return replica;
+}
+
+void SCA_PropertySensor::ReParent(SCA_IObject *parent)
+{
+  SCA_ISensor::ReParent(parent);
+  GetPropertyBatch()->SetParent(m_batchIndex, parent);
+}
+
+bool SCA_PropertySensor::IsPositiveTrigger()
+{
+  bool result = GetPropertyBatch()->GetRecentResult(m_batchIndex);
+  if (m_invert)
+    result = !result;
 
   return result;
 }
 
+SCA_PropertySensor::~SCA_PropertySensor()
+{
+}
+
+bool SCA_PropertySensor::Evaluate()
+{
+  const unsigned char result = GetPropertyBatch()->EvaluateSensor(m_batchIndex);
+  return (result & SCA_SensorBatch::RESULT_CHANGED) ||
+         ((result & SCA_SensorBatch::RESULT_RESET) && m_level);
+}
+
+bool SCA_PropertySensor::IsIdle()
+{
+  return GetPropertyBatch()->IsIdle(m_batchIndex);
+}
+
+void SCA_PropertySensor::ParentPropertyModified(const CPropertyKey &key)
+{
+  if (!key.IsValid() || key == GetPropertyBatch()->GetCheckPropertyKey()) {
+    Wake();
+  }
+}
+
 CValue *SCA_PropertySensor::FindIdentifier(const std::string &identifiername)
 {
   return GetParent()->FindIdentifier(identifiername);
 }
 
+SCA_SensorBatch *SCA_PropertySensor::NewBatch()
+{
+  return new SCA_PropertySensorBatch(
+      m_checktype, m_checkpropname, m_checkpropval, m_checkpropmaxval);
+}
+
 #ifdef WITH_PYTHON
 
 /* ------------------------------------------------------------------------- */
@@ -245,6 +477,30 @@ int SCA_PropertySensor::validValueForProperty(PyObjectPlus *self, const PyAttrib
    * function directly */
 
   /*  There is no type checking at this moment, unfortunately...           */
+  SCA_PropertySensor *sensor = static_cast<SCA_PropertySensor *>(self);
+  sensor->ResetBatch();
+  sensor->Wake();
+  return 0;
+}
+
+int SCA_PropertySensor::CheckPropertyName(PyObjectPlus *self, const PyAttributeDef *attrdef)
+{
+  if (CheckProperty(self, attrdef) != 0) {
+    return 1;
+  }
+
+  SCA_PropertySensor *sensor = static_cast<SCA_PropertySensor *>(self);
+  sensor->ResetBatch();
+  sensor->Wake();
+  return 0;
+}
+
+int SCA_PropertySensor::pyattr_check_parameters(PyObjectPlus *self_v,
+                                                const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  SCA_PropertySensor *self = static_cast<SCA_PropertySensor *>(self_v);
+  self->ResetBatch();
+  self->Wake();
   return 0;
 }
 
@@ -292,14 +548,20 @@ PyMethodDef SCA_PropertySensor::Methods[] = {
 };
 
 PyAttributeDef SCA_PropertySensor::Attributes[] = {
-    KX_PYATTRIBUTE_INT_RW("mode",
-                          KX_PROPSENSOR_NODEF,
-                          KX_PROPSENSOR_MAX - 1,
-                          false,
-                          SCA_PropertySensor,
-                          m_checktype),
-    KX_PYATTRIBUTE_STRING_RW_CHECK(
-        "propName", 0, MAX_PROP_NAME, false, SCA_PropertySensor, m_checkpropname, CheckProperty),
+    KX_PYATTRIBUTE_INT_RW_CHECK("mode",
+                                KX_PROPSENSOR_NODEF,
+                                KX_PROPSENSOR_MAX - 1,
+                                false,
+                                SCA_PropertySensor,
+                                m_checktype,
+                                pyattr_check_parameters),
+    KX_PYATTRIBUTE_STRING_RW_CHECK("propName",
+                                   0,
+                                   MAX_PROP_NAME,
+                                   false,
+                                   SCA_PropertySensor,
+                                   m_checkpropname,
+                                   CheckPropertyName),
     KX_PYATTRIBUTE_STRING_RW_CHECK(
         "value", 0, 100, false, SCA_PropertySensor, m_checkpropval, validValueForProperty),
     KX_PYATTRIBUTE_STRING_RW_CHECK(
@@ -34,6 +34,67 @@
 #define __SCA_PROPERTYSENSOR_H__
 
 #include "SCA_ISensor.h"
+#include "SCA_SensorBatch.h"
+#include "EXP_CompiledExpression.h"
+
+/// Property sensors checking a same property with the same mode and values.
+class SCA_PropertySensorBatch : public SCA_SensorBatch {
+ private:
+  const int m_checktype;
+  const std::string m_checkpropval;
+  const std::string m_checkpropname;
+  /// Key of m_checkpropname, invalid if the name is a path to a sub property.
+  CPropertyKey m_checkpropkey;
+  /// The checked values parsed once for the typed comparisons.
+  float m_checkfloatval;
+  float m_checkmaxfloatval;
+  bool m_checkfloatvalid;
+  /// True if m_checkpropval could be the text of a float property.
+  bool m_checkfloattext;
+  cInt m_checkintval;
+  /// True if m_checkpropval is the text of m_checkintval.
+  bool m_checkintvalid;
+  /// 1 or 0 if m_checkpropval is a boolean text ignoring the case, -1 otherwise.
+  int m_checkboolval;
+
+  std::vector<SCA_IObject *> m_parents;
+  std::vector<unsigned char> m_lastResults;
+  std::vector<unsigned char> m_recentResults;
+  std::vector<unsigned char> m_resets;
+  /// Text of the property at the previous evaluation.
+  std::vector<std::string> m_previousTexts;
+  /// Value of the previous text, VALUE_NO_TYPE if the property is not a number or a boolean.
+  std::vector<CCompiledExpression::Value> m_previousValues;
+
+  /// Return a new reference to the checked property of a sensor or nullptr if not found.
+  CValue *FindCheckProperty(unsigned int index) const;
+  bool CheckPropertyCondition(unsigned int index);
+
+ protected:
+  virtual void AppendState(SCA_ISensor *sensor,
+                           const SCA_SensorBatch *other,
+                           unsigned int index);
+  virtual void MoveState(unsigned int from, unsigned int to);
+  virtual void PopState();
+  virtual void Evaluate();
+
+ public:
+  SCA_PropertySensorBatch(int checktype,
+                          const std::string &propname,
+                          const std::string &propval,
+                          const std::string &propmaxval);
+  virtual ~SCA_PropertySensorBatch();
+
+  void Init(unsigned int index, bool invert);
+  /// Use the current value of the checked property as the previous value.
+  void InitPreviousValue(unsigned int index);
+  void SetParent(unsigned int index, SCA_IObject *parent);
+  /// Evaluate a sensor and return the flags of SCA_SensorBatch::Result.
+  unsigned char EvaluateSensor(unsigned int index);
+  bool IsIdle(unsigned int index) const;
+  bool GetRecentResult(unsigned int index) const;
+  const CPropertyKey &GetCheckPropertyKey() const;
+};
 
 class SCA_PropertySensor : public SCA_ISensor {
   Py_Header
@@ -42,11 +103,9 @@ class SCA_PropertySensor : public SCA_ISensor {
   std::string m_checkpropval;
   std::string m_checkpropmaxval;
   std::string m_checkpropname;
-  std::string m_previoustext;
-  bool m_lastresult;
-  bool m_recentresult;
 
- protected:
+  SCA_PropertySensorBatch *GetPropertyBatch() const;
+
  public:
   enum KX_PROPSENSOR_TYPE {
     KX_PROPSENSOR_NODEF = 0,
@@ -71,12 +130,16 @@ class SCA_PropertySensor : public SCA_ISensor {
 
   virtual ~SCA_PropertySensor();
   virtual CValue *GetReplica();
+  virtual void ReParent(SCA_IObject *parent);
   virtual void Init();
-  bool CheckPropertyCondition();
 
   virtual bool Evaluate();
   virtual bool IsPositiveTrigger();
+  /// The sensor is woken when the checked property is modified.
+  virtual bool IsIdle();
+  virtual void ParentPropertyModified(const CPropertyKey &key);
   virtual CValue *FindIdentifier(const std::string &identifiername);
+  virtual SCA_SensorBatch *NewBatch();
 
 #ifdef WITH_PYTHON
 
@@ -89,6 +152,11 @@ class SCA_PropertySensor : public SCA_ISensor {
    */
   static int validValueForProperty(PyObjectPlus *self, const PyAttributeDef *);
 
+  /// Check that the name is a property and update its key.
+  static int CheckPropertyName(PyObjectPlus *self, const PyAttributeDef *attrdef);
+  /// Move the sensor to a batch of its new mode.
+  static int pyattr_check_parameters(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
+
 #endif
 };
 
@@ -47,6 +47,7 @@ extern "C" {
 }
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
 // initialize static member variables
 SCA_PythonController *SCA_PythonController::m_sCurrentController = nullptr;
@@ -60,10 +61,13 @@ SCA_PythonController::SCA_PythonController(SCA_IObject *gameobj, int mode)
       m_function_argc(0),
       m_bModified(true),
       m_debug(false),
+      m_useFunction(false),
       m_mode(mode)
 #ifdef WITH_PYTHON
       ,
-      m_pythondictionary(nullptr)
+      m_pythondictionary(nullptr),
+      m_executionDictionary(nullptr),
+      m_scriptFunction(nullptr)
 #endif
 
 {
@@ -75,12 +79,17 @@ SCA_PythonController::~SCA_PythonController()
 #ifdef WITH_PYTHON
   Py_XDECREF(m_bytecode);
   Py_XDECREF(m_function);
+  Py_XDECREF(m_scriptFunction);
 
   if (m_pythondictionary) {
     // break any circular references in the dictionary
     PyDict_Clear(m_pythondictionary);
     Py_DECREF(m_pythondictionary);
   }
+
+  /* Not cleared, the functions defined by the script can still be used from elsewhere and
+   * reference it, the cycles are freed by the garbage collector. */
+  Py_XDECREF(m_executionDictionary);
 #endif
 }
 
@@ -100,6 +109,10 @@ CValue *SCA_PythonController::GetReplica()
   if (m_pythondictionary)
     replica->m_pythondictionary = PyDict_Copy(m_pythondictionary);
 
+  // The replica runs the shared bytecode in its own namespace.
+  replica->m_executionDictionary = nullptr;
+  replica->m_scriptFunction = nullptr;
+
 #  if 0
 	// The other option is to incref the replica->m_pythondictionary -
 	// the replica objects can then share data.
@@ -253,6 +266,49 @@ void SCA_PythonController::ErrorPrint(const char *error_msg)
   PyErr_Clear(); /* just to be sure */
 }
 
+/// Name of the function defined by the scripts compiled as a function body.
+#define SCRIPT_FUNCTION_NAME "__script__"
+
+/** Compile a script into a module defining a function running the script.
+ * The parsed script is moved into the body of a parsed empty function so that the line numbers
+ * of the script are kept in the tracebacks.
+ */
+static PyObject *compile_script_function(const std::string &text, const std::string &name)
+{
+  PyObject *ast = PyImport_ImportModule("ast");
+  PyObject *builtins = PyImport_ImportModule("builtins");
+  if (!ast || !builtins) {
+    Py_XDECREF(ast);
+    Py_XDECREF(builtins);
+    return nullptr;
+  }
+
+  PyObject *code = nullptr;
+  PyObject *tree = PyObject_CallMethod(ast, "parse", "ss", text.c_str(), name.c_str());
+  PyObject *functionTree = PyObject_CallMethod(
+      ast, "parse", "s", "def " SCRIPT_FUNCTION_NAME "():\n    pass\n");
+  PyObject *body = tree ? PyObject_GetAttrString(tree, "body") : nullptr;
+  PyObject *functionBody = functionTree ? PyObject_GetAttrString(functionTree, "body") : nullptr;
+
+  if (body && functionBody && PyList_Check(body) && PyList_Check(functionBody)) {
+    PyObject *function = PyList_GET_ITEM(functionBody, 0);
+    // An empty script keeps the pass statement.
+    if ((PyList_GET_SIZE(body) == 0 || PyObject_SetAttrString(function, "body", body) == 0) &&
+        PyObject_SetAttrString(tree, "body", functionBody) == 0) {
+      code = PyObject_CallMethod(builtins, "compile", "Oss", tree, name.c_str(), "exec");
+    }
+  }
+
+  Py_XDECREF(body);
+  Py_XDECREF(functionBody);
+  Py_XDECREF(tree);
+  Py_XDECREF(functionTree);
+  Py_DECREF(builtins);
+  Py_DECREF(ast);
+
+  return code;
+}
+
 bool SCA_PythonController::Compile()
 {
   m_bModified = false;
@@ -262,11 +318,30 @@ bool SCA_PythonController::Compile()
     Py_DECREF(m_bytecode);
     m_bytecode = nullptr;
   }
+  Py_CLEAR(m_scriptFunction);
+
+  // The controllers running the same text share its bytecode.
+  const std::string key = (m_useFunction ? "F" : "S") + m_scriptName + '\0' + m_scriptText;
+  if (m_logicManager) {
+    m_bytecode = m_logicManager->FindScriptBytecode(key);
+    if (m_bytecode) {
+      Py_INCREF(m_bytecode);
+      return true;
+    }
+  }
 
   // recompile the scripttext into bytecode
-  m_bytecode = Py_CompileString(m_scriptText.c_str(), m_scriptName.c_str(), Py_file_input);
+  if (m_useFunction) {
+    m_bytecode = compile_script_function(m_scriptText, m_scriptName);
+  }
+  else {
+    m_bytecode = Py_CompileString(m_scriptText.c_str(), m_scriptName.c_str(), Py_file_input);
+  }
 
   if (m_bytecode) {
+    if (m_logicManager) {
+      m_logicManager->RegisterScriptBytecode(key, m_bytecode);
+    }
     return true;
   }
   else {
@@ -275,6 +350,29 @@ bool SCA_PythonController::Compile()
   }
 }
 
+void SCA_PythonController::ResetExecutionDictionary()
+{
+  // A kept namespace was emptied after the previous run.
+  if (m_executionDictionary) {
+    PyDict_Update(m_executionDictionary, m_pythondictionary);
+  }
+  else {
+    m_executionDictionary = PyDict_Copy(m_pythondictionary);
+  }
+}
+
+void SCA_PythonController::ReleaseExecutionDictionary()
+{
+  /* When anything else references the namespace, e.g. a function or a class defined by the
+   * script, it is left to them and a new namespace is used at the next run. */
+  if (Py_REFCNT(m_executionDictionary) == 1) {
+    PyDict_Clear(m_executionDictionary);
+  }
+  else {
+    Py_CLEAR(m_executionDictionary);
+  }
+}
+
 bool SCA_PythonController::Import()
 {
   m_bModified = false;
@@ -358,9 +456,10 @@ bool SCA_PythonController::Import()
 
 void SCA_PythonController::Trigger(SCA_LogicManager *logicmgr)
 {
+  CM_ProfileScope profileScope("python", this);
+
   m_sCurrentController = this;
 
-  PyObject *excdict = nullptr;
   PyObject *resultobj = nullptr;
 
   switch (m_mode) {
@@ -372,21 +471,18 @@ void SCA_PythonController::Trigger(SCA_LogicManager *logicmgr)
         return;
 
       /*
-       * This part here with excdict is a temporary patch
-       * to avoid python/gameengine crashes when python
-       * inadvertently holds references to game objects
-       * in global variables.
+       * The script is always run in a namespace only containing the
+       * default names, so that the variables of a previous run are
+       * not seen and python doesn't hold game object references.
        *
-       * The idea is always make a fresh dictionary, and
-       * destroy it right after it is used to make sure
-       * python won't hold any gameobject references.
+       * Instead of copying the default namespace at each run, the
+       * namespace is emptied after the run and reused when nothing
+       * else references it. Else the functions defined by the script
+       * keep it as their globals and a fresh namespace is made.
        *
-       * Note that the PyDict_Clear _is_ necessary before
-       * the Py_DECREF() because it is possible for the
-       * variables inside the dictionary to hold references
-       * to the dictionary (ie. generate a cycle), so we
-       * break it by hand, then DECREF (which in this case
-       * should always ensure excdict is cleared).
+       * With m_useFunction the script is the body of a function
+       * defined once in its own namespace, its variables are local
+       * to each call and the namespace is kept.
        */
 
       if (!m_pythondictionary) {
@@ -399,9 +495,29 @@ void SCA_PythonController::Trigger(SCA_LogicManager *logicmgr)
         Py_DECREF(value);
       }
 
-      excdict = PyDict_Copy(m_pythondictionary);
-
-      resultobj = PyEval_EvalCode((PyObject *)m_bytecode, excdict, excdict);
+      if (m_useFunction) {
+        if (!m_scriptFunction) {
+          // A recompiled script gets a new namespace, the previous one can still be used.
+          Py_CLEAR(m_executionDictionary);
+          ResetExecutionDictionary();
+          PyObject *ret = PyEval_EvalCode(
+              (PyObject *)m_bytecode, m_executionDictionary, m_executionDictionary);
+          if (ret) {
+            Py_DECREF(ret);
+            m_scriptFunction = PyDict_GetItemString(m_executionDictionary, SCRIPT_FUNCTION_NAME);
+            Py_XINCREF(m_scriptFunction);
+          }
+        }
+
+        if (m_scriptFunction) {
+          resultobj = PyObject_CallObject(m_scriptFunction, nullptr);
+        }
+      }
+      else {
+        ResetExecutionDictionary();
+        resultobj = PyEval_EvalCode(
+            (PyObject *)m_bytecode, m_executionDictionary, m_executionDictionary);
+      }
 
       /* PyRun_SimpleString(m_scriptText.Ptr()); */
       break;
@@ -433,13 +549,9 @@ void SCA_PythonController::Trigger(SCA_LogicManager *logicmgr)
   else
     ErrorPrint("Python script error");
 
-  if (excdict) /* Only for SCA_PYEXEC_SCRIPT types */
-  {
-    /* clear after PyErrPrint - seems it can be using
-     * something in this dictionary and crash? */
-    // This doesn't appear to be needed anymore
-    // PyDict_Clear(excdict);
-    Py_DECREF(excdict);
+  // After the error print which can use the namespace.
+  if (m_mode == SCA_PYEXEC_SCRIPT && !m_useFunction && m_executionDictionary) {
+    ReleaseExecutionDictionary();
   }
 
   m_triggeredSensors.clear();
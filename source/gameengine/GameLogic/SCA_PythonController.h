@@ -48,7 +48,8 @@ class SCA_PythonController : public SCA_IController {
 #endif
   int m_function_argc;
   bool m_bModified;
-  bool m_debug; /* use with SCA_PYEXEC_MODULE for reloading every logic run */
+  bool m_debug;       /* use with SCA_PYEXEC_MODULE for reloading every logic run */
+  bool m_useFunction; /* use with SCA_PYEXEC_SCRIPT to run the script as a function body */
   int m_mode;
 
  protected:
@@ -57,6 +58,15 @@ class SCA_PythonController : public SCA_IController {
 #ifdef WITH_PYTHON
   PyObject *m_pythondictionary; /* for SCA_PYEXEC_SCRIPT only */
   PyObject *m_pythonfunction;   /* for SCA_PYEXEC_MODULE only */
+  /// Namespace the script is run in, filled from m_pythondictionary and reused when possible.
+  PyObject *m_executionDictionary;
+  /// Function running the script when m_useFunction is set, defined in the execution namespace.
+  PyObject *m_scriptFunction;
+
+  /// Fill the execution namespace with the default names, creating it if needed.
+  void ResetExecutionDictionary();
+  /// Empty the execution namespace for a reuse or give it up if it is still referenced.
+  void ReleaseExecutionDictionary();
 #endif
   std::vector<class SCA_ISensor *> m_triggeredSensors;
 
@@ -82,6 +92,11 @@ class SCA_PythonController : public SCA_IController {
   {
     m_debug = debug;
   }
+  void SetUseFunction(bool useFunction)
+  {
+    m_useFunction = useFunction;
+    m_bModified = true;
+  }
   void AddTriggeredSensor(class SCA_ISensor *sensor)
   {
     m_triggeredSensors.push_back(sensor);
@@ -230,6 +230,7 @@ bool SCA_RandomActuator::Update()
   CValue *prop = GetParent()->GetProperty(m_propname);
   if (prop) {
     prop->SetValue(tmpval);
+    GetParent()->PropertyModified(CPropertyKey::Find(m_propname));
   }
   tmpval->Release();
 
@@ -0,0 +1,144 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file gameengine/GameLogic/SCA_SensorBatch.cpp
+ *  \ingroup gamelogic
+ */
+
+#include "SCA_SensorBatch.h"
+#include "SCA_ISensor.h"
+
+#include "BLI_assert.h"
+
+SCA_SensorBatch::SCA_SensorBatch() : m_eventmgr(nullptr), m_numRegistered(0)
+{
+}
+
+SCA_SensorBatch::~SCA_SensorBatch()
+{
+  BLI_assert(m_sensors.empty());
+}
+
+unsigned int SCA_SensorBatch::AddSensor(SCA_ISensor *sensor,
+                                        const SCA_SensorBatch *other,
+                                        unsigned int index)
+{
+  AppendState(sensor, other, index);
+  m_sensors.push_back(sensor);
+  m_states.push_back(STATE_UNREGISTERED);
+  m_results.push_back(0);
+
+  return m_sensors.size() - 1;
+}
+
+void SCA_SensorBatch::RemoveSensor(unsigned int index)
+{
+  BLI_assert(m_states[index] == STATE_UNREGISTERED);
+
+  const unsigned int last = m_sensors.size() - 1;
+  if (index != last) {
+    MoveState(last, index);
+    m_sensors[index] = m_sensors[last];
+    m_states[index] = m_states[last];
+    m_results[index] = m_results[last];
+    m_sensors[index]->SetBatchIndex(index);
+  }
+
+  PopState();
+  m_sensors.pop_back();
+  m_states.pop_back();
+  m_results.pop_back();
+}
+
+SCA_EventManager *SCA_SensorBatch::GetEventManager() const
+{
+  return m_eventmgr;
+}
+
+bool SCA_SensorBatch::IsRegistered(unsigned int index) const
+{
+  return (m_states[index] != STATE_UNREGISTERED);
+}
+
+bool SCA_SensorBatch::RegisterSensor(unsigned int index, SCA_EventManager *eventmgr)
+{
+  BLI_assert(!m_eventmgr || m_eventmgr == eventmgr);
+
+  if (m_states[index] != STATE_UNREGISTERED) {
+    return false;
+  }
+
+  // A newly registered sensor is evaluated at least once.
+  m_states[index] = STATE_AWAKE;
+  m_eventmgr = eventmgr;
+  return (m_numRegistered++ == 0);
+}
+
+bool SCA_SensorBatch::UnregisterSensor(unsigned int index)
+{
+  if (m_states[index] == STATE_UNREGISTERED) {
+    return false;
+  }
+
+  m_states[index] = STATE_UNREGISTERED;
+  if (--m_numRegistered == 0) {
+    m_eventmgr = nullptr;
+    return true;
+  }
+  return false;
+}
+
+void SCA_SensorBatch::WakeSensor(unsigned int index)
+{
+  if (m_states[index] == STATE_SLEEPING) {
+    m_states[index] = STATE_AWAKE;
+  }
+}
+
+void SCA_SensorBatch::SleepSensor(unsigned int index)
+{
+  if (m_states[index] == STATE_AWAKE) {
+    m_states[index] = STATE_SLEEPING;
+  }
+}
+
+void SCA_SensorBatch::Activate(SCA_LogicManager *logicmgr)
+{
+  /* The sensors woken by the activation of an other sensor keep the awake state and are
+   * evaluated at the next activation. A suspended sensor can be awake after its registration
+   * or a batch change, it sleeps until resumed without being evaluated. */
+  const unsigned int size = m_sensors.size();
+  for (unsigned int i = 0; i < size; ++i) {
+    if (m_states[i] == STATE_AWAKE) {
+      m_states[i] = m_sensors[i]->IsSuspended() ? STATE_SLEEPING : STATE_EVALUATED;
+    }
+  }
+
+  Evaluate();
+
+  for (unsigned int i = 0; i < size; ++i) {
+    if (m_states[i] == STATE_EVALUATED) {
+      const bool sleep = m_sensors[i]->Activate(logicmgr, m_results[i]);
+      m_states[i] = sleep ? STATE_SLEEPING : STATE_AWAKE;
+    }
+  }
+}
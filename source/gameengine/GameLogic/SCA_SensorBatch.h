@@ -0,0 +1,117 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file SCA_SensorBatch.h
+ *  \ingroup gamelogic
+ */
+
+#ifndef __SCA_SENSORBATCH_H__
+#define __SCA_SENSORBATCH_H__
+
+#include <vector>
+
+class SCA_ISensor;
+class SCA_EventManager;
+class SCA_LogicManager;
+
+/** Sensors of a same template evaluated together by their event manager.
+ * A sensor and its replicas share a batch storing the state specific to their type in
+ * contiguous arrays, the batch evaluates all the awake sensors in one loop without calling
+ * their virtual functions and then only activates the sensors with their results.
+ * A sensor whose parameters are modified moves to a new batch, see SCA_ISensor::ResetBatch().
+ */
+class SCA_SensorBatch {
+ public:
+  /// Flags of the result of the evaluation of a sensor.
+  enum Result {
+    /// The condition of the sensor changed.
+    RESULT_CHANGED = (1 << 0),
+    /// The sensor was reset, a level sensor sends its state.
+    RESULT_RESET = (1 << 1),
+    /// The condition of the sensor is positive, before the inversion.
+    RESULT_POSITIVE = (1 << 2),
+    /// The condition doesn't change until the sensor is woken.
+    RESULT_IDLE = (1 << 3)
+  };
+
+ protected:
+  enum State {
+    /// The sensor is not registered to an event manager.
+    STATE_UNREGISTERED = 0,
+    STATE_SLEEPING,
+    STATE_AWAKE,
+    /// The sensor is evaluated by the current activation.
+    STATE_EVALUATED
+  };
+
+  std::vector<SCA_ISensor *> m_sensors;
+  /// State of each sensor.
+  std::vector<unsigned char> m_states;
+  /// Result of the last evaluation of each sensor.
+  std::vector<unsigned char> m_results;
+  /// Event manager of the registered sensors.
+  SCA_EventManager *m_eventmgr;
+  unsigned int m_numRegistered;
+
+  /** Append the state specific to the sensor type.
+   * \param sensor The added sensor.
+   * \param other The batch to copy the state from, nullptr to default initialize the state.
+   * \param index The index of the state in <other>.
+   */
+  virtual void AppendState(SCA_ISensor *sensor,
+                           const SCA_SensorBatch *other,
+                           unsigned int index) = 0;
+  /// Move the state of a sensor to a lower index.
+  virtual void MoveState(unsigned int from, unsigned int to) = 0;
+  virtual void PopState() = 0;
+  /// Evaluate the sensors in STATE_EVALUATED and set their results.
+  virtual void Evaluate() = 0;
+
+ public:
+  SCA_SensorBatch();
+  virtual ~SCA_SensorBatch();
+
+  /** Add a sensor and return its index.
+   * \param other The batch to copy the state from, nullptr to initialize the state.
+   * \param index The index of the state in <other>.
+   */
+  unsigned int AddSensor(SCA_ISensor *sensor, const SCA_SensorBatch *other, unsigned int index);
+  /// Remove an unregistered sensor, the last sensor takes its index.
+  void RemoveSensor(unsigned int index);
+
+  /// Return the event manager of the registered sensors or nullptr.
+  SCA_EventManager *GetEventManager() const;
+  bool IsRegistered(unsigned int index) const;
+  /// Register a sensor and return true if it's the first registered sensor.
+  bool RegisterSensor(unsigned int index, SCA_EventManager *eventmgr);
+  /// Unregister a sensor and return true if it was the last registered sensor.
+  bool UnregisterSensor(unsigned int index);
+  /// Evaluate again a registered sensor from the next activation.
+  void WakeSensor(unsigned int index);
+  /// Skip a registered sensor until it's woken.
+  void SleepSensor(unsigned int index);
+
+  /// Evaluate the awake sensors and activate them.
+  void Activate(SCA_LogicManager *logicmgr);
+};
+
+#endif  // __SCA_SENSORBATCH_H__
@@ -40,6 +40,8 @@
 #include "SCA_LogicManager.h"
 #include "EXP_FloatValue.h"
 
+const CPropertyKey SCA_TimeEventManager::sTimerKey("timer");
+
 SCA_TimeEventManager::SCA_TimeEventManager(SCA_LogicManager *logicmgr)
     : SCA_EventManager(nullptr, TIME_EVENTMGR)
 {
@@ -40,6 +40,9 @@ class SCA_TimeEventManager : public SCA_EventManager {
   std::vector<CValue *> m_timevalues;  // values that need their time updated regularly
 
  public:
+  /// Key of the sub property flagging the timer properties.
+  static const CPropertyKey sTimerKey;
+
   SCA_TimeEventManager(class SCA_LogicManager *logicmgr);
   virtual ~SCA_TimeEventManager();
 
@@ -83,6 +83,11 @@ void GPG_Canvas::Resize(int width, int height)
 
 void GPG_Canvas::MakeScreenShot(const std::string &filename)
 {
+  // Nothing is rendered without window.
+  if (!m_window) {
+    return;
+  }
+
   // copy image data
   unsigned int dumpsx = GetWidth();
   unsigned int dumpsy = GetHeight();
@@ -173,6 +178,12 @@ void GPG_Canvas::GetDisplayDimensions(int &width, int &height)
   unsigned int uiheight;
 
   GHOST_ISystem *system = GHOST_ISystem::getSystem();
+  if (!system) {
+    width = GetWidth();
+    height = GetHeight();
+    return;
+  }
+
   system->getMainDisplayDimensions(uiwidth, uiheight);
 
   width = uiwidth;
@@ -181,6 +192,11 @@ void GPG_Canvas::GetDisplayDimensions(int &width, int &height)
 
 void GPG_Canvas::ResizeWindow(int width, int height)
 {
+  if (!m_window) {
+    Resize(width, height);
+    return;
+  }
+
   if (m_window->getState() == GHOST_kWindowStateFullScreen) {
     GHOST_ISystem *system = GHOST_ISystem::getSystem();
     GHOST_DisplaySetting setting;
@@ -200,6 +216,10 @@ void GPG_Canvas::ResizeWindow(int width, int height)
 
 void GPG_Canvas::SetFullScreen(bool enable)
 {
+  if (!m_window) {
+    return;
+  }
+
   if (enable) {
     m_window->setState(GHOST_kWindowStateFullScreen);
   }
@@ -210,12 +230,18 @@ void GPG_Canvas::SetFullScreen(bool enable)
 
 bool GPG_Canvas::GetFullScreen()
 {
-  return (m_window->getState() == GHOST_kWindowStateFullScreen);
+  return (m_window && m_window->getState() == GHOST_kWindowStateFullScreen);
 }
 
 void GPG_Canvas::ConvertMousePosition(int x, int y, int &r_x, int &r_y, bool UNUSED(screen))
 {
-  m_window->screenToClient(x, y, r_x, r_y);
+  if (m_window) {
+    m_window->screenToClient(x, y, r_x, r_y);
+  }
+  else {
+    r_x = x;
+    r_y = y;
+  }
 }
 
 ARegion *GPG_Canvas::GetARegion()
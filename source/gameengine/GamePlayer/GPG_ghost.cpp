@@ -480,7 +480,7 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   }
   CM_Message(std::endl)
       CM_Message("usage:   " << program << " [--options] " << example_filename << std::endl);
-  CM_Message("Available options are: [-w [w h l t]] [-f [fw fh fb ff]] "
+  CM_Message("Available options are: [-w [w h l t]] [-f [fw fh fb ff]] [-b] "
              << consoleoption << "[-g gamengineoptions] "
              << "[-s stereomode] [-m aasamples]");
   CM_Message("Optional parameters must be passed in order.");
@@ -506,6 +506,9 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       Note: To define 'fw'' or 'fh'', both must be used.");
   CM_Message("       Example: -f  or  -f 1024 768  or  -f 0 0 16  or  -f 1024 728 16 30"
              << std::endl);
+  CM_Message("  -b: run headless, without window and render (server mode)");
+  CM_Message("       The logic, physics and animations are stepped at the logic tic rate.");
+  CM_Message("       Use -g fast_forward = 1 to step as fast as possible." << std::endl);
   CM_Message("  -s: start player in stereoscopy mode (requires 3D capable hardware)");
   CM_Message(
       "       stereomode: nostereo         (default unless stereo is set in the blend file)");
@@ -539,8 +542,11 @@ static void usage(const std::string &program, bool isBlenderPlayer)
   CM_Message("       show_camera_frustum            0         Show debug camera frustum volume");
   CM_Message(
       "       show_shadow_frustum            0         Show debug light shadow frustum volume");
-  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings"
-             << std::endl);
+  CM_Message("       ignore_deprecation_warnings    1         Ignore deprecation warnings");
+  CM_Message("       fast_forward                   0         Headless only, don't wait for"
+             << " the next logic frame");
+  CM_Message("       trace_file                               Save a profiling trace of the"
+             << " frames to this file" << std::endl);
   CM_Message("  -p: override python main loop script");
   CM_Message(std::endl);
   CM_Message(
@@ -713,6 +719,7 @@ int main(int argc,
   bool fullScreen = false;
   bool fullScreenParFound = false;
   bool windowParFound = false;
+  bool headless = false;
 #ifdef WIN32
   bool closeConsole = true;
 #endif
@@ -1076,6 +1083,12 @@ int main(int argc,
           }
           break;
         }
+        case 'b':  // headless, no window and no render
+        {
+          i++;
+          headless = true;
+          break;
+        }
         case 'h':  // display help
         {
           usage(argv[0], isBlenderPlayer);
@@ -1212,23 +1225,30 @@ int main(int argc,
     usage(argv[0], isBlenderPlayer);
     return 0;
   }
+  if (headless) {
+    // Match blender background mode, no GPU data is ever created or freed.
+    G.background = true;
+  }
+
   GHOST_ISystem *system = nullptr;
 #ifdef WIN32
   if (scr_saver_mode != SCREEN_SAVER_MODE_CONFIGURATION)
 #endif
   {
-    // Create the system
-    if (GHOST_ISystem::createSystem() == GHOST_kSuccess) {
-      system = GHOST_ISystem::getSystem();
-      BLI_assert(system);
-
-      if (!fullScreenWidth || !fullScreenHeight)
-        system->getMainDisplayDimensions(fullScreenWidth, fullScreenHeight);
-      // process first batch of events. If the user
-      // drops a file on top off the blenderplayer icon, we
-      // receive an event with the filename
-
-      system->processEvents(0);
+    // Create the system, headless mode runs without any GHOST and GPU objects.
+    if (headless || GHOST_ISystem::createSystem() == GHOST_kSuccess) {
+      if (!headless) {
+        system = GHOST_ISystem::getSystem();
+        BLI_assert(system);
+
+        if (!fullScreenWidth || !fullScreenHeight)
+          system->getMainDisplayDimensions(fullScreenWidth, fullScreenHeight);
+        // process first batch of events. If the user
+        // drops a file on top off the blenderplayer icon, we
+        // receive an event with the filename
+
+        system->processEvents(0);
+      }
 
       // this bracket is needed for app (see below) to get out
       // of scope before GHOST_ISystem::disposeSystem() is called.
@@ -1307,7 +1327,7 @@ int main(int argc,
             /* Setting options according to the blend file if not overriden in the command line */
 #ifdef WIN32
 #  if !defined(DEBUG)
-            if (closeConsole) {
+            if (closeConsole && system) {
               system->toggleConsole(0);  // Close a console window
             }
 #  endif  // !defined(DEBUG)
@@ -1390,7 +1410,15 @@ int main(int argc,
               aasamples = scene->gm.aasamples;
 
             BLI_strncpy(pathname, maggie->name, sizeof(pathname));
-            if (firstTimeRunning) {
+            if (firstTimeRunning && headless) {
+              firstTimeRunning = false;
+
+              /* wm context, without window */
+              wmWindowManager *wm = (wmWindowManager *)CTX_data_main(C)->wm.first;
+              CTX_wm_manager_set(C, wm);
+              wm->message_bus = WM_msgbus_create();
+            }
+            else if (firstTimeRunning) {
               firstTimeRunning = false;
 
               if (fullScreen) {
@@ -1499,7 +1527,9 @@ int main(int argc,
             }
             launcher.SetPythonGlobalDict(globalDict);
 #endif  // WITH_PYTHON
-            DRW_engines_register();
+            if (!headless) {
+              DRW_engines_register();
+            }
 
             launcher.InitEngine();
 
@@ -1524,7 +1554,9 @@ int main(int argc,
             }
             launcher.ExitEngine();
 
-            DRW_engines_free();
+            if (!headless) {
+              DRW_engines_free();
+            }
           }
         } while (!quitGame(exitcode));
       }
@@ -1566,7 +1598,9 @@ int main(int argc,
   BKE_vfont_clipboard_free();
   BKE_node_clipboard_free();
 
-  GPU_free_unused_buffers(G_MAIN);
+  if (!headless) {
+    GPU_free_unused_buffers(G_MAIN);
+  }
 
   BKE_blender_free(); /* blender.c, does entire library and spacetypes */
                       //  free_matcopybuf();
@@ -1588,11 +1622,13 @@ int main(int argc,
 
   BLF_exit();
 
-  DRW_opengl_context_enable_ex(false);
-  GPU_pass_cache_free();
-  GPU_exit();
-  DRW_opengl_context_disable_ex(false);
-  DRW_opengl_context_destroy();
+  if (!headless) {
+    DRW_opengl_context_enable_ex(false);
+    GPU_pass_cache_free();
+    GPU_exit();
+    DRW_opengl_context_disable_ex(false);
+    DRW_opengl_context_destroy();
+  }
 
   if (window) {
     system->disposeWindow(window);
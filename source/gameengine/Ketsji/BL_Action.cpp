@@ -31,11 +31,14 @@
 #include "KX_IpoConvert.h"
 #include "KX_GameObject.h"
 #include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
 
 #include "RAS_MeshObject.h"
 
 #include "SG_Controller.h"
 
+#include "CM_Thread.h"
+
 // These three are for getting the action from the logic manager
 #include "KX_Scene.h"
 #include "KX_BlenderConverter.h"
@@ -71,6 +74,10 @@ extern "C" {
 #include "BKE_library.h"
 #include "BKE_global.h"
 
+/* Actions are updated from several threads (see KX_Scene::UpdateAnimations),
+ * the depsgraph and the scene blender data they touch are shared between all objects. */
+static CM_ThreadMutex depsgraphMutex;
+
 BL_Action::BL_Action(class KX_GameObject *gameobj)
     : m_action(nullptr),
       m_blendpose(nullptr),
@@ -415,25 +422,28 @@ void BL_Action::Update(float curtime, bool applyToObject)
 
   m_requestIpo = true;
 
-  Depsgraph *depsgraph = CTX_data_expect_evaluated_depsgraph(KX_GetActiveEngine()->GetContext());
   Object *ob = m_obj->GetBlenderObject();  // eevee
 
   if (m_obj->GetGameObjectType() == SCA_IObject::OBJ_ARMATURE) {
-    DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
-
     // BKE_object_where_is_calc_time(depsgraph, sc, ob, m_localframe);
 
-    scene->ResetTaaSamples();
-
     BL_ArmatureObject *obj = (BL_ArmatureObject *)m_obj;
 
     if (m_layer_weight >= 0)
       obj->GetPose(&m_blendpose);
 
-    // Extract the pose from the action
-    obj->SetPoseByAction(m_action, m_localframe);
+    // Extract the pose from the action, the pose is owned by the object.
+    const bool useTable = ELEM(m_playmode, ACT_MODE_LOOP, ACT_MODE_PING_PONG) &&
+                          KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::BAKE_LOOP_ACTIONS);
+    obj->SetPoseByAction(m_action, m_localframe, useTable);
 
+    depsgraphMutex.Lock();
+    Depsgraph *depsgraph = CTX_data_expect_evaluated_depsgraph(
+        KX_GetActiveEngine()->GetContext());
+    DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM);
+    scene->ResetTaaSamples();
     ignore_parent_tx_bge(G_MAIN, depsgraph, scene, ob);
+    depsgraphMutex.Unlock();
 
     // Handle blending between armature actions
     if (m_blendin && m_blendframe < m_blendin) {
@@ -453,6 +463,11 @@ void BL_Action::Update(float curtime, bool applyToObject)
     obj->UpdateTimestep(curtime);
   }
   else {
+    // Non-armature actions are cheap and mostly touch shared data, don't bother splitting them.
+    depsgraphMutex.Lock();
+    Depsgraph *depsgraph = CTX_data_expect_evaluated_depsgraph(
+        KX_GetActiveEngine()->GetContext());
+
     /* WARNING: The check to be sure the right action is played (to know if the action
      * which is in the actuator will be the one which will be played)
      * might be wrong (if (ob->adt && ob->adt->action == m_action) playaction;)
@@ -563,6 +578,7 @@ void BL_Action::Update(float curtime, bool applyToObject)
         scene->ResetTaaSamples();
       }
     }
+    depsgraphMutex.Unlock();
   }
 }
 
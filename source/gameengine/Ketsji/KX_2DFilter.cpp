@@ -239,6 +239,12 @@ KX_PYMETHODDEF_DOC(KX_2DFilter, addOffScreen, " addOffScreen(slots, width, heigh
     return nullptr;
   }
 
+  if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS)) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "filter.addOffScreen(...): KX_2DFilter, not available in headless mode.");
+    return nullptr;
+  }
+
   if (GetFrameBuffer()) {
     PyErr_SetString(PyExc_TypeError,
                     "filter.addOffScreen(...): KX_2DFilter, custom off screen already exists.");
@@ -27,6 +27,8 @@
 #include "KX_2DFilterManager.h"
 #include "KX_2DFilter.h"
 #include "KX_2DFilterFrameBuffer.h"
+#include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
 
 #include "CM_Message.h"
 
@@ -121,6 +123,13 @@ KX_PYMETHODDEF_DOC(KX_2DFilterManager, addFilter, " addFilter(index, type, fragm
     return nullptr;
   }
 
+  if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS)) {
+    PyErr_SetString(PyExc_RuntimeError,
+                    "filterManager.addFilter(index, type, fragmentProgram): KX_2DFilterManager, "
+                    "not available in headless mode");
+    return nullptr;
+  }
+
   if (GetFilterPass(index)) {
     PyErr_Format(PyExc_ValueError,
                  "filterManager.addFilter(index, type, fragmentProgram): KX_2DFilterManager, "
@@ -0,0 +1,244 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_ActivityGrid.cpp
+ *  \ingroup ketsji
+ */
+
+#include "KX_ActivityGrid.h"
+#include "KX_GameObject.h"
+
+#include "EXP_ListValue.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+/// Factor of the activity radius over which the objects are suspended.
+#define KX_ACTIVITY_HYSTERESIS 1.1f
+/// Largest cell coordinate, leaves room for the neighbor cells without integer overflow.
+#define KX_ACTIVITY_MAX_CELL (INT_MAX / 2)
+
+/// Cell coordinate of a position component, far and invalid positions are clamped.
+static int get_cell_coordinate(float value, float cellSize)
+{
+  const float coord = std::floor(value / cellSize);
+  if (coord >= (float)KX_ACTIVITY_MAX_CELL) {
+    return KX_ACTIVITY_MAX_CELL;
+  }
+  // Also catches NaN coordinates.
+  if (!(coord > (float)-KX_ACTIVITY_MAX_CELL)) {
+    return -KX_ACTIVITY_MAX_CELL;
+  }
+  return (int)coord;
+}
+
+bool KX_ActivityGrid::CellKey::operator==(const CellKey &other) const
+{
+  return (m_x == other.m_x && m_y == other.m_y && m_z == other.m_z);
+}
+
+size_t KX_ActivityGrid::CellKeyHash::operator()(const CellKey &key) const
+{
+  return ((size_t)key.m_x * 73856093) ^ ((size_t)key.m_y * 19349663) ^
+         ((size_t)key.m_z * 83492791);
+}
+
+KX_ActivityGrid::KX_ActivityGrid() : m_cellSize(0.0f), m_cameraPosition(0.0f, 0.0f, 0.0f)
+{
+}
+
+KX_ActivityGrid::~KX_ActivityGrid()
+{
+}
+
+KX_ActivityGrid::CellKey KX_ActivityGrid::GetCell(const MT_Vector3 &position) const
+{
+  return {get_cell_coordinate(position[0], m_cellSize),
+          get_cell_coordinate(position[1], m_cellSize),
+          get_cell_coordinate(position[2], m_cellSize)};
+}
+
+void KX_ActivityGrid::InsertObject(KX_GameObject *gameobj, const CellKey &cell)
+{
+  std::vector<KX_GameObject *> &objects = m_cells[cell];
+  m_entries[gameobj] = {cell, (unsigned int)objects.size()};
+  objects.push_back(gameobj);
+}
+
+void KX_ActivityGrid::EraseObject(KX_GameObject *gameobj, const Entry &entry)
+{
+  CellMap::iterator cellit = m_cells.find(entry.m_cell);
+  std::vector<KX_GameObject *> &objects = cellit->second;
+
+  // Move the last object of the cell in place of the erased one.
+  KX_GameObject *last = objects.back();
+  if (last != gameobj) {
+    objects[entry.m_index] = last;
+    m_entries[last].m_index = entry.m_index;
+  }
+  objects.pop_back();
+
+  if (objects.empty()) {
+    m_cells.erase(cellit);
+  }
+}
+
+void KX_ActivityGrid::MoveObject(KX_GameObject *gameobj)
+{
+  const CellKey cell = GetCell(gameobj->NodeGetWorldPosition());
+
+  std::unordered_map<KX_GameObject *, Entry>::iterator it = m_entries.find(gameobj);
+  if (it == m_entries.end()) {
+    InsertObject(gameobj, cell);
+  }
+  else if (!(it->second.m_cell == cell)) {
+    const Entry entry = it->second;
+    EraseObject(gameobj, entry);
+    InsertObject(gameobj, cell);
+  }
+}
+
+void KX_ActivityGrid::UpdateActivity(KX_GameObject *gameobj, float radius) const
+{
+  if (gameobj->GetIgnoreActivityCulling()) {
+    return;
+  }
+
+  // Manhattan distance of the box.
+  const MT_Vector3 position = gameobj->NodeGetWorldPosition();
+  const float distance = std::max(std::max(std::fabs(m_cameraPosition[0] - position[0]),
+                                           std::fabs(m_cameraPosition[1] - position[1])),
+                                  std::fabs(m_cameraPosition[2] - position[2]));
+
+  if (distance <= radius) {
+    gameobj->ResumeDynamics();
+  }
+  else if (distance > m_cellSize) {
+    gameobj->SuspendDynamics();
+  }
+}
+
+void KX_ActivityGrid::UpdateNeighborCells(const CellKey &center,
+                                          const CellKey *skipCenter,
+                                          float radius) const
+{
+  for (int x = center.m_x - 1; x <= center.m_x + 1; ++x) {
+    for (int y = center.m_y - 1; y <= center.m_y + 1; ++y) {
+      for (int z = center.m_z - 1; z <= center.m_z + 1; ++z) {
+        // The cell was already updated as a neighbor of the other center.
+        if (skipCenter && std::abs(x - skipCenter->m_x) <= 1 &&
+            std::abs(y - skipCenter->m_y) <= 1 && std::abs(z - skipCenter->m_z) <= 1) {
+          continue;
+        }
+
+        const CellMap::const_iterator it = m_cells.find({x, y, z});
+        if (it == m_cells.end()) {
+          continue;
+        }
+
+        for (KX_GameObject *gameobj : it->second) {
+          UpdateActivity(gameobj, radius);
+        }
+      }
+    }
+  }
+}
+
+void KX_ActivityGrid::Clear()
+{
+  for (KX_GameObject *gameobj : m_dirtyObjects) {
+    gameobj->ClearActivityDirty();
+  }
+
+  m_cells.clear();
+  m_entries.clear();
+  m_dirtyObjects.clear();
+  m_cellSize = 0.0f;
+}
+
+void KX_ActivityGrid::AddDirtyObject(KX_GameObject *gameobj)
+{
+  gameobj->SetActivityDirtyIndex(m_dirtyObjects.size());
+  m_dirtyObjects.push_back(gameobj);
+}
+
+void KX_ActivityGrid::RemoveObject(KX_GameObject *gameobj)
+{
+  if (gameobj->IsActivityDirty()) {
+    // Move the last moved object in place of the removed one.
+    const unsigned int index = gameobj->GetActivityDirtyIndex();
+    KX_GameObject *last = m_dirtyObjects.back();
+    m_dirtyObjects[index] = last;
+    last->SetActivityDirtyIndex(index);
+    m_dirtyObjects.pop_back();
+    gameobj->ClearActivityDirty();
+  }
+
+  std::unordered_map<KX_GameObject *, Entry>::iterator it = m_entries.find(gameobj);
+  if (it != m_entries.end()) {
+    const Entry entry = it->second;
+    m_entries.erase(it);
+    EraseObject(gameobj, entry);
+  }
+}
+
+void KX_ActivityGrid::Update(CListValue<KX_GameObject> *objects,
+                             const MT_Vector3 &cameraPosition,
+                             float radius)
+{
+  const float cellSize = radius * KX_ACTIVITY_HYSTERESIS;
+
+  // The radius changed or the grid was cleared, test all the objects.
+  if (cellSize != m_cellSize) {
+    Clear();
+    m_cellSize = cellSize;
+    m_cameraPosition = cameraPosition;
+
+    for (KX_GameObject *gameobj : *objects) {
+      InsertObject(gameobj, GetCell(gameobj->NodeGetWorldPosition()));
+      UpdateActivity(gameobj, radius);
+    }
+    return;
+  }
+
+  const CellKey previousCell = GetCell(m_cameraPosition);
+  const bool cameraMoved = !(cameraPosition == m_cameraPosition);
+  m_cameraPosition = cameraPosition;
+
+  for (KX_GameObject *gameobj : m_dirtyObjects) {
+    gameobj->ClearActivityDirty();
+    MoveObject(gameobj);
+    UpdateActivity(gameobj, radius);
+  }
+  m_dirtyObjects.clear();
+
+  /* The active objects are all in the cells around the previous camera position, the objects
+   * entering the activity box are in the cells around the new camera position. */
+  if (cameraMoved) {
+    const CellKey cell = GetCell(cameraPosition);
+    UpdateNeighborCells(cell, nullptr, radius);
+    if (!(cell == previousCell)) {
+      UpdateNeighborCells(previousCell, &cell, radius);
+    }
+  }
+}
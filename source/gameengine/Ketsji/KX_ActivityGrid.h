@@ -0,0 +1,101 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file KX_ActivityGrid.h
+ *  \ingroup ketsji
+ */
+
+#ifndef __KX_ACTIVITY_GRID_H__
+#define __KX_ACTIVITY_GRID_H__
+
+#include "MT_Vector3.h"
+
+#include <unordered_map>
+#include <vector>
+
+class KX_GameObject;
+template<class ItemType> class CListValue;
+
+/** Uniform grid of the scene objects used by the activity culling.
+ * The objects are suspended outside of the activity box radius scaled by a hysteresis factor
+ * and resumed inside the radius. The cells are as large as the suspension box so that only
+ * the objects of the cells around the camera need to be tested when the camera moves, the
+ * other objects are only tested when they move.
+ */
+class KX_ActivityGrid {
+ private:
+  struct CellKey {
+    int m_x;
+    int m_y;
+    int m_z;
+
+    bool operator==(const CellKey &other) const;
+  };
+
+  struct CellKeyHash {
+    size_t operator()(const CellKey &key) const;
+  };
+
+  /// Location of an object in the grid.
+  struct Entry {
+    CellKey m_cell;
+    /// Index of the object in the cell list.
+    unsigned int m_index;
+  };
+
+  typedef std::unordered_map<CellKey, std::vector<KX_GameObject *>, CellKeyHash> CellMap;
+
+  CellMap m_cells;
+  std::unordered_map<KX_GameObject *, Entry> m_entries;
+  /// Objects moved since the last update.
+  std::vector<KX_GameObject *> m_dirtyObjects;
+  /// Size of a cell, zero when the grid must be rebuilt.
+  float m_cellSize;
+  /// Camera position of the last update.
+  MT_Vector3 m_cameraPosition;
+
+  CellKey GetCell(const MT_Vector3 &position) const;
+  void InsertObject(KX_GameObject *gameobj, const CellKey &cell);
+  void EraseObject(KX_GameObject *gameobj, const Entry &entry);
+  /// Update the cell of a moved object.
+  void MoveObject(KX_GameObject *gameobj);
+  /// Suspend or resume an object depending on its distance to the camera.
+  void UpdateActivity(KX_GameObject *gameobj, float radius) const;
+  /// Update the activity of all the objects of the cells around a cell.
+  void UpdateNeighborCells(const CellKey &center, const CellKey *skipCenter, float radius) const;
+
+ public:
+  KX_ActivityGrid();
+  ~KX_ActivityGrid();
+
+  /// Remove all the objects, the grid is rebuilt at the next update.
+  void Clear();
+
+  /// Register an object moved since the last update, called once until the next update.
+  void AddDirtyObject(KX_GameObject *gameobj);
+  void RemoveObject(KX_GameObject *gameobj);
+
+  /// Suspend and resume the objects which crossed the activity box boundary.
+  void Update(CListValue<KX_GameObject> *objects, const MT_Vector3 &cameraPosition, float radius);
+};
+
+#endif  // __KX_ACTIVITY_GRID_H__
@@ -62,7 +62,11 @@ KX_BlenderMaterial::KX_BlenderMaterial(RAS_Rasterizer *rasty,
 {
   m_alphablend = mat->blend_method;
 
-  if (m_material->use_nodes && m_material->nodetree) {
+  // No GPU material without render.
+  if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS)) {
+    m_gpuMat = nullptr;
+  }
+  else if (m_material->use_nodes && m_material->nodetree) {
     RAS_ICanvas *canvas = KX_GetActiveEngine()->GetCanvas();
     ARegion *ar = canvas->GetARegion();  // if no ar, we are in blenderplayer
     if ((m_scene->GetBlenderScene()->gm.flag & GAME_USE_VIEWPORT_RENDER) == 0 || !ar) {
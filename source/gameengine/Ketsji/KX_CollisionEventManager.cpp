@@ -37,9 +37,13 @@
 #include "PHY_IPhysicsEnvironment.h"
 #include "PHY_IPhysicsController.h"
 
+#include "BLI_utildefines.h"
+
+#include <algorithm>
+
 KX_CollisionEventManager::KX_CollisionEventManager(class SCA_LogicManager *logicmgr,
                                                    PHY_IPhysicsEnvironment *physEnv)
-    : SCA_EventManager(logicmgr, TOUCH_EVENTMGR), m_physEnv(physEnv)
+    : SCA_EventManager(logicmgr, TOUCH_EVENTMGR), m_physEnv(physEnv), m_statistics({0, 0, 0})
 {
   m_physEnv->AddCollisionCallback(
       PHY_OBJECT_RESPONSE, KX_CollisionEventManager::newCollisionResponse, this);
@@ -47,21 +51,19 @@ KX_CollisionEventManager::KX_CollisionEventManager(class SCA_LogicManager *logic
       PHY_SENSOR_RESPONSE, KX_CollisionEventManager::newCollisionResponse, this);
   m_physEnv->AddCollisionCallback(
       PHY_BROADPH_RESPONSE, KX_CollisionEventManager::newBroadphaseResponse, this);
+  m_physEnv->AddCollisionCallback(
+      PHY_PROXIMITY_RESPONSE, KX_CollisionEventManager::newProximityResponse, this);
 }
 
 KX_CollisionEventManager::~KX_CollisionEventManager()
 {
-  RemoveNewCollisions();
 }
 
 void KX_CollisionEventManager::RemoveNewCollisions()
 {
-  for (std::set<NewCollision>::iterator it = m_newCollisions.begin(), end = m_newCollisions.end();
-       it != end;
-       ++it) {
-    delete it->colldata;
-  }
   m_newCollisions.clear();
+  m_proximityCollisions.clear();
+  m_physEnv->ReleaseCollisionData();
 }
 
 bool KX_CollisionEventManager::NewHandleCollision(void *object1,
@@ -71,7 +73,7 @@ bool KX_CollisionEventManager::NewHandleCollision(void *object1,
   PHY_IPhysicsController *obj1 = static_cast<PHY_IPhysicsController *>(object1);
   PHY_IPhysicsController *obj2 = static_cast<PHY_IPhysicsController *>(object2);
 
-  m_newCollisions.insert(NewCollision(obj1, obj2, coll_data));
+  m_newCollisions.push_back({obj1, obj2, coll_data});
 
   return false;
 }
@@ -86,6 +88,18 @@ bool KX_CollisionEventManager::newCollisionResponse(void *client_data,
   return false;
 }
 
+bool KX_CollisionEventManager::newProximityResponse(void *client_data,
+                                                    void *object1,
+                                                    void *object2,
+                                                    const PHY_CollData *UNUSED(coll_data))
+{
+  KX_CollisionEventManager *collisionmgr = (KX_CollisionEventManager *)client_data;
+  collisionmgr->m_proximityCollisions.push_back(
+      {static_cast<PHY_IPhysicsController *>(object1),
+       static_cast<PHY_IPhysicsController *>(object2)});
+  return false;
+}
+
 bool KX_CollisionEventManager::newBroadphaseResponse(void *client_data,
                                                      void *object1,
                                                      void *object2,
@@ -184,82 +198,86 @@ bool KX_CollisionEventManager::RemoveSensor(SCA_ISensor *sensor)
 
 void KX_CollisionEventManager::EndFrame()
 {
-  for (SCA_ISensor *sensor : m_sensors) {
+  // The sleeping sensors didn't record any collision.
+  for (SCA_ISensor *sensor : m_activeSensors) {
     static_cast<SCA_CollisionSensor *>(sensor)->EndFrame();
   }
 }
 
-void KX_CollisionEventManager::NextFrame()
+typedef std::pair<PHY_IPhysicsController *, PHY_IPhysicsController *> ControllerPair;
+
+/// Return the pair of objects of a collision regardless of the object colliding first.
+static ControllerPair get_collision_pair(PHY_IPhysicsController *ctrl1,
+                                         PHY_IPhysicsController *ctrl2)
 {
-  for (SCA_ISensor *sensor : m_sensors) {
-    static_cast<SCA_CollisionSensor *>(sensor)->SynchronizeTransform();
-  }
+  return (ctrl1 < ctrl2) ? ControllerPair(ctrl1, ctrl2) : ControllerPair(ctrl2, ctrl1);
+}
 
-  for (std::set<NewCollision>::iterator cit = m_newCollisions.begin();
-       cit != m_newCollisions.end();
-       ++cit) {
-    // Controllers
-    PHY_IPhysicsController *ctrl1 = (*cit).first;
-    PHY_IPhysicsController *ctrl2 = (*cit).second;
-    // Sensor iterator
-    std::list<SCA_ISensor *>::iterator sit;
-
-    // First client info
-    KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
-        ctrl1->GetNewClientInfo());
-    // First gameobject
-    KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(client_info);
-    // Invoke sensor response for each object
-    if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl1, ctrl2, nullptr);
-      }
-    }
+bool KX_CollisionEventManager::NewCollision::operator<(const NewCollision &other) const
+{
+  return get_collision_pair(first, second) < get_collision_pair(other.first, other.second);
+}
 
-    // Second client info
-    client_info = static_cast<KX_ClientObjectInfo *>(ctrl2->GetNewClientInfo());
-    // Second gameobject
-    KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(client_info);
-    if (client_info) {
-      for (sit = client_info->m_sensors.begin(); sit != client_info->m_sensors.end(); ++sit) {
-        static_cast<SCA_CollisionSensor *>(*sit)->NewHandleCollision(ctrl2, ctrl1, nullptr);
-      }
+/// Invoke the collision response of the sensors of an object.
+static void handle_sensors_collision(PHY_IPhysicsController *ctrl1, PHY_IPhysicsController *ctrl2)
+{
+  KX_ClientObjectInfo *client_info = static_cast<KX_ClientObjectInfo *>(
+      ctrl1->GetNewClientInfo());
+  if (client_info) {
+    for (SCA_ISensor *sensor : client_info->m_sensors) {
+      static_cast<SCA_CollisionSensor *>(sensor)->NewHandleCollision(ctrl1, ctrl2, nullptr);
+      sensor->Wake();
     }
-    // Run python callbacks
-    const PHY_CollData *colldata = cit->colldata;
-    KX_CollisionContactPointList contactPointList0 = KX_CollisionContactPointList(colldata, true);
-    KX_CollisionContactPointList contactPointList1 = KX_CollisionContactPointList(colldata, false);
-    kxObj1->RunCollisionCallbacks(kxObj2, contactPointList0);
-    kxObj2->RunCollisionCallbacks(kxObj1, contactPointList1);
   }
+}
 
+void KX_CollisionEventManager::NextFrame()
+{
   for (SCA_ISensor *sensor : m_sensors) {
-    sensor->Activate(m_logicmgr);
+    static_cast<SCA_CollisionSensor *>(sensor)->SynchronizeTransform();
   }
 
-  RemoveNewCollisions();
-}
+  m_statistics = {(unsigned int)m_newCollisions.size(), 0, 0};
 
-KX_CollisionEventManager::NewCollision::NewCollision(PHY_IPhysicsController *first,
-                                                     PHY_IPhysicsController *second,
-                                                     const PHY_CollData *colldata)
-    : first(first), second(second), colldata(colldata)
-{
-}
+  /* Group the collisions by pair of objects, the sensors only record the colliding objects and
+   * are notified once per pair, the python callbacks are run for each collision. */
+  std::stable_sort(m_newCollisions.begin(), m_newCollisions.end());
 
-KX_CollisionEventManager::NewCollision::NewCollision(const NewCollision &to_copy)
-    : first(to_copy.first), second(to_copy.second), colldata(to_copy.colldata)
-{
-}
+  for (std::vector<NewCollision>::const_iterator it = m_newCollisions.begin(),
+                                                 end = m_newCollisions.end();
+       it != end;) {
+    const ControllerPair pair = get_collision_pair(it->first, it->second);
 
-bool KX_CollisionEventManager::NewCollision::operator<(const NewCollision &other) const
-{
-  // see strict weak ordering: https://support.microsoft.com/en-us/kb/949171
-  if (first == other.first) {
-    if (second == other.second) {
-      return colldata < other.colldata;
+    handle_sensors_collision(it->first, it->second);
+    handle_sensors_collision(it->second, it->first);
+    ++m_statistics.m_numPairs;
+
+    for (; it != end && get_collision_pair(it->first, it->second) == pair; ++it) {
+      KX_GameObject *kxObj1 = KX_GameObject::GetClientObject(
+          static_cast<KX_ClientObjectInfo *>(it->first->GetNewClientInfo()));
+      KX_GameObject *kxObj2 = KX_GameObject::GetClientObject(
+          static_cast<KX_ClientObjectInfo *>(it->second->GetNewClientInfo()));
+
+      // Don't build the contact points for objects without python callbacks.
+      if (kxObj1->HasCollisionCallbacks()) {
+        KX_CollisionContactPointList contactPointList(it->colldata, true);
+        kxObj1->RunCollisionCallbacks(kxObj2, contactPointList);
+        ++m_statistics.m_numCallbacks;
+      }
+      if (kxObj2->HasCollisionCallbacks()) {
+        KX_CollisionContactPointList contactPointList(it->colldata, false);
+        kxObj2->RunCollisionCallbacks(kxObj1, contactPointList);
+        ++m_statistics.m_numCallbacks;
+      }
     }
-    return second < other.second;
   }
-  return first < other.first;
+
+  // The proximity sensors are reported once per object without contact points.
+  for (const ProximityCollision &collision : m_proximityCollisions) {
+    handle_sensors_collision(collision.sensor, collision.object);
+  }
+
+  ActivateSensors();
+
+  RemoveNewCollisions();
 }
@@ -37,38 +37,48 @@
 #include "KX_GameObject.h"
 
 #include <vector>
-#include <set>
 
 class SCA_ISensor;
 class PHY_IPhysicsEnvironment;
 
 class KX_CollisionEventManager : public SCA_EventManager {
-  /**
-   * Contains two colliding objects and the first contact point.
-   */
-  class NewCollision {
-   public:
+ public:
+  /// Counters of the collisions processed during the last frame.
+  struct Statistics {
+    /// Number of collisions received from the physics environment.
+    unsigned int m_numCollisions;
+    /// Number of distinct pairs of colliding objects notified to the sensors.
+    unsigned int m_numPairs;
+    /// Number of python collision callbacks lists run.
+    unsigned int m_numCallbacks;
+  };
+
+ private:
+  /// Two colliding objects and their contact points.
+  struct NewCollision {
     PHY_IPhysicsController *first;
     PHY_IPhysicsController *second;
+    /// Owned by the physics environment until the collisions are released.
     const PHY_CollData *colldata;
 
-    /**
-     * Creates a copy of the given PHY_CollData; freeing that copy should be done by the owner of
-     * the NewCollision object.
-     *
-     * This allows us to efficiently store NewCollision objects in a std::set without creating more
-     * copies of colldata, as the NewCollision copy constructor reuses the pointer and doesn't
-     * clone it again. */
-    NewCollision(PHY_IPhysicsController *first,
-                 PHY_IPhysicsController *second,
-                 const PHY_CollData *colldata);
-    NewCollision(const NewCollision &to_copy);
+    /// Order by pair of objects regardless of the object colliding first.
     bool operator<(const NewCollision &other) const;
   };
 
+  /// Object overlapping the volume of a Near or Radar sensor.
+  struct ProximityCollision {
+    PHY_IPhysicsController *sensor;
+    PHY_IPhysicsController *object;
+  };
+
   PHY_IPhysicsEnvironment *m_physEnv;
 
-  std::set<NewCollision> m_newCollisions;
+  /// Collisions of the frame, the capacity is kept between frames.
+  std::vector<NewCollision> m_newCollisions;
+  /// Overlaps of the proximity sensors of the frame.
+  std::vector<ProximityCollision> m_proximityCollisions;
+
+  Statistics m_statistics;
 
   static bool newCollisionResponse(void *client_data,
                                    void *object1,
@@ -80,6 +90,11 @@ class KX_CollisionEventManager : public SCA_EventManager {
                                     void *object2,
                                     const PHY_CollData *coll_data);
 
+  static bool newProximityResponse(void *client_data,
+                                   void *object1,
+                                   void *object2,
+                                   const PHY_CollData *coll_data);
+
   virtual bool NewHandleCollision(void *obj1, void *obj2, const PHY_CollData *coll_data);
 
   void RemoveNewCollisions();
@@ -100,6 +115,11 @@ class KX_CollisionEventManager : public SCA_EventManager {
   {
     return m_physEnv;
   }
+
+  const Statistics &GetStatistics() const
+  {
+    return m_statistics;
+  }
 };
 
 #endif  // __KX_TOUCHEVENTMANAGER_H__
@@ -46,6 +46,8 @@ extern "C" {
 
 #define MAX_BGE_TEXT_LEN 1024  // eevee
 
+const CPropertyKey KX_FontObject::sTextKey("Text");
+
 static std::vector<std::string> split_string(std::string str)
 {
   std::vector<std::string> text = std::vector<std::string>();
@@ -127,7 +129,7 @@ void KX_FontObject::UpdateCurveText(std::string newText)  // eevee
 void KX_FontObject::UpdateTextFromProperty()
 {
   // Allow for some logic brick control
-  CValue *prop = GetProperty("Text");
+  CValue *prop = GetProperty(sTextKey);
   if (prop && prop->GetText() != m_text) {
     SetText(prop->GetText());
     UpdateCurveText(m_text);  // eevee
@@ -203,10 +205,10 @@ int KX_FontObject::pyattr_set_text(PyObjectPlus *self_v,
   const char *chars = _PyUnicode_AsString(value);
 
   /* Allow for some logic brick control */
-  CValue *tprop = self->GetProperty("Text");
+  CValue *tprop = self->GetProperty(sTextKey);
   if (tprop) {
     CValue *newstringprop = new CStringValue(std::string(chars), "Text");
-    self->SetProperty("Text", newstringprop);
+    self->SetProperty(sTextKey, newstringprop);
     newstringprop->Release();
   }
   else {
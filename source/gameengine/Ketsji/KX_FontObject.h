@@ -36,6 +36,9 @@
 
 class KX_FontObject : public KX_GameObject {
  public:
+  /// Key of the property overriding the text.
+  static const CPropertyKey sTextKey;
+
   Py_Header KX_FontObject(void *sgReplicationInfo,
                           SG_Callbacks callbacks,
                           RAS_Rasterizer *rasterizer,
@@ -91,6 +91,8 @@
 
 #include "CM_Message.h"
 
+#include <atomic>
+
 /* eevee integration */
 #include "DRW_render.h"
 
@@ -117,17 +119,34 @@ extern "C" {
 #include "KX_BlenderConverter.h"
 /* End of eevee integration */
 
+const CPropertyKey KX_GameObject::sTimebombKey("::timebomb");
+
 static MT_Vector3 dummy_point = MT_Vector3(0.0f, 0.0f, 0.0f);
 static MT_Vector3 dummy_scaling = MT_Vector3(1.0f, 1.0f, 1.0f);
 static MT_Matrix3x3 dummy_orientation = MT_Matrix3x3(
     1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f);
 
+/// Last identifier given to an object, the scenes can be converted in loading threads.
+static std::atomic<unsigned long long> lastSnapshotId(0);
+
 KX_GameObject::KX_GameObject(void *sgReplicationInfo, SG_Callbacks callbacks)
     : SCA_IObject(),
-      m_castShadows(true),          // eevee
-      m_isReplica(false),           // eevee
-      m_staticObject(true),         // eevee
-      m_visibleAtGameStart(false),  // eevee
+      m_castShadows(true),             // eevee
+      m_isReplica(false),              // eevee
+      m_replicaSourceObject(nullptr),  // eevee
+      m_staticObject(true),            // eevee
+      m_transformDirty(false),         // eevee
+      m_transformDirtyIndex(0),
+      m_culled(false),                 // eevee
+      m_activityDirty(false),
+      m_activityDirtyIndex(0),
+      m_interpolationDirty(false),
+      m_interpolationDirtyIndex(0),
+      m_interpolated(false),
+      m_interpolatedIndex(0),
+      m_interpolationValid(false),
+      m_snapshotId(++lastSnapshotId),
+      m_visibleAtGameStart(false),     // eevee
       m_layer(0),
       m_lodManager(nullptr),
       m_currentLodLevel(0),
@@ -268,8 +287,13 @@ void KX_GameObject::SetBlenderObject(Object *obj)
 
 void KX_GameObject::TagForUpdate(bool is_overlay_pass)
 {
+  MT_Vector3 position;
+  MT_Matrix3x3 orientation;
+  MT_Vector3 scale;
+  GetRenderTransform(position, orientation, scale);
+
   float obmat[4][4];
-  NodeGetWorldTransform().getValue(&obmat[0][0]);
+  MT_Transform(position, orientation.scaled(scale[0], scale[1], scale[2])).getValue(&obmat[0][0]);
   m_staticObject = compare_m4m4(m_prevObmat, obmat, FLT_MIN);
 
   Scene *sc = GetScene()->GetBlenderScene();
@@ -277,9 +301,6 @@ void KX_GameObject::TagForUpdate(bool is_overlay_pass)
   Main *bmain = KX_GetActiveEngine()->GetConverter()->GetMain();
   Depsgraph *depsgraph = BKE_scene_get_depsgraph(bmain, sc, view_layer, false);
 
-  if (m_staticObject) {
-    GetScene()->AppendToStaticObjects(this);
-  }
   Object *ob_orig = GetBlenderObject();
   if (ob_orig) {
 
@@ -332,7 +353,21 @@ void KX_GameObject::ReplicateBlenderObject()
   Object *ob = GetBlenderObject();
 
   if (ob) {
+    m_replicaSourceObject = ob;
+    m_isReplica = true;
+
     Main *bmain = KX_GetActiveEngine()->GetConverter()->GetMain();
+
+    // Reuse a hidden copy if the object is pooled, relations are updated only if relinked.
+    Object *pooledob = GetScene()->GetPooledReplicaObject(ob);
+    if (pooledob) {
+      if (LinkReplicaBlenderObject(ob, pooledob)) {
+        DEG_relations_tag_update(bmain);
+      }
+      m_pBlenderObject = pooledob;
+      return;
+    }
+
     Object *newob;
     BKE_id_copy_ex(bmain, &ob->id, (ID **)&newob, 0);
     Scene *scene = GetScene()->GetBlenderScene();
@@ -343,37 +378,56 @@ void KX_GameObject::ReplicateBlenderObject()
                                    newob);  // add replica where is the active camera
     newob->base_flag |= (BASE_VISIBLE_VIEWLAYER | BASE_VISIBLE_DEPSGRAPH);
 
-    if (ob->parent) {
-      if (GetScene()->GetLastReplicatedParentObject()) {
-        newob->parent = GetScene()->GetLastReplicatedParentObject();
-        if (ob->parent && ob->parent->type == OB_ARMATURE) {
-          ModifierData *mod;
-          for (mod = (ModifierData *)newob->modifiers.first; mod; mod = mod->next) {
-            if (mod->type == eModifierType_Armature) {
-              ((ArmatureModifierData *)mod)->object = newob->parent;
-            }
+    LinkReplicaBlenderObject(ob, newob);
+
+    DEG_relations_tag_update(bmain);
+
+    m_pBlenderObject = newob;
+  }
+}
+
+bool KX_GameObject::LinkReplicaBlenderObject(Object *ob, Object *newob)
+{
+  bool relinked = false;
+
+  if (ob->parent) {
+    Object *parent = GetScene()->GetLastReplicatedParentObject();
+    if (parent) {
+      relinked = (newob->parent != parent);
+      newob->parent = parent;
+      if (ob->parent->type == OB_ARMATURE) {
+        ModifierData *mod;
+        for (mod = (ModifierData *)newob->modifiers.first; mod; mod = mod->next) {
+          if (mod->type == eModifierType_Armature) {
+            ArmatureModifierData *amd = (ArmatureModifierData *)mod;
+            relinked |= (amd->object != parent);
+            amd->object = parent;
           }
         }
-        GetScene()->ResetLastReplicatedParentObject();
       }
+      GetScene()->ResetLastReplicatedParentObject();
     }
+  }
 
-    // To check again
-    NodeList &children = GetSGNode()->GetSGChildren();
-    if (children.size() > 0) {
-      GetScene()->SetLastReplicatedParentObject(newob);
-    }
-
-    DEG_relations_tag_update(bmain);
-
-    m_pBlenderObject = newob;
-    m_isReplica = true;
+  // To check again
+  NodeList &children = GetSGNode()->GetSGChildren();
+  if (children.size() > 0) {
+    GetScene()->SetLastReplicatedParentObject(newob);
   }
+
+  return relinked;
 }
 void KX_GameObject::RemoveReplicaObject()
 {
   Object *ob = GetBlenderObject();
   if (ob && m_isReplica) {
+    // Keep the copy hidden for the next replica while the game is running.
+    if (GetScene()->m_isRuntime &&
+        GetScene()->ReleasePooledReplicaObject(m_replicaSourceObject, ob)) {
+      SetBlenderObject(nullptr);
+      return;
+    }
+
     Main *bmain = KX_GetActiveEngine()->GetConverter()->GetMain();
     Scene *scene = GetScene()->GetBlenderScene();
     BKE_scene_collections_object_remove(bmain, scene, ob, true);
@@ -531,6 +585,173 @@ bool KX_GameObject::IsReplica()
   return m_isReplica;
 }
 
+unsigned long long KX_GameObject::GetSnapshotId() const
+{
+  return m_snapshotId;
+}
+
+bool KX_GameObject::IsTransformDirty() const
+{
+  return m_transformDirty;
+}
+
+void KX_GameObject::SetTransformDirty()
+{
+  /* Register the object only once to synchronize its blender object
+   * at next render. */
+  if (!m_transformDirty) {
+    m_transformDirty = true;
+    GetScene()->AppendToTransformDirtyObjects(this);
+  }
+}
+
+void KX_GameObject::ClearTransformDirty()
+{
+  m_transformDirty = false;
+}
+
+unsigned int KX_GameObject::GetTransformDirtyIndex() const
+{
+  return m_transformDirtyIndex;
+}
+
+void KX_GameObject::SetTransformDirtyIndex(unsigned int index)
+{
+  m_transformDirtyIndex = index;
+}
+
+bool KX_GameObject::IsActivityDirty() const
+{
+  return m_activityDirty;
+}
+
+void KX_GameObject::SetActivityDirty()
+{
+  // Register the object only once to update its activity at next logic frame.
+  KX_Scene *scene = GetScene();
+  if (!m_activityDirty && scene->GetActivityCulling()) {
+    m_activityDirty = true;
+    scene->AppendToActivityDirtyObjects(this);
+  }
+}
+
+void KX_GameObject::ClearActivityDirty()
+{
+  m_activityDirty = false;
+}
+
+unsigned int KX_GameObject::GetActivityDirtyIndex() const
+{
+  return m_activityDirtyIndex;
+}
+
+void KX_GameObject::SetActivityDirtyIndex(unsigned int index)
+{
+  m_activityDirtyIndex = index;
+}
+
+bool KX_GameObject::IsInterpolationDirty() const
+{
+  return m_interpolationDirty;
+}
+
+void KX_GameObject::SetInterpolationDirty()
+{
+  // Register the object only once to store its transform at the end of the logic frame.
+  if (!m_interpolationDirty &&
+      KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::RENDER_INTERPOLATION)) {
+    m_interpolationDirty = true;
+    GetScene()->AppendToInterpolationDirtyObjects(this);
+  }
+}
+
+void KX_GameObject::ClearInterpolationDirty()
+{
+  m_interpolationDirty = false;
+}
+
+unsigned int KX_GameObject::GetInterpolationDirtyIndex() const
+{
+  return m_interpolationDirtyIndex;
+}
+
+void KX_GameObject::SetInterpolationDirtyIndex(unsigned int index)
+{
+  m_interpolationDirtyIndex = index;
+}
+
+bool KX_GameObject::IsInterpolated() const
+{
+  return m_interpolated;
+}
+
+unsigned int KX_GameObject::GetInterpolatedIndex() const
+{
+  return m_interpolatedIndex;
+}
+
+void KX_GameObject::SetInterpolatedIndex(unsigned int index)
+{
+  m_interpolatedIndex = index;
+}
+
+void KX_GameObject::StartInterpolation()
+{
+  const MT_Vector3 &position = NodeGetWorldPosition();
+  const MT_Quaternion rotation = NodeGetWorldOrientation().getRotation();
+  const MT_Vector3 &scale = NodeGetWorldScaling();
+
+  // Without known previous transform the object is not interpolated until the next logic frame.
+  if (m_interpolationValid) {
+    m_interpolationPositions[0] = m_interpolationPositions[1];
+    m_interpolationRotations[0] = m_interpolationRotations[1];
+    m_interpolationScales[0] = m_interpolationScales[1];
+  }
+  else {
+    m_interpolationPositions[0] = position;
+    m_interpolationRotations[0] = rotation;
+    m_interpolationScales[0] = scale;
+  }
+
+  m_interpolationPositions[1] = position;
+  m_interpolationRotations[1] = rotation;
+  m_interpolationScales[1] = scale;
+  m_interpolationValid = true;
+  m_interpolated = true;
+}
+
+void KX_GameObject::StopInterpolation()
+{
+  m_interpolated = false;
+}
+
+void KX_GameObject::GetRenderTransform(MT_Vector3 &position,
+                                       MT_Matrix3x3 &orientation,
+                                       MT_Vector3 &scale)
+{
+  if (!m_interpolated) {
+    position = NodeGetWorldPosition();
+    orientation = NodeGetWorldOrientation();
+    scale = NodeGetWorldScaling();
+    return;
+  }
+
+  const float factor = GetScene()->GetInterpolationFactor();
+  position = m_interpolationPositions[0].lerp(m_interpolationPositions[1], factor);
+  orientation.setRotation(m_interpolationRotations[0].slerp(m_interpolationRotations[1], factor));
+  scale = m_interpolationScales[0].lerp(m_interpolationScales[1], factor);
+}
+
+bool KX_GameObject::GetCulled() const
+{
+  return m_culled;
+}
+
+void KX_GameObject::SetCulled(bool culled)
+{
+  m_culled = culled;
+}
+
 /********************End of EEVEE INTEGRATION*********************/
 
 KX_GameObject *KX_GameObject::GetClientObject(KX_ClientObjectInfo *info)
@@ -821,6 +1042,13 @@ void KX_GameObject::ProcessReplica()
 
   m_pPhysicsController = nullptr;
   m_pSGNode = nullptr;
+  // The replica is registered in the scene list when its node is updated.
+  m_transformDirty = false;
+  m_activityDirty = false;
+  m_interpolationDirty = false;
+  m_interpolated = false;
+  m_interpolationValid = false;
+  m_snapshotId = ++lastSnapshotId;
 
   /* Dupli group and instance list are set later in replication.
    * See KX_Scene::DupliGroupRecurse. */
@@ -1071,7 +1299,12 @@ void KX_GameObject::UpdateTransform()
 
 void KX_GameObject::UpdateTransformFunc(SG_Node *node, void *gameobj, void *scene)
 {
-  ((KX_GameObject *)gameobj)->UpdateTransform();
+  KX_GameObject *obj = (KX_GameObject *)gameobj;
+  obj->UpdateTransform();
+  // This callback is always called under the scene graph transform lock.
+  obj->SetTransformDirty();
+  obj->SetActivityDirty();
+  obj->SetInterpolationDirty();
 }
 
 void KX_GameObject::SynchronizeTransform()
@@ -1639,6 +1872,15 @@ void KX_GameObject::RegisterCollisionCallbacks()
       pe->AddSensor(spc);
   }
 }
+bool KX_GameObject::HasCollisionCallbacks() const
+{
+#ifdef WITH_PYTHON
+  return (m_collisionCallbacks && PyList_GET_SIZE(m_collisionCallbacks) != 0);
+#else
+  return false;
+#endif
+}
+
 void KX_GameObject::RunCollisionCallbacks(KX_GameObject *collider,
                                           KX_CollisionContactPointList &contactPointList)
 {
@@ -1751,20 +1993,6 @@ void KX_GameObject::SetComponents(CListValue<KX_PythonComponent> *components)
   m_components = components;
 }
 
-void KX_GameObject::UpdateComponents()
-{
-#ifdef WITH_PYTHON
-  if (!m_components) {
-    return;
-  }
-
-  for (KX_PythonComponent *comp : m_components) {
-    comp->Update();
-  }
-
-#endif  // WITH_PYTHON
-}
-
 KX_Scene *KX_GameObject::GetScene()
 {
   BLI_assert(m_pSGNode);
@@ -2367,12 +2595,16 @@ static int Map_SetItem(PyObject *self_v, PyObject *key, PyObject *val)
       CValue *vallie = self->ConvertPythonToValue(val, false, "gameOb[key] = value: ");
 
       if (vallie) {
-        CValue *oldprop = self->GetProperty(attr_str);
+        const CPropertyKey propkey(attr_str);
+        CValue *oldprop = self->GetProperty(propkey);
 
-        if (oldprop)
+        if (oldprop) {
           oldprop->SetValue(vallie);
-        else
-          self->SetProperty(attr_str, vallie);
+          self->PropertyModified(propkey);
+        }
+        else {
+          self->SetProperty(propkey, vallie);
+        }
 
         vallie->Release();
         set = true;
@@ -2694,7 +2926,7 @@ PyObject *KX_GameObject::pyattr_get_life(PyObjectPlus *self_v, const KX_PYATTRIB
 {
   KX_GameObject *self = static_cast<KX_GameObject *>(self_v);
 
-  CValue *life = self->GetProperty("::timebomb");
+  CValue *life = self->GetProperty(sTimebombKey);
   if (life)
     // this convert the timebomb seconds to frames, hard coded 50.0f (assuming 50fps)
     // value hardcoded in KX_Scene::AddReplicaObject()
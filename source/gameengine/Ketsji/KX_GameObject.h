@@ -91,7 +91,35 @@ class KX_GameObject : public SCA_IObject {
       float m_prevObmat[4][4];
   bool m_castShadows;
   bool m_isReplica;
+  /// Blender object copied for the replica, used to recycle the copy.
+  struct Object *m_replicaSourceObject;
   bool m_staticObject;
+  /// True when the object is registered in the scene list of objects to synchronize.
+  bool m_transformDirty;
+  /// Position of the object in the scene list of objects to synchronize, valid when registered.
+  unsigned int m_transformDirtyIndex;
+  /// True when the object is outside the active camera frustum, only used for animations.
+  bool m_culled;
+  /// True when the object is registered in the scene activity grid as moved.
+  bool m_activityDirty;
+  /// Position of the object in the activity grid list of moved objects, valid when registered.
+  unsigned int m_activityDirtyIndex;
+  /// True when the object is registered in the scene list of objects moved during the logic frame.
+  bool m_interpolationDirty;
+  /// Position of the object in the scene list of objects moved during the logic frame.
+  unsigned int m_interpolationDirtyIndex;
+  /// True when the object moved during the last logic frame and is rendered interpolated.
+  bool m_interpolated;
+  /// Position of the object in the scene list of interpolated objects.
+  unsigned int m_interpolatedIndex;
+  /// True when the transform at the end of the last logic frame is stored.
+  bool m_interpolationValid;
+  /// World transforms at the end of the two last logic frames, the previous first.
+  MT_Vector3 m_interpolationPositions[2];
+  MT_Quaternion m_interpolationRotations[2];
+  MT_Vector3 m_interpolationScales[2];
+  /// Identifier never reused by another object, matches the object in the scene snapshots.
+  unsigned long long m_snapshotId;
   bool m_useCopy;
   bool m_visibleAtGameStart;
   /* END OF EEVEE INTEGRATION */
@@ -134,7 +162,16 @@ class KX_GameObject : public SCA_IObject {
 
   BL_ActionManager *GetActionManager();
 
+  /** Link a replica blender object to the last replicated parent, and make it the parent of
+   * the next replicas if the object has children.
+   * \return True if the parent or an armature modifier object changed.
+   */
+  bool LinkReplicaBlenderObject(Object *ob, Object *newob);
+
  public:
+  /// Key of the remaining life time property of the objects added with a life span.
+  static const CPropertyKey sTimebombKey;
+
   /* EEVEE INTEGRATION */
 
   void TagForUpdate(bool is_overlay_pass);
@@ -149,6 +186,33 @@ class KX_GameObject : public SCA_IObject {
   void RestoreLogic(bool childrenRecursive);
   void AddDummyLodManager(RAS_MeshObject *meshObj);
   bool IsReplica();
+  unsigned long long GetSnapshotId() const;
+  bool IsTransformDirty() const;
+  void SetTransformDirty();
+  void ClearTransformDirty();
+  unsigned int GetTransformDirtyIndex() const;
+  void SetTransformDirtyIndex(unsigned int index);
+  bool IsActivityDirty() const;
+  void SetActivityDirty();
+  void ClearActivityDirty();
+  unsigned int GetActivityDirtyIndex() const;
+  void SetActivityDirtyIndex(unsigned int index);
+  bool IsInterpolationDirty() const;
+  void SetInterpolationDirty();
+  void ClearInterpolationDirty();
+  unsigned int GetInterpolationDirtyIndex() const;
+  void SetInterpolationDirtyIndex(unsigned int index);
+  bool IsInterpolated() const;
+  unsigned int GetInterpolatedIndex() const;
+  void SetInterpolatedIndex(unsigned int index);
+  /// Store the world transform at the end of a logic frame and interpolate from the previous one.
+  void StartInterpolation();
+  /// Render the world transform of the last logic frame.
+  void StopInterpolation();
+  /// Get the world transform rendered between the two last logic frames.
+  void GetRenderTransform(MT_Vector3 &position, MT_Matrix3x3 &orientation, MT_Vector3 &scale);
+  bool GetCulled() const;
+  void SetCulled(bool culled);
   /* END OF EEVEE INTEGRATION */
 
   /**
@@ -292,7 +356,7 @@ class KX_GameObject : public SCA_IObject {
   /**
    * Remove playing tagged actions.
    */
-  void RemoveTaggedActions();
+  virtual void RemoveTaggedActions();
 
   /**
    * Check if an action has finished playing
@@ -707,6 +771,8 @@ class KX_GameObject : public SCA_IObject {
 
   void RegisterCollisionCallbacks();
   void UnregisterCollisionCallbacks();
+  /// Return true if python collision callbacks are registered.
+  bool HasCollisionCallbacks() const;
   void RunCollisionCallbacks(KX_GameObject *collider,
                              KX_CollisionContactPointList &contactPointList);
   /**
@@ -736,8 +802,6 @@ class KX_GameObject : public SCA_IObject {
   CListValue<KX_PythonComponent> *GetComponents() const;
   /// Add a components.
   void SetComponents(CListValue<KX_PythonComponent> *components);
-  /// Updates the components.
-  void UpdateComponents();
 
   KX_Scene *GetScene();
 
@@ -35,7 +35,9 @@
 #endif
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
+#include <algorithm>
 #include <boost/format.hpp>
 
 #include "BLI_task.h"
@@ -186,6 +188,8 @@ KX_KetsjiEngine::KX_KetsjiEngine(KX_ISystem *system, bContext *C)
 #endif
 
   m_taskscheduler = BLI_task_scheduler_create(1);
+  // Created at the first parallel work, most games never use it.
+  m_parallelScheduler = nullptr;
 
   m_scenes = new CListValue<KX_Scene>();
 }
@@ -201,6 +205,8 @@ KX_KetsjiEngine::~KX_KetsjiEngine()
 
   if (m_taskscheduler)
     BLI_task_scheduler_free(m_taskscheduler);
+  if (m_parallelScheduler)
+    BLI_task_scheduler_free(m_parallelScheduler);
 
   m_scenes->Release();
 }
@@ -210,6 +216,14 @@ bContext *KX_KetsjiEngine::GetContext()
   return m_context;
 }
 
+TaskScheduler *KX_KetsjiEngine::GetParallelScheduler()
+{
+  if (!m_parallelScheduler) {
+    m_parallelScheduler = BLI_task_scheduler_create(0);
+  }
+  return m_parallelScheduler;
+}
+
 void KX_KetsjiEngine::SetInputDevice(SCA_IInputDevice *inputDevice)
 {
   BLI_assert(inputDevice);
@@ -307,6 +321,8 @@ void KX_KetsjiEngine::EndFrame()
 
 bool KX_KetsjiEngine::NextFrame()
 {
+  CM_ProfileScope profileScope("engine", "NextFrame");
+
   m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
 
   /*
@@ -396,84 +412,222 @@ bool KX_KetsjiEngine::NextFrame()
     }
 #endif  // WITH_SDL
 
-    // for each scene, call the proceed functions
+    if (m_flags & PARALLEL_SCENES) {
+      ProceedScenesParallel(timestep, framestep);
+    }
+    else {
+      ProceedScenes(timestep, framestep);
+    }
+
+    m_logger.StartLog(tc_network, m_kxsystem->GetTimeInSeconds());
+    m_networkMessageManager->ClearMessages();
+
+    m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
+
+    // update system devices
+    m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
+    if (m_inputDevice) {
+      m_inputDevice->ClearInputs();
+    }
+
+    UpdateSuspendedScenes(framestep);
+    // scene management
+    ProcessScheduledScenes();
+
+    if (m_flags & RENDER_INTERPOLATION) {
+      for (KX_Scene *scene : m_scenes) {
+        scene->UpdateInterpolatedObjects();
+      }
+    }
+
+    frames--;
+  }
+
+  /* Render between the logic frames, the objects are interpolated from the transform of the
+   * previous logic frame by the time elapsed since the last logic frame. */
+  if ((m_flags & RENDER_INTERPOLATION) && (m_flags & FIXED_FRAMERATE) && !(m_flags & HEADLESS)) {
+    const float factor = std::min((m_clockTime - m_frameTime) / timestep, 1.0);
     for (KX_Scene *scene : m_scenes) {
-      /* Suspension holds the physics and logic processing for an
-       * entire scene. Objects can be suspended individually, and
-       * the settings for that precede the logic and physics
-       * update. */
-      m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
+      scene->InterpolateObjects(factor);
+    }
+    doRender = true;
+  }
+
+  if (doRender && (m_flags & HEADLESS)) {
+    ProceedHeadlessScenes();
+  }
 
-      scene->UpdateObjectActivity();
+  // Start logging time spent outside main loop
+  m_logger.StartLog(tc_outside, m_kxsystem->GetTimeInSeconds());
+
+  return doRender && m_doRender;
+}
+
+void KX_KetsjiEngine::ProceedScenes(double timestep, double framestep)
+{
+  // for each scene, call the proceed functions
+  for (KX_Scene *scene : m_scenes) {
+    CM_ProfileScope sceneScope("scene", scene->GetName());
 
-      if (!scene->IsSuspended()) {
-        m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
-        // set Python hooks for each scene
+    /* Suspension holds the physics and logic processing for an
+     * entire scene. Objects can be suspended individually, and
+     * the settings for that precede the logic and physics
+     * update. */
+    m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
+
+    scene->UpdateObjectActivity();
+
+    if (!scene->IsSuspended()) {
+      m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+      // set Python hooks for each scene
 #ifdef WITH_PYTHON
-        PHY_SetActiveEnvironment(scene->GetPhysicsEnvironment());
+      PHY_SetActiveEnvironment(scene->GetPhysicsEnvironment());
 #endif
-        KX_SetActiveScene(scene);
-
-        scene->GetPhysicsEnvironment()->EndFrame();
+      KX_SetActiveScene(scene);
 
-        // Process sensors, and controllers
-        m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
-        scene->LogicBeginFrame(m_frameTime, framestep);
+      scene->GetPhysicsEnvironment()->EndFrame();
 
-        // Scenegraph needs to be updated again, because Logic Controllers
-        // can affect the local matrices.
-        m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
-        scene->UpdateParents(m_frameTime);
+      // Process sensors, and controllers
+      m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
+      scene->LogicBeginFrame(m_frameTime, framestep);
 
-        // Process actuators
+      // Scenegraph needs to be updated again, because Logic Controllers
+      // can affect the local matrices.
+      m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+      scene->UpdateParents(m_frameTime);
 
-        // Do some cleanup work for this logic frame
-        m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
-        scene->LogicUpdateFrame(m_frameTime);
+      // Process actuators
 
-        scene->LogicEndFrame();
+      // Do some cleanup work for this logic frame
+      m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
+      scene->LogicUpdateFrame(m_frameTime);
 
-        // Actuators can affect the scenegraph
-        m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
-        scene->UpdateParents(m_frameTime);
+      scene->LogicEndFrame();
 
-        m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
-        scene->GetPhysicsEnvironment()->BeginFrame();
+      // Actuators can affect the scenegraph
+      m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+      scene->UpdateParents(m_frameTime);
 
-        // Perform physics calculations on the scene. This can involve
-        // many iterations of the physics solver.
-        scene->GetPhysicsEnvironment()->ProceedDeltaTime(
-            m_frameTime, timestep, framestep);  // m_deltatimerealDeltaTime);
+      m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+      scene->GetPhysicsEnvironment()->BeginFrame();
 
-        m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
-        scene->UpdateParents(m_frameTime);
-      }
+      // Perform physics calculations on the scene. This can involve
+      // many iterations of the physics solver.
+      scene->GetPhysicsEnvironment()->ProceedDeltaTime(
+          m_frameTime, timestep, framestep);  // m_deltatimerealDeltaTime);
 
-      m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
+      m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+      scene->UpdateParents(m_frameTime);
     }
 
-    m_logger.StartLog(tc_network, m_kxsystem->GetTimeInSeconds());
-    m_networkMessageManager->ClearMessages();
-
     m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
+  }
+}
+
+struct KX_SceneProceedData {
+  double frameTime;
+  double timestep;
+  double framestep;
+};
+
+/// Update scene graph and physics of a scene, this must not call any python code.
+static void proceed_scene(KX_Scene *scene, const KX_SceneProceedData *data)
+{
+  PHY_IPhysicsEnvironment *physEnv = scene->GetPhysicsEnvironment();
+
+  CM_ProfileScope profileScope("scene", scene->GetName());
+
+  scene->UpdateParents(data->frameTime);
+
+  physEnv->BeginFrame();
+  physEnv->ProceedDeltaTime(data->frameTime, data->timestep, data->framestep);
+
+  scene->UpdateParents(data->frameTime);
+}
+
+static void proceed_scene_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
+{
+  proceed_scene((KX_Scene *)taskdata, (KX_SceneProceedData *)BLI_task_pool_userdata(pool));
+}
+
+void KX_KetsjiEngine::ProceedScenesParallel(double timestep, double framestep)
+{
+  std::vector<KX_Scene *> proceedScenes;
+
+  // Logic and python stages, run serially in scene order.
+  for (KX_Scene *scene : m_scenes) {
+    CM_ProfileScope sceneScope("scene", scene->GetName());
 
-    // update system devices
     m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
-    if (m_inputDevice) {
-      m_inputDevice->ClearInputs();
+
+    scene->UpdateObjectActivity();
+
+    if (!scene->IsSuspended()) {
+      m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+#ifdef WITH_PYTHON
+      PHY_SetActiveEnvironment(scene->GetPhysicsEnvironment());
+#endif
+      KX_SetActiveScene(scene);
+
+      scene->GetPhysicsEnvironment()->EndFrame();
+
+      m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
+      scene->LogicBeginFrame(m_frameTime, framestep);
+
+      m_logger.StartLog(tc_scenegraph, m_kxsystem->GetTimeInSeconds());
+      scene->UpdateParents(m_frameTime);
+
+      m_logger.StartLog(tc_logic, m_kxsystem->GetTimeInSeconds());
+      scene->LogicUpdateFrame(m_frameTime);
+
+      scene->LogicEndFrame();
+
+      /* Only the scenes not suspended before their logic update are proceeded,
+       * as the serial loop would do. */
+      proceedScenes.push_back(scene);
     }
 
-    UpdateSuspendedScenes(framestep);
-    // scene management
-    ProcessScheduledScenes();
+    m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
+  }
 
-    frames--;
+  /* Barrier: no python code is run past this point until all scenes are proceeded.
+   * Each scene owns its scene graph and physics environment, the order of completion
+   * doesn't change the result. */
+  m_logger.StartLog(tc_physics, m_kxsystem->GetTimeInSeconds());
+
+  bool concurrent = (proceedScenes.size() > 1);
+  for (unsigned short i = 1, size = proceedScenes.size(); i < size && concurrent; ++i) {
+    concurrent = proceedScenes[0]->GetPhysicsEnvironment()->CanProceedConcurrently(
+        proceedScenes[i]->GetPhysicsEnvironment());
   }
 
-  // Start logging time spent outside main loop
-  m_logger.StartLog(tc_outside, m_kxsystem->GetTimeInSeconds());
+  KX_SceneProceedData data = {m_frameTime, timestep, framestep};
+  if (concurrent) {
+    TaskPool *pool = BLI_task_pool_create(GetParallelScheduler(), &data);
+    for (KX_Scene *scene : proceedScenes) {
+      BLI_task_pool_push(pool, proceed_scene_thread_func, scene, false, TASK_PRIORITY_HIGH);
+    }
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+  else {
+    for (KX_Scene *scene : proceedScenes) {
+      proceed_scene(scene, &data);
+    }
+  }
 
-  return doRender && m_doRender;
+  m_logger.StartLog(tc_services, m_kxsystem->GetTimeInSeconds());
+}
+
+void KX_KetsjiEngine::ProceedHeadlessScenes()
+{
+  m_logger.StartLog(tc_animations, m_kxsystem->GetTimeInSeconds());
+
+  for (KX_Scene *scene : m_scenes) {
+    UpdateAnimations(scene);
+    // No render will consume the moved objects.
+    scene->ClearTransformDirtyObjects();
+  }
 }
 
 void KX_KetsjiEngine::UpdateSuspendedScenes(double framestep)
@@ -501,9 +655,14 @@ KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
   if (usestereo) {
     rendercam = new KX_Camera(scene, scene->m_callbacks, *camera->GetCameraData(), true, true);
     rendercam->SetName("__stereo_" + camera->GetName() + "_" + std::to_string(eye) + "__");
-    rendercam->NodeSetGlobalOrientation(camera->NodeGetWorldOrientation());
-    rendercam->NodeSetWorldPosition(camera->NodeGetWorldPosition());
-    rendercam->NodeSetWorldScale(camera->NodeGetWorldScaling());
+    // The copy is placed at the interpolated transform of the camera when it is enabled.
+    MT_Vector3 campos;
+    MT_Matrix3x3 camori;
+    MT_Vector3 camscale;
+    camera->GetRenderTransform(campos, camori, camscale);
+    rendercam->NodeSetGlobalOrientation(camori);
+    rendercam->NodeSetWorldPosition(campos);
+    rendercam->NodeSetWorldScale(camscale);
     rendercam->NodeUpdateGS(0.0);
   }
   // Else use the native camera.
@@ -523,9 +682,21 @@ KX_KetsjiEngine::CameraRenderData KX_KetsjiEngine::GetCameraRenderData(
   // Compute the area and the viewport based on the current display area and the optional camera
   // viewport.
   GetSceneViewport(scene, rendercam, displayArea, area, viewport);
+
+  /* The camera is rendered at its interpolated transform as the other objects, it is read after
+   * the drawing callbacks which could have moved the camera. */
+  MT_Transform worldToCamera = rendercam->GetWorldToCamera();
+  if (m_flags & RENDER_INTERPOLATION) {
+    MT_Vector3 campos;
+    MT_Matrix3x3 camori;
+    MT_Vector3 camscale;
+    rendercam->GetRenderTransform(campos, camori, camscale);
+    worldToCamera.invert(MT_Transform(campos, camori));
+  }
+
   // Compute the camera matrices: modelview and projection.
   const MT_Matrix4x4 viewmat = m_rasterizer->GetViewMatrix(
-      eye, rendercam->GetWorldToCamera(), rendercam->GetCameraData()->m_perspective);
+      eye, worldToCamera, rendercam->GetCameraData()->m_perspective);
   const MT_Matrix4x4 projmat = GetCameraProjectionMatrix(scene, rendercam, eye, viewport, area);
   rendercam->SetModelviewMatrix(viewmat);
   rendercam->SetProjectionMatrix(projmat);
@@ -659,6 +830,8 @@ bool KX_KetsjiEngine::GetFrameRenderData(std::vector<FrameRenderData> &frameData
 
 void KX_KetsjiEngine::Render()
 {
+  CM_ProfileScope profileScope("render", "Render");
+
   m_logger.StartLog(tc_rasterizer, m_kxsystem->GetTimeInSeconds());
 
   BeginFrame();
@@ -816,6 +989,8 @@ void KX_KetsjiEngine::UpdateAnimations(KX_Scene *scene)
     return;
   }
 
+  CM_ProfileScope profileScope("animation", scene->GetName());
+
   // Handle the animations independently of the logic time step
   if (m_flags & RESTRICT_ANIMATION) {
     double anim_timestep = 1.0 / scene->GetAnimationFPS();
@@ -925,6 +1100,8 @@ void KX_KetsjiEngine::RenderCamera(KX_Scene *scene,
   // const RAS_Rect &area = cameraFrameData.m_area;
   const RAS_Rect &viewport = cameraFrameData.m_viewport;
 
+  CM_ProfileScope profileScope("render", scene->GetName());
+
   KX_SetActiveScene(scene);
 
   // set the viewport for this frame and scene
@@ -1018,7 +1195,9 @@ void KX_KetsjiEngine::StopEngine()
     }
 
     // cleanup all the stuff
-    m_rasterizer->Exit();
+    if (!(m_flags & HEADLESS)) {
+      m_rasterizer->Exit();
+    }
   }
 }
 
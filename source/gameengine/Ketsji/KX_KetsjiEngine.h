@@ -91,7 +91,17 @@ class KX_KetsjiEngine {
     /// Automatic add debug properties to the debug list.
     AUTO_ADD_DEBUG_PROPERTIES = (1 << 6),
     /// Use override camera?
-    CAMERA_OVERRIDE = (1 << 7)
+    CAMERA_OVERRIDE = (1 << 7),
+    /// Update scene graph and physics of all the scenes concurrently?
+    PARALLEL_SCENES = (1 << 8),
+    /// Update independent scene graph hierarchies concurrently?
+    PARALLEL_SCENEGRAPH = (1 << 9),
+    /// Sample looping armature actions from baked pose tables?
+    BAKE_LOOP_ACTIONS = (1 << 10),
+    /// Run without window, GPU context and render?
+    HEADLESS = (1 << 11),
+    /// Render between fixed logic frames with interpolated object transformations?
+    RENDER_INTERPOLATION = (1 << 12)
   };
 
  private:
@@ -232,6 +242,8 @@ class KX_KetsjiEngine {
 
   /// Task scheduler for multi-threading
   TaskScheduler *m_taskscheduler;
+  /// Task scheduler using all the cores, used to run frame stages concurrently.
+  TaskScheduler *m_parallelScheduler;
 
   /** Set scene's total pause duration for animations process.
    * This is done in a separate loop to get the proper state of each scenes.
@@ -245,6 +257,22 @@ class KX_KetsjiEngine {
    */
   void UpdateSuspendedScenes(double framestep);
 
+  /** Proceed one logic frame for all the scenes, one scene after the other.
+   * \param timestep The physics time step.
+   * \param framestep The logic frame duration.
+   */
+  void ProceedScenes(double timestep, double framestep);
+  /** Proceed one logic frame for all the scenes, logic and python of each scenes
+   * are run serially and the scene graph and physics update of all scenes are
+   * then run concurrently. A scene doesn't see the physics result of the previous
+   * scenes during its logic update as in ProceedScenes.
+   * \param timestep The physics time step.
+   * \param framestep The logic frame duration.
+   */
+  void ProceedScenesParallel(double timestep, double framestep);
+  /// Update what the render usually updates when running headless: the animations.
+  void ProceedHeadlessScenes();
+
   /// Update and return the projection matrix of a camera depending on the viewport.
   MT_Matrix4x4 GetCameraProjectionMatrix(KX_Scene *scene,
                                          KX_Camera *cam,
@@ -336,6 +364,9 @@ class KX_KetsjiEngine {
     return m_taskscheduler;
   }
 
+  /// Return the task scheduler using all the cores, created at the first call.
+  TaskScheduler *GetParallelScheduler();
+
   /// returns true if an update happened to indicate -> Render
   bool NextFrame();
   void Render();
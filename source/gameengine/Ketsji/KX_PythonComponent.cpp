@@ -32,12 +32,20 @@
 #  include "BKE_python_component.h"
 
 KX_PythonComponent::KX_PythonComponent(const std::string &name)
-    : m_pc(nullptr), m_gameobj(nullptr), m_name(name), m_init(false)
+    : m_pc(nullptr),
+      m_gameobj(nullptr),
+      m_name(name),
+      m_init(false),
+      m_update(nullptr),
+      m_updateInterval(1),
+      m_updatePhase(0),
+      m_updateIndex(-1)
 {
 }
 
 KX_PythonComponent::~KX_PythonComponent()
 {
+  Py_XDECREF(m_update);
 }
 
 std::string KX_PythonComponent::GetName()
@@ -66,6 +74,9 @@ void KX_PythonComponent::ProcessReplica()
   CValue::ProcessReplica();
   m_gameobj = nullptr;
   m_init = false;
+  // The bound method is owned by the original component.
+  m_update = nullptr;
+  m_updateIndex = -1;
 }
 
 KX_GameObject *KX_PythonComponent::GetGameObject() const
@@ -83,6 +94,21 @@ void KX_PythonComponent::SetBlenderPythonComponent(PythonComponent *pc)
   m_pc = pc;
 }
 
+void KX_PythonComponent::SetUpdatePhase(unsigned int phase)
+{
+  m_updatePhase = phase;
+}
+
+int KX_PythonComponent::GetUpdateIndex() const
+{
+  return m_updateIndex;
+}
+
+void KX_PythonComponent::SetUpdateIndex(int index)
+{
+  m_updateIndex = index;
+}
+
 void KX_PythonComponent::Start()
 {
   PyObject *arg_dict = (PyObject *)BKE_python_component_argument_dict_new(m_pc);
@@ -97,17 +123,35 @@ void KX_PythonComponent::Start()
   Py_XDECREF(ret);
 }
 
-void KX_PythonComponent::Update()
+void KX_PythonComponent::Update(unsigned int frame)
 {
   if (!m_init) {
     Start();
     m_init = true;
+
+    m_update = PyObject_GetAttrString(GetProxy(), "update");
+    if (!m_update) {
+      PyErr_Print();
+    }
+  }
+
+  if (!m_update || ((frame + m_updatePhase) % m_updateInterval) != 0) {
+    return;
   }
 
-  PyObject *pycomp = GetProxy();
-  if (!PyObject_CallMethod(pycomp, "update", "")) {
+  PyObject *ret = PyObject_CallObject(m_update, nullptr);
+  if (!ret) {
     PyErr_Print();
   }
+  Py_XDECREF(ret);
+}
+
+void KX_PythonComponent::Unregister()
+{
+  // The bound method references the component proxy.
+  Py_CLEAR(m_update);
+  m_init = false;
+  m_updateIndex = -1;
 }
 
 PyObject *KX_PythonComponent::py_component_new(PyTypeObject *type, PyObject *args, PyObject *kwds)
@@ -167,6 +211,7 @@ PyMethodDef KX_PythonComponent::Methods[] = {
 
 PyAttributeDef KX_PythonComponent::Attributes[] = {
     KX_PYATTRIBUTE_RO_FUNCTION("object", KX_PythonComponent, pyattr_get_object),
+    KX_PYATTRIBUTE_INT_RW("updateInterval", 1, 10000, true, KX_PythonComponent, m_updateInterval),
     KX_PYATTRIBUTE_NULL  // Sentinel
 };
 
@@ -37,6 +37,14 @@ class KX_PythonComponent : public CValue {
   KX_GameObject *m_gameobj;
   std::string m_name;
   bool m_init;
+  /// Bound update method, looked up once when the component starts.
+  PyObject *m_update;
+  /// Number of logic frames between two updates.
+  int m_updateInterval;
+  /// Offset of the update frames, spreads the components using the same interval.
+  unsigned int m_updatePhase;
+  /// Position of the component in the scene update list, -1 when not updated.
+  int m_updateIndex;
 
  public:
   KX_PythonComponent(const std::string &name);
@@ -53,8 +61,15 @@ class KX_PythonComponent : public CValue {
 
   void SetBlenderPythonComponent(PythonComponent *pc);
 
+  void SetUpdatePhase(unsigned int phase);
+  int GetUpdateIndex() const;
+  void SetUpdateIndex(int index);
+
   void Start();
-  void Update();
+  /// Start the component at the first call and update it when the frame matches its interval.
+  void Update(unsigned int frame);
+  /// Release the cached update method once the component is no longer updated.
+  void Unregister();
 
   static PyObject *py_component_new(PyTypeObject *type, PyObject *args, PyObject *kwds);
 
@@ -125,6 +125,7 @@ extern "C" {
 #include "KX_PythonInitTypes.h"
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
 /* we only need this to get a list of libraries from the main struct */
 #include "DNA_ID.h"
@@ -302,6 +303,56 @@ static PyObject *gPyGetProfileInfo(PyObject *)
   return KX_GetActiveEngine()->GetPyProfileDict();
 }
 
+PyDoc_STRVAR(gPyStartTrace_doc,
+             "startTrace([size])\n"
+             "starts recording the timed frame phases, keeping at most size events");
+static PyObject *gPyStartTrace(PyObject *, PyObject *args)
+{
+  int size = CM_Profiler::DEFAULT_NUM_EVENTS;
+  if (!PyArg_ParseTuple(args, "|i:startTrace", &size)) {
+    return nullptr;
+  }
+
+  if (size < 1) {
+    PyErr_SetString(PyExc_ValueError, "startTrace(size): size must be greater than 0");
+    return nullptr;
+  }
+
+  CM_Profiler::Start(size);
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPyStopTrace_doc,
+             "stopTrace()\n"
+             "stops recording the timed frame phases, the recorded events are kept");
+static PyObject *gPyStopTrace(PyObject *)
+{
+  CM_Profiler::Stop();
+  Py_RETURN_NONE;
+}
+
+PyDoc_STRVAR(gPySaveTrace_doc,
+             "saveTrace(filepath)\n"
+             "saves the recorded events as a Chrome trace event JSON file");
+static PyObject *gPySaveTrace(PyObject *, PyObject *args)
+{
+  char *filepath;
+  if (!PyArg_ParseTuple(args, "s:saveTrace", &filepath)) {
+    return nullptr;
+  }
+
+  char path[FILE_MAX];
+  BLI_strncpy(path, filepath, sizeof(path));
+  BLI_path_abs(path, KX_GetMainPath().c_str());
+
+  if (!CM_Profiler::Save(path)) {
+    PyErr_Format(PyExc_IOError, "saveTrace(filepath): can't write the file \"%s\"", path);
+    return nullptr;
+  }
+
+  return PyLong_FromLong(CM_Profiler::GetNumEvents());
+}
+
 PyDoc_STRVAR(gPySendMessage_doc,
              "sendMessage(subject, [body, to, from])\n"
              "sends a message in same manner as a message actuator"
@@ -711,7 +762,7 @@ static PyObject *gLibNew(PyObject *, PyObject *args)
 
   KX_BlenderConverter *converter = KX_GetActiveEngine()->GetConverter();
 
-  if (converter->GetMainDynamicPath(path)) {
+  if (converter->IsBlendFileLinked(path)) {
     PyErr_SetString(PyExc_KeyError, "the name of the path given exists");
     return nullptr;
   }
@@ -781,6 +832,27 @@ static PyObject *gLibList(PyObject *, PyObject *args)
   return list;
 }
 
+static PyObject *gLibSetMergeBudget(PyObject *, PyObject *args)
+{
+  double budget;
+  if (!PyArg_ParseTuple(args, "d:setLibLoadMergeBudget", &budget))
+    return nullptr;
+
+  if (budget < 0.0) {
+    PyErr_SetString(PyExc_ValueError,
+                    "setLibLoadMergeBudget(time): time must be positive, 0 for no limit");
+    return nullptr;
+  }
+
+  KX_GetActiveEngine()->GetConverter()->SetMergeTimeBudget(budget);
+  Py_RETURN_NONE;
+}
+
+static PyObject *gLibGetMergeBudget(PyObject *)
+{
+  return PyFloat_FromDouble(KX_GetActiveEngine()->GetConverter()->GetMergeTimeBudget());
+}
+
 struct PyNextFrameState pynextframestate;
 static PyObject *gPyNextFrame(PyObject *)
 {
@@ -938,14 +1010,37 @@ static struct PyMethodDef game_methods[] = {
      METH_NOARGS,
      (const char *)"Render next frame (if Python has control)"},
     {"getProfileInfo", (PyCFunction)gPyGetProfileInfo, METH_NOARGS, gPyGetProfileInfo_doc},
+    {"startTrace", (PyCFunction)gPyStartTrace, METH_VARARGS, gPyStartTrace_doc},
+    {"stopTrace", (PyCFunction)gPyStopTrace, METH_NOARGS, gPyStopTrace_doc},
+    {"saveTrace", (PyCFunction)gPySaveTrace, METH_VARARGS, gPySaveTrace_doc},
     /* library functions */
     {"LibLoad", (PyCFunction)gLibLoad, METH_VARARGS | METH_KEYWORDS, (const char *)""},
     {"LibNew", (PyCFunction)gLibNew, METH_VARARGS, (const char *)""},
     {"LibFree", (PyCFunction)gLibFree, METH_VARARGS, (const char *)""},
     {"LibList", (PyCFunction)gLibList, METH_VARARGS, (const char *)""},
+    {"setLibLoadMergeBudget",
+     (PyCFunction)gLibSetMergeBudget,
+     METH_VARARGS,
+     (const char *)"Sets the time spent per frame to merge asynchronously loaded libraries"},
+    {"getLibLoadMergeBudget",
+     (PyCFunction)gLibGetMergeBudget,
+     METH_NOARGS,
+     (const char *)"Gets the time spent per frame to merge asynchronously loaded libraries"},
 
     {nullptr, (PyCFunction) nullptr, 0, nullptr}};
 
+/** Raise a RuntimeError for the functions using the GPU when the engine runs headless.
+ * \return false if the function is not available.
+ */
+static bool CheckRenderAvailable(const char *name)
+{
+  if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS)) {
+    PyErr_Format(PyExc_RuntimeError, "Rasterizer.%s: not available in headless mode", name);
+    return false;
+  }
+  return true;
+}
+
 static PyObject *gPyGetWindowHeight(PyObject *, PyObject *args)
 {
   RAS_ICanvas *canvas = KX_GetActiveEngine()->GetCanvas();
@@ -1081,6 +1176,10 @@ static PyObject *gPyMakeScreenshot(PyObject *, PyObject *args)
   if (!PyArg_ParseTuple(args, "s:makeScreenshot", &filename))
     return nullptr;
 
+  if (!CheckRenderAvailable("makeScreenshot(filename)")) {
+    return nullptr;
+  }
+
   RAS_ICanvas *canvas = KX_GetActiveEngine()->GetCanvas();
 
   if (canvas) {
@@ -1125,6 +1224,10 @@ static PyObject *gPySetGLSLMaterialSetting(PyObject *, PyObject *args, PyObject
   if (!PyArg_ParseTuple(args, "si:setGLSLMaterialSetting", &setting, &enable))
     return nullptr;
 
+  if (!CheckRenderAvailable("setGLSLMaterialSetting(setting, enable)")) {
+    return nullptr;
+  }
+
   flag = getGLSLSettingFlag(setting);
 
   if (flag == -1) {
@@ -1212,6 +1315,10 @@ static PyObject *gPySetAnisotropicFiltering(PyObject *, PyObject *args)
     return nullptr;
   }
 
+  if (!CheckRenderAvailable("setAnisotropicFiltering(level)")) {
+    return nullptr;
+  }
+
   KX_GetActiveEngine()->GetRasterizer()->SetAnisotropicFiltering(level);
 
   Py_RETURN_NONE;
@@ -1219,6 +1326,10 @@ static PyObject *gPySetAnisotropicFiltering(PyObject *, PyObject *args)
 
 static PyObject *gPyGetAnisotropicFiltering(PyObject *, PyObject *args)
 {
+  if (!CheckRenderAvailable("getAnisotropicFiltering()")) {
+    return nullptr;
+  }
+
   return PyLong_FromLong(KX_GetActiveEngine()->GetRasterizer()->GetAnisotropicFiltering());
 }
 
@@ -1228,6 +1339,10 @@ static PyObject *gPyDrawLine(PyObject *, PyObject *args)
   PyObject *ob_to;
   PyObject *ob_color;
 
+  if (!CheckRenderAvailable("drawLine(obFrom, obTo, color)")) {
+    return nullptr;
+  }
+
   if (!KX_GetActiveEngine()->GetRasterizer()) {
     PyErr_SetString(PyExc_RuntimeError,
                     "Rasterizer.drawLine(obFrom, obTo, color): Rasterizer not available");
@@ -1297,6 +1412,10 @@ static PyObject *gPySetMipmapping(PyObject *, PyObject *args)
     return nullptr;
   }
 
+  if (!CheckRenderAvailable("setMipmapping(val)")) {
+    return nullptr;
+  }
+
   if (!KX_GetActiveEngine()->GetRasterizer()) {
     PyErr_SetString(PyExc_RuntimeError, "Rasterizer.setMipmapping(val): Rasterizer not available");
     return nullptr;
@@ -1308,6 +1427,10 @@ static PyObject *gPySetMipmapping(PyObject *, PyObject *args)
 
 static PyObject *gPyGetMipmapping(PyObject *)
 {
+  if (!CheckRenderAvailable("getMipmapping()")) {
+    return nullptr;
+  }
+
   if (!KX_GetActiveEngine()->GetRasterizer()) {
     PyErr_SetString(PyExc_RuntimeError, "Rasterizer.getMipmapping(): Rasterizer not available");
     return nullptr;
@@ -1329,6 +1452,10 @@ static PyObject *gPySetVsync(PyObject *, PyObject *args)
     return nullptr;
   }
 
+  if (!CheckRenderAvailable("setVsync(value)")) {
+    return nullptr;
+  }
+
   if (interval == VSYNC_ADAPTIVE)
     interval = -1;
   KX_GetActiveEngine()->GetCanvas()->SetSwapInterval((interval == VSYNC_ON) ? 1 : 0);
@@ -1337,6 +1464,10 @@ static PyObject *gPySetVsync(PyObject *, PyObject *args)
 
 static PyObject *gPyGetVsync(PyObject *)
 {
+  if (!CheckRenderAvailable("getVsync()")) {
+    return nullptr;
+  }
+
   int interval = 0;
   KX_GetActiveEngine()->GetCanvas()->GetSwapInterval(interval);
   return PyLong_FromLong(interval);
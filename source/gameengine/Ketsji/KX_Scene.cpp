@@ -40,6 +40,7 @@
 #include "KX_KetsjiEngine.h"
 #include "KX_BlenderMaterial.h"
 #include "KX_FontObject.h"
+#include "KX_PythonComponent.h"
 #include "RAS_IPolygonMaterial.h"
 #include "EXP_ListValue.h"
 #include "SCA_LogicManager.h"
@@ -52,6 +53,7 @@
 #include "SCA_ActuatorEventManager.h"
 #include "SCA_BasicEventManager.h"
 #include "KX_Camera.h"
+#include "KX_ClientObjectInfo.h"
 #include "SCA_JoystickManager.h"
 #include "KX_PyMath.h"
 #include "RAS_MeshObject.h"
@@ -73,6 +75,7 @@
 #include "SCA_IActuator.h"
 #include "SG_Node.h"
 #include "SG_Controller.h"
+#include "SG_Familly.h"
 #include "SG_Node.h"
 #include "DNA_scene_types.h"
 #include "DNA_property_types.h"
@@ -102,6 +105,8 @@
 
 #include "CM_Message.h"
 
+#include <unordered_map>
+
 /**************************EEVEE INTEGRATION*****************************/
 #include "MEM_guardedalloc.h"
 
@@ -115,6 +120,7 @@ extern "C" {
 #include "depsgraph/DEG_depsgraph_query.h"
 #include "ED_view3d.h"
 #include "DNA_mesh_types.h"
+#include "DNA_modifier_types.h"
 #include "DNA_windowmanager_types.h"
 #include "DRW_render.h"
 #include "GPU_matrix.h"
@@ -170,6 +176,7 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
                    class RAS_ICanvas *canvas,
                    KX_NetworkMessageManager *messageManager)
     : CValue(),
+      m_replicaObjectPoolDirty(false),
       m_resetTaaSamples(false),               // eevee
       m_lastReplicatedParentObject(nullptr),  // eevee
       m_gameDefaultCamera(nullptr),           // eevee
@@ -195,6 +202,10 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
   m_dbvt_culling = false;
   m_dbvt_occlusion_res = 0;
   m_activity_culling = false;
+  m_interpolationFactor = 1.0f;
+  m_componentFrame = 0;
+  m_componentPhase = 0;
+  m_unregisteredComponents = 0;
   m_suspend = false;
   m_objectlist = new CListValue<KX_GameObject>();
   m_parentlist = new CListValue<KX_GameObject>();
@@ -242,12 +253,12 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
       m_obstacleSimulation = nullptr;
   }
 
-  m_animationPool = BLI_task_pool_create(KX_GetActiveEngine()->GetTaskScheduler(),
-                                         &m_animationPoolData);
+  // Created at the first animation update, to not start the parallel scheduler for nothing.
+  m_animationPool = nullptr;
 
   /*************************************************EEVEE
    * INTEGRATION***********************************************************/
-  m_staticObjects = {};
+  m_transformDirtyObjects = {};
 
   Main *bmain = KX_GetActiveEngine()->GetConverter()->GetMain();
   ViewLayer *view_layer = BKE_view_layer_default_view(scene);
@@ -279,13 +290,24 @@ KX_Scene::KX_Scene(SCA_IInputDevice *inputDevice,
    * InitBlenderContextVariables(); each frame before wm_draw_update
    * (blenderplayer_viewport branch).
    */
-  InitBlenderContextVariables();
+  const bool headless = KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS);
+  if (!headless) {
+    InitBlenderContextVariables();
+  }
 
   /* If there is no Aregion, we know that we're in blenderplayer (for now) */
   ARegion *ar = canvas->GetARegion();
 
-  if ((scene->gm.flag & GAME_USE_VIEWPORT_RENDER) == 0 ||
-      !ar) {  // if no ar, we are in blenderplayer
+  if (headless) {
+    /* No render and no GPU viewport, only the evaluated depsgraph is needed
+     * by the conversion. */
+    scene->flag |= SCE_INTERACTIVE;
+
+    Depsgraph *depsgraph = BKE_scene_get_depsgraph(bmain, scene, view_layer, true);
+    BKE_scene_graph_update_tagged(depsgraph, bmain);
+  }
+  else if ((scene->gm.flag & GAME_USE_VIEWPORT_RENDER) == 0 ||
+           !ar) {  // if no ar, we are in blenderplayer
     /* We want to indicate that we are in bge runtime. The flag can be used in draw code but in
      * depsgraph code too later */
     scene->flag |= SCE_INTERACTIVE;
@@ -326,8 +348,10 @@ KX_Scene::~KX_Scene()
   ViewLayer *view_layer = BKE_view_layer_default_view(scene);
   Main *bmain = KX_GetActiveEngine()->GetConverter()->GetMain();
 
-  if ((scene->gm.flag & GAME_USE_VIEWPORT_RENDER) == 0 ||
-      !ar) {  // if no ar, we are in blenderplayer
+  // Nothing was rendered when running headless.
+  const bool headless = KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS);
+  if (!headless && ((scene->gm.flag & GAME_USE_VIEWPORT_RENDER) == 0 ||
+                    !ar)) {  // if no ar, we are in blenderplayer
     if (m_shadingTypeBackup != 0) {
       View3D *v3d = CTX_wm_view3d(KX_GetActiveEngine()->GetContext());
       v3d->shading.type = m_shadingTypeBackup;
@@ -344,6 +368,8 @@ KX_Scene::~KX_Scene()
     DEG_id_tag_update(&scene->id, ID_RECALC_BASE_FLAGS);
   }
 
+  FreeReplicaObjectPool(false);
+
   scene->eevee.taa_samples = m_taaSamplesBackup;
   DEG_id_tag_update(&scene->id, ID_RECALC_COPY_ON_WRITE);
 
@@ -406,6 +432,10 @@ KX_Scene::~KX_Scene()
   if (m_logicmgr)
     delete m_logicmgr;
 
+  for (std::map<int, Snapshot>::value_type &pair : m_snapshots) {
+    delete pair.second.m_physicsSnapshot;
+  }
+
   if (m_physicsEnvironment)
     delete m_physicsEnvironment;
 
@@ -445,6 +475,186 @@ void KX_Scene::ResetLastReplicatedParentObject()
   m_lastReplicatedParentObject = nullptr;
 }
 
+/// Copy a blender object for a replica and link it where the active camera is.
+static Object *new_replica_object(Main *bmain, Scene *scene, Object *original)
+{
+  Object *newob;
+  BKE_id_copy_ex(bmain, &original->id, (ID **)&newob, 0);
+  ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+  BKE_collection_object_add_from(bmain, scene, BKE_view_layer_camera_find(view_layer), newob);
+  newob->base_flag |= (BASE_VISIBLE_VIEWLAYER | BASE_VISIBLE_DEPSGRAPH);
+
+  return newob;
+}
+
+/** Hide or show a pooled blender object without rebuilding the depsgraph relations,
+ * the layer collections are synced later by KX_Scene::SyncReplicaObjectPool.
+ */
+static void set_replica_object_hidden(Scene *scene, Object *ob, bool hidden)
+{
+  ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+  Base *base = BKE_view_layer_base_find(view_layer, ob);
+  if (!base) {
+    return;
+  }
+
+  if (hidden) {
+    base->flag |= BASE_HIDDEN;
+  }
+  else {
+    base->flag &= ~BASE_HIDDEN;
+  }
+}
+
+/// Reset the data a previous replica could have changed in a pooled blender object.
+static void reset_replica_object(Object *ob, Object *original)
+{
+  copy_v4_v4(ob->color, original->color);
+  copy_v3_v3(ob->loc, original->loc);
+  copy_v3_v3(ob->rot, original->rot);
+  copy_qt_qt(ob->quat, original->quat);
+  copy_v3_v3(ob->rotAxis, original->rotAxis);
+  ob->rotAngle = original->rotAngle;
+  copy_v3_v3(ob->scale, original->scale);
+  copy_m4_m4(ob->obmat, original->obmat);
+  copy_m4_m4(ob->parentinv, original->parentinv);
+  ob->parent = original->parent;
+  ob->partype = original->partype;
+
+  // The modifiers are copied from the original, in the same order.
+  ModifierData *origmd = (ModifierData *)original->modifiers.first;
+  for (ModifierData *md = (ModifierData *)ob->modifiers.first; md && origmd;
+       md = md->next, origmd = origmd->next) {
+    if (md->type == eModifierType_Armature) {
+      ((ArmatureModifierData *)md)->object = ((ArmatureModifierData *)origmd)->object;
+    }
+  }
+}
+
+static void free_replica_object(Main *bmain, Scene *scene, Object *ob)
+{
+  BKE_scene_collections_object_remove(bmain, scene, ob, true);
+  BKE_id_free(bmain, &ob->id);
+}
+
+void KX_Scene::SetReplicaPoolSize(KX_GameObject *original, unsigned int size)
+{
+  Object *ob = original->GetBlenderObject();
+  if (!ob) {
+    return;
+  }
+
+  // The replicas of parents and children are linked to the last replicated parent.
+  if (ob->parent || !original->GetSGNode()->GetSGChildren().empty()) {
+    CM_Warning("object \"" << original->GetName()
+                           << "\" has a parent or children, its replicas can't be pooled");
+    return;
+  }
+
+  Main *bmain = KX_GetActiveEngine()->GetConverter()->GetMain();
+  Scene *scene = GetBlenderScene();
+  std::vector<Object *> &pool = m_replicaObjectPool[ob];
+  m_replicaObjectPoolSize[ob] = size;
+
+  if (pool.size() == size) {
+    return;
+  }
+
+  while (pool.size() > size) {
+    free_replica_object(bmain, scene, pool.back());
+    pool.pop_back();
+  }
+
+  ViewLayer *view_layer = BKE_view_layer_default_view(scene);
+  while (pool.size() < size) {
+    Object *newob = new_replica_object(bmain, scene, ob);
+    Base *base = BKE_view_layer_base_find(view_layer, newob);
+    if (base) {
+      base->flag |= BASE_HIDDEN;
+    }
+    pool.push_back(newob);
+  }
+
+  m_replicaObjectPoolDirty = true;
+  // Only one relations update for the whole pool.
+  DEG_relations_tag_update(bmain);
+}
+
+Object *KX_Scene::GetPooledReplicaObject(Object *original)
+{
+  std::map<Object *, std::vector<Object *>>::iterator it = m_replicaObjectPool.find(original);
+  if (it == m_replicaObjectPool.end() || it->second.empty()) {
+    return nullptr;
+  }
+
+  Object *ob = it->second.back();
+  it->second.pop_back();
+
+  reset_replica_object(ob, original);
+  set_replica_object_hidden(GetBlenderScene(), ob, false);
+  m_replicaObjectPoolDirty = true;
+  DEG_id_tag_update(&ob->id, ID_RECALC_TRANSFORM | ID_RECALC_GEOMETRY);
+
+  return ob;
+}
+
+bool KX_Scene::ReleasePooledReplicaObject(Object *original, Object *replica)
+{
+  std::map<Object *, unsigned int>::const_iterator it = m_replicaObjectPoolSize.find(original);
+  if (it == m_replicaObjectPoolSize.end()) {
+    return false;
+  }
+
+  std::vector<Object *> &pool = m_replicaObjectPool[original];
+  if (pool.size() >= it->second) {
+    return false;
+  }
+
+  set_replica_object_hidden(GetBlenderScene(), replica, true);
+  m_replicaObjectPoolDirty = true;
+  pool.push_back(replica);
+
+  return true;
+}
+
+void KX_Scene::FreeReplicaObjectPool(bool taggedOnly)
+{
+  Main *bmain = KX_GetActiveEngine()->GetConverter()->GetMain();
+  Scene *scene = GetBlenderScene();
+  bool freed = false;
+
+  for (std::map<Object *, std::vector<Object *>>::iterator it = m_replicaObjectPool.begin();
+       it != m_replicaObjectPool.end();) {
+    if (taggedOnly && !IS_TAGGED(it->first)) {
+      ++it;
+      continue;
+    }
+
+    for (Object *ob : it->second) {
+      free_replica_object(bmain, scene, ob);
+      freed = true;
+    }
+    m_replicaObjectPoolSize.erase(it->first);
+    it = m_replicaObjectPool.erase(it);
+  }
+
+  if (freed) {
+    DEG_relations_tag_update(bmain);
+  }
+}
+
+void KX_Scene::SyncReplicaObjectPool()
+{
+  if (!m_replicaObjectPoolDirty) {
+    return;
+  }
+
+  Scene *scene = GetBlenderScene();
+  BKE_layer_collection_sync(scene, BKE_view_layer_default_view(scene));
+  DEG_id_tag_update(&scene->id, ID_RECALC_BASE_FLAGS);
+  m_replicaObjectPoolDirty = false;
+}
+
 /*******************EEVEE INTEGRATION******************/
 void KX_Scene::InitBlenderContextVariables()
 {
@@ -534,7 +744,12 @@ Object *KX_Scene::GetGameDefaultCamera()
 
 bool KX_Scene::ObjectsAreStatic()
 {
-  return GetObjectList()->GetCount() == m_staticObjects.size();
+  for (KX_GameObject *gameobj : m_transformDirtyObjects) {
+    if (!gameobj->IsStatic()) {
+      return false;
+    }
+  }
+  return true;
 }
 
 void KX_Scene::ResetTaaSamples()
@@ -542,6 +757,71 @@ void KX_Scene::ResetTaaSamples()
   m_resetTaaSamples = true;
 }
 
+void KX_Scene::AppendToInterpolationDirtyObjects(KX_GameObject *gameobj)
+{
+  gameobj->SetInterpolationDirtyIndex(m_interpolationDirtyObjects.size());
+  m_interpolationDirtyObjects.push_back(gameobj);
+}
+
+void KX_Scene::RemoveFromInterpolatedObjects(KX_GameObject *gameobj)
+{
+  if (gameobj->IsInterpolationDirty()) {
+    const unsigned int index = gameobj->GetInterpolationDirtyIndex();
+    KX_GameObject *last = m_interpolationDirtyObjects.back();
+    m_interpolationDirtyObjects[index] = last;
+    last->SetInterpolationDirtyIndex(index);
+    m_interpolationDirtyObjects.pop_back();
+    gameobj->ClearInterpolationDirty();
+  }
+
+  if (gameobj->IsInterpolated()) {
+    const unsigned int index = gameobj->GetInterpolatedIndex();
+    KX_GameObject *last = m_interpolatedObjects.back();
+    m_interpolatedObjects[index] = last;
+    last->SetInterpolatedIndex(index);
+    m_interpolatedObjects.pop_back();
+    gameobj->StopInterpolation();
+  }
+}
+
+void KX_Scene::UpdateInterpolatedObjects()
+{
+  /* The objects which stopped moving are rendered at their last transform,
+   * they must be synchronized once more. */
+  for (KX_GameObject *gameobj : m_interpolatedObjects) {
+    if (!gameobj->IsInterpolationDirty()) {
+      gameobj->StopInterpolation();
+      gameobj->SetTransformDirty();
+    }
+  }
+
+  // The moved objects keep their positions in the interpolated list after the swap.
+  for (unsigned int i = 0, size = m_interpolationDirtyObjects.size(); i < size; ++i) {
+    KX_GameObject *gameobj = m_interpolationDirtyObjects[i];
+    gameobj->ClearInterpolationDirty();
+    gameobj->StartInterpolation();
+    gameobj->SetInterpolatedIndex(i);
+  }
+
+  m_interpolatedObjects.swap(m_interpolationDirtyObjects);
+  m_interpolationDirtyObjects.clear();
+}
+
+void KX_Scene::InterpolateObjects(float factor)
+{
+  m_interpolationFactor = factor;
+
+  // The interpolated objects are moving at each render.
+  for (KX_GameObject *gameobj : m_interpolatedObjects) {
+    gameobj->SetTransformDirty();
+  }
+}
+
+float KX_Scene::GetInterpolationFactor() const
+{
+  return m_interpolationFactor;
+}
+
 void KX_Scene::AddOverlayCollection(KX_Camera *overlay_cam, Collection *collection)
 {
   /* Check for already added collections */
@@ -686,15 +966,23 @@ void KX_Scene::RenderAfterCameraSetup(KX_Camera *cam, bool is_overlay_pass)
     depsgraph = BKE_scene_get_depsgraph(bmain, scene, view_layer, true);
   }
 
+  // Objects can be added or removed outside of the logic, e.g. from drawing callbacks.
+  SyncReplicaObjectPool();
   BKE_scene_graph_update_tagged(depsgraph, bmain);
 
-  for (KX_GameObject *gameobj : GetObjectList()) {
+  // Only the objects moved since the last render need to be synchronized.
+  for (KX_GameObject *gameobj : m_transformDirtyObjects) {
     gameobj->TagForUpdate(is_overlay_pass);
   }
 
   bool reset_taa_samples = !ObjectsAreStatic() || m_resetTaaSamples;
   m_resetTaaSamples = false;
-  m_staticObjects.clear();
+
+  /* Keep the dirty objects until the end of all render passes (main + overlay),
+   * see KX_GameObject::TagForUpdate. */
+  if (!GetOverlayCamera() || is_overlay_pass) {
+    ClearTransformDirtyObjects();
+  }
 
   const RAS_Rect *viewport = &canvas->GetViewportArea();
   int v[4] = {viewport->GetLeft(),
@@ -810,7 +1098,9 @@ void KX_Scene::RenderAfterCameraSetupImageRender(KX_Camera *cam,
 
   BKE_scene_graph_update_tagged(depsgraph, bmain);
 
-  for (KX_GameObject *gameobj : GetObjectList()) {
+  /* The dirty objects are cleared after the main render, see
+   * RenderAfterCameraSetup. */
+  for (KX_GameObject *gameobj : m_transformDirtyObjects) {
     gameobj->TagForUpdate(false);
   }
 
@@ -924,6 +1214,18 @@ void KX_Scene::Resume()
 void KX_Scene::SetActivityCulling(bool b)
 {
   m_activity_culling = b;
+  // The grid is rebuilt with all the objects when the culling is enabled again.
+  m_activityGrid.Clear();
+}
+
+bool KX_Scene::GetActivityCulling() const
+{
+  return m_activity_culling;
+}
+
+void KX_Scene::AppendToActivityDirtyObjects(KX_GameObject *gameobj)
+{
+  m_activityGrid.AddDirtyObject(gameobj);
 }
 
 bool KX_Scene::IsSuspended()
@@ -978,7 +1280,7 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
   for (int i = 0; i < numprops; i++) {
     CValue *prop = newobj->GetProperty(i);
 
-    if (prop->GetProperty("timer"))
+    if (prop->GetProperty(SCA_TimeEventManager::sTimerKey))
       this->m_timemgr->AddTimeProperty(prop);
   }
 
@@ -1013,6 +1315,9 @@ KX_GameObject *KX_Scene::AddNodeReplicaObject(SG_Node *node, KX_GameObject *game
 
   // this is the list of object that are send to the graphics pipeline
   m_objectlist->Add(CM_AddRef(newobj));
+  RegisterComponents(newobj);
+  // The blender object of the replica must be placed at next render.
+  newobj->SetTransformDirty();
   switch (newobj->GetGameObjectType()) {
     case SCA_IObject::OBJ_LIGHT: {
       m_lightlist->Add(CM_AddRef(static_cast<KX_LightObject *>(newobj)));
@@ -1340,7 +1645,7 @@ KX_GameObject *KX_Scene::AddReplicaObject(KX_GameObject *originalobject,
     // 50 frames per second if you change this value, make sure you change it in
     // KX_GameObject::pyattr_get_life property too
     CValue *fval = new CFloatValue(lifespan * 0.02f);
-    replica->SetProperty("::timebomb", fval);
+    replica->SetProperty(KX_GameObject::sTimebombKey, fval);
     fval->Release();
   }
 
@@ -1494,7 +1799,7 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   for (int i = 0; i < numprops; i++) {
     CValue *propval = gameobj->GetProperty(i);
-    if (propval->GetProperty("timer")) {
+    if (propval->GetProperty(SCA_TimeEventManager::sTimerKey)) {
       m_timemgr->RemoveTimeProperty(propval);
     }
   }
@@ -1518,6 +1823,16 @@ bool KX_Scene::NewRemoveObject(KX_GameObject *gameobj)
 
   gameobj->RemoveMeshes();
 
+  // The object may be freed by the release from the lists, unregister it before.
+  m_activityGrid.RemoveObject(gameobj);
+  UnregisterComponents(gameobj);
+
+  if (gameobj->IsTransformDirty()) {
+    RemoveFromTransformDirtyObjects(gameobj);
+  }
+
+  RemoveFromInterpolatedObjects(gameobj);
+
   bool ret = true;
   if (gameobj->GetGameObjectType() == SCA_IObject::OBJ_LIGHT &&
       m_lightlist->RemoveValue(static_cast<KX_LightObject *>(gameobj)))
@@ -1705,13 +2020,14 @@ void KX_Scene::LogicBeginFrame(double curtime, double framestep)
 {
   // have a look at temp objects ...
   for (KX_GameObject *gameobj : m_tempObjectList) {
-    CFloatValue *propval = (CFloatValue *)gameobj->GetProperty("::timebomb");
+    CFloatValue *propval = (CFloatValue *)gameobj->GetProperty(KX_GameObject::sTimebombKey);
 
     if (propval) {
       const float timeleft = propval->GetNumber() - framestep;
 
       if (timeleft > 0) {
         propval->SetFloat(timeleft);
+        gameobj->PropertyModified(KX_GameObject::sTimebombKey);
       }
       else {
         // remove obj, remove the object from tempObjectList in NewRemoveObject only.
@@ -1737,8 +2053,7 @@ void KX_Scene::AddAnimatedObject(KX_GameObject *gameobj)
 
 static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
 {
-  KX_GameObject *gameobj, *parent;
-  CListValue<KX_GameObject> *children;
+  KX_GameObject *gameobj;
   bool needs_update;
   KX_Scene::AnimationPoolData *data = (KX_Scene::AnimationPoolData *)BLI_task_pool_userdata(pool);
   double curtime = data->curtime;
@@ -1751,73 +2066,188 @@ static void update_anim_thread_func(TaskPool *pool, void *taskdata, int UNUSED(t
   if (!needs_update) {
     // If we got here, we're looking to update an armature, so check its children meshes
     // to see if we need to bother with a more expensive pose update
-    children = gameobj->GetChildren();
+    bool has_mesh = false;
 
-    bool has_mesh = false, has_non_mesh = false;
+    // Check for meshes that haven't been culled, see KX_Scene::UpdateAnimationsCulling.
+    for (SG_Node *childnode : gameobj->GetSGNode()->GetSGChildren()) {
+      KX_GameObject *child = static_cast<KX_GameObject *>(childnode->GetSGClientObject());
+      if (!child) {
+        continue;
+      }
 
-    // Check for meshes that haven't been culled
-    for (KX_GameObject *child : children) {
-      // if (!child->GetCulled()) { // eevee disable armature animation culling
-      needs_update = true;
-      break;
-      //}
+      if (!child->GetCulled()) {
+        needs_update = true;
+        break;
+      }
 
-      if (child->GetMeshCount() == 0)
-        has_non_mesh = true;
-      else
+      if (child->GetMeshCount() != 0) {
         has_mesh = true;
+      }
     }
 
     // If we didn't find a non-culled mesh, check to see
     // if we even have any meshes, and update if this
-    // armature has only non-mesh children.
-    if (!needs_update && !has_mesh && has_non_mesh)
+    // armature has no mesh children (e.g bones used by logic).
+    if (!needs_update && !has_mesh) {
       needs_update = true;
-
-    children->Release();
+    }
   }
 
   // If the object is a culled armature, then we manage only the animation time and end of its
   // animations.
   gameobj->UpdateActionManager(curtime, needs_update);
+}
 
-  if (needs_update) {
-    children = gameobj->GetChildren();
-    parent = gameobj->GetParent();
+void KX_Scene::UpdateAnimationsCulling()
+{
+  KX_Camera *cam = (m_overrideCullingCamera) ? m_overrideCullingCamera : GetActiveCamera();
 
-    children->Release();
+  Main *bmain = KX_GetActiveEngine()->GetConverter()->GetMain();
+  ViewLayer *view_layer = BKE_view_layer_default_view(m_blenderScene);
+  Depsgraph *depsgraph = BKE_scene_get_depsgraph(bmain, m_blenderScene, view_layer, false);
+
+  /* Without culling all the armatures children are considered visible, it's the case
+   * when running headless as the camera frustum is never computed. */
+  const bool headless = KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS);
+  const SG_Frustum *frustum = (cam && cam->GetFrustumCulling() && depsgraph && !headless) ?
+                                  &cam->GetFrustum() :
+                                  nullptr;
+
+  /* The bounding boxes are computed lazily by blender, the culling is then done
+   * before dispatching the animations to the threads. */
+  for (KX_GameObject *gameobj : m_animatedlist) {
+    if (gameobj->GetGameObjectType() != SCA_IObject::OBJ_ARMATURE) {
+      continue;
+    }
+
+    for (SG_Node *childnode : gameobj->GetSGNode()->GetSGChildren()) {
+      KX_GameObject *child = static_cast<KX_GameObject *>(childnode->GetSGClientObject());
+      if (!child) {
+        continue;
+      }
+
+      bool culled = false;
+      if (frustum) {
+        Object *ob = child->GetBlenderObject();
+        BoundBox *bb = nullptr;
+        if (ob && child->GetMeshCount() != 0) {
+          bb = BKE_object_boundbox_get(DEG_get_evaluated_object(depsgraph, ob));
+        }
+
+        // Children without mesh are never visible.
+        if (!bb) {
+          culled = true;
+        }
+        else {
+          const MT_Matrix4x4 mat(child->NodeGetWorldTransform());
+          culled = (frustum->AabbInsideFrustum(
+                        MT_Vector3(bb->vec[0]), MT_Vector3(bb->vec[6]), mat) ==
+                    SG_Frustum::OUTSIDE);
+        }
+      }
+
+      child->SetCulled(culled);
+    }
   }
 }
 
 void KX_Scene::UpdateAnimations(double curtime)
 {
-  // m_animationPoolData.curtime = curtime;
+  UpdateAnimationsCulling();
+
+  if (m_animatedlist.empty()) {
+    return;
+  }
+
+  if (!m_animationPool) {
+    m_animationPool = BLI_task_pool_create(KX_GetActiveEngine()->GetParallelScheduler(),
+                                           &m_animationPoolData);
+  }
+
+  m_animationPoolData.curtime = curtime;
 
   for (KX_GameObject *gameobj : m_animatedlist) {
-    // BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false,
-    // TASK_PRIORITY_LOW);
-    gameobj->UpdateActionManager(curtime, true);
+    // The animations of the objects suspended by the activity culling are frozen.
+    if (gameobj->IsActivitySuspended()) {
+      continue;
+    }
+    BLI_task_pool_push(m_animationPool, update_anim_thread_func, gameobj, false, TASK_PRIORITY_LOW);
   }
 
-  // BLI_task_pool_work_and_wait(m_animationPool);
+  BLI_task_pool_work_and_wait(m_animationPool);
 }
 
-void KX_Scene::LogicUpdateFrame(double curtime)
+void KX_Scene::RegisterComponents(KX_GameObject *gameobj)
 {
-  /* Update object components, we copy the object pointer in a second list to make sure that we
-   * iterate on a list which will not be modified, indeed components can add objects in theirs
-   * initialization.
-   */
+#ifdef WITH_PYTHON
+  CListValue<KX_PythonComponent> *components = gameobj->GetComponents();
+  if (!components) {
+    return;
+  }
 
-  std::vector<KX_GameObject *> objects;
-  for (KX_GameObject *gameobj : m_objectlist) {
-    objects.push_back(gameobj);
+  for (KX_PythonComponent *component : components) {
+    // Consecutive phases spread the components of the same interval over the frames.
+    component->SetUpdatePhase(m_componentPhase++);
+    component->SetUpdateIndex(m_components.size());
+    m_components.push_back(component);
+  }
+#endif  // WITH_PYTHON
+}
+
+void KX_Scene::UnregisterComponents(KX_GameObject *gameobj)
+{
+#ifdef WITH_PYTHON
+  CListValue<KX_PythonComponent> *components = gameobj->GetComponents();
+  if (!components) {
+    return;
+  }
+
+  for (KX_PythonComponent *component : components) {
+    const int index = component->GetUpdateIndex();
+    // The components of inactive objects are not registered.
+    if (index != -1) {
+      // The list is compacted at the next update to keep the update order.
+      m_components[index] = nullptr;
+      ++m_unregisteredComponents;
+      component->Unregister();
+    }
+  }
+#endif  // WITH_PYTHON
+}
+
+void KX_Scene::UpdateComponents()
+{
+#ifdef WITH_PYTHON
+  const unsigned int frame = m_componentFrame++;
+
+  // Remove the components unregistered since the last update in a single pass.
+  if (m_unregisteredComponents > 0) {
+    unsigned int count = 0;
+    for (KX_PythonComponent *component : m_components) {
+      if (component) {
+        component->SetUpdateIndex(count);
+        m_components[count++] = component;
+      }
+    }
+    m_components.resize(count);
+    m_unregisteredComponents = 0;
   }
 
-  for (std::vector<KX_GameObject *>::iterator it = objects.begin(), end = objects.end(); it != end;
-       ++it) {
-    (*it)->UpdateComponents();
+  /* Components can add objects in their initialization or update, these objects are updated from
+   * the next frame. Removed objects leave a null component in the list.
+   */
+  for (unsigned int i = 0, size = m_components.size(); i < size; ++i) {
+    KX_PythonComponent *component = m_components[i];
+    if (component) {
+      component->Update(frame);
+    }
   }
+#endif  // WITH_PYTHON
+}
+
+void KX_Scene::LogicUpdateFrame(double curtime)
+{
+  UpdateComponents();
 
   m_logicmgr->UpdateFrame(curtime);
 }
@@ -1836,6 +2266,9 @@ void KX_Scene::LogicEndFrame()
     RemoveObject(m_euthanasyobjects.front());
   }
 
+  // The objects added and removed during the frame are shown and hidden at once.
+  SyncReplicaObjectPool();
+
   // prepare obstacle simulation for new frame
   if (m_obstacleSimulation)
     m_obstacleSimulation->UpdateObstacles();
@@ -1845,12 +2278,79 @@ void KX_Scene::LogicEndFrame()
   }
 }
 
+/// Minimum number of scheduled nodes to update the scene graph in parallel.
+static const unsigned int UPDATE_PARENTS_PARALLEL_THRESHOLD = 128;
+
+static void update_parents_thread_func(TaskPool *pool, void *taskdata, int UNUSED(threadid))
+{
+  SG_QList *head = (SG_QList *)taskdata;
+  const double curtime = *(double *)BLI_task_pool_userdata(pool);
+
+  SG_Node *node;
+  while ((node = SG_Node::GetNextScheduled(*head)) != nullptr) {
+    node->UpdateWorldDataThread(curtime);
+  }
+}
+
+bool KX_Scene::UpdateParentsParallel(double curtime)
+{
+  // Count the scheduled nodes, stop as soon as the threshold is reached.
+  unsigned int numScheduled = 0;
+  SG_DList::iterator<SG_Node> it(m_sghead);
+  for (it.begin(); !it.end() && numScheduled < UPDATE_PARENTS_PARALLEL_THRESHOLD; ++it) {
+    ++numScheduled;
+  }
+
+  if (numScheduled < UPDATE_PARENTS_PARALLEL_THRESHOLD) {
+    return false;
+  }
+
+  TaskScheduler *scheduler = KX_GetActiveEngine()->GetParallelScheduler();
+  const unsigned int numHeads = BLI_task_scheduler_num_threads(scheduler);
+  if (numHeads < 2) {
+    return false;
+  }
+
+  /* Dispatch the scheduled nodes in one list per thread, all the nodes of a familly (a root
+   * node and its children) are dispatched in the same list to keep the order of the scheduling,
+   * the parents being updated before their children. */
+  std::vector<SG_QList> heads(numHeads);
+  std::unordered_map<SG_Familly *, SG_QList *> famillyHeads;
+  unsigned int nextHead = 0;
+
+  SG_Node *node;
+  while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
+    SG_QList *&head = famillyHeads[node->GetFamilly().get()];
+    if (!head) {
+      head = &heads[nextHead];
+      nextHead = (nextHead + 1) % numHeads;
+    }
+    head->AddBack(node);
+  }
+
+  TaskPool *pool = BLI_task_pool_create(scheduler, &curtime);
+  for (SG_QList &head : heads) {
+    if (!head.Empty()) {
+      BLI_task_pool_push(pool, update_parents_thread_func, &head, false, TASK_PRIORITY_HIGH);
+    }
+  }
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+
+  return true;
+}
+
 /**
  * UpdateParents: SceneGraph transformation update.
  */
 void KX_Scene::UpdateParents(double curtime)
 {
-  // we use the SG dynamic list
+  if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::PARALLEL_SCENEGRAPH)) {
+    UpdateParentsParallel(curtime);
+  }
+
+  /* we use the SG dynamic list, in parallel mode it only contains the nodes
+   * scheduled during the update of the families */
   SG_Node *node;
 
   while ((node = SG_Node::GetNextScheduled(m_sghead)) != nullptr) {
@@ -1873,9 +2373,28 @@ RAS_MaterialBucket *KX_Scene::FindBucket(class RAS_IPolyMaterial *polymat, bool
 /*****************************TAA UTILS**********************************/
 /* Utils for TAA to check if nothing is moving inside view frustum (or anywhere when using probes)
  */
-void KX_Scene::AppendToStaticObjects(KX_GameObject *gameobj)
+void KX_Scene::AppendToTransformDirtyObjects(KX_GameObject *gameobj)
 {
-  m_staticObjects.push_back(gameobj);
+  gameobj->SetTransformDirtyIndex(m_transformDirtyObjects.size());
+  m_transformDirtyObjects.push_back(gameobj);
+}
+
+void KX_Scene::RemoveFromTransformDirtyObjects(KX_GameObject *gameobj)
+{
+  const unsigned int index = gameobj->GetTransformDirtyIndex();
+  KX_GameObject *last = m_transformDirtyObjects.back();
+  m_transformDirtyObjects[index] = last;
+  last->SetTransformDirtyIndex(index);
+  m_transformDirtyObjects.pop_back();
+  gameobj->ClearTransformDirty();
+}
+
+void KX_Scene::ClearTransformDirtyObjects()
+{
+  for (KX_GameObject *gameobj : m_transformDirtyObjects) {
+    gameobj->ClearTransformDirty();
+  }
+  m_transformDirtyObjects.clear();
 }
 /************************End of TAA UTILS**************************/
 /*************************************End of EEVEE INTEGRATION*********************************/
@@ -1914,24 +2433,8 @@ void KX_Scene::UpdateObjectActivity(void)
 {
   if (m_activity_culling) {
     /* determine the activity criterium and set objects accordingly */
-    MT_Vector3 camloc = GetActiveCamera()->NodeGetWorldPosition();  // GetCameraLocation();
-
-    for (KX_GameObject *ob : *m_objectlist) {
-      if (!ob->GetIgnoreActivityCulling()) {
-        /* Simple test: more than 10 away from the camera, count
-         * Manhattan distance. */
-        MT_Vector3 obpos = ob->NodeGetWorldPosition();
-
-        if ((fabsf(camloc[0] - obpos[0]) > m_activity_box_radius) ||
-            (fabsf(camloc[1] - obpos[1]) > m_activity_box_radius) ||
-            (fabsf(camloc[2] - obpos[2]) > m_activity_box_radius)) {
-          ob->SuspendDynamics();
-        }
-        else {
-          ob->ResumeDynamics();
-        }
-      }
-    }
+    const MT_Vector3 camloc = GetActiveCamera()->NodeGetWorldPosition();
+    m_activityGrid.Update(m_objectlist, camloc, m_activity_box_radius);
   }
 }
 
@@ -1975,6 +2478,91 @@ void KX_Scene::SetPhysicsEnvironment(class PHY_IPhysicsEnvironment *physEnv)
   }
 }
 
+void KX_Scene::SaveSnapshot(int slot)
+{
+  Snapshot &snapshot = m_snapshots[slot];
+
+  snapshot.m_objects.resize(m_objectlist->GetCount());
+  for (unsigned int i = 0, size = snapshot.m_objects.size(); i < size; ++i) {
+    KX_GameObject *gameobj = m_objectlist->GetValue(i);
+    const SG_Node *node = gameobj->GetSGNode();
+    Snapshot::ObjectState &state = snapshot.m_objects[i];
+
+    state.m_objectId = gameobj->GetSnapshotId();
+    state.m_localPosition = node->GetLocalPosition();
+    state.m_localOrientation = node->GetLocalOrientation();
+    state.m_localScale = node->GetLocalScale();
+    state.m_worldPosition = node->GetWorldPosition();
+    state.m_worldOrientation = node->GetWorldOrientation();
+    state.m_worldScale = node->GetWorldScaling();
+  }
+
+  if (m_physicsEnvironment) {
+    snapshot.m_physicsSnapshot = m_physicsEnvironment->SaveSnapshot(snapshot.m_physicsSnapshot);
+  }
+}
+
+bool KX_Scene::RestoreSnapshot(int slot)
+{
+  std::map<int, Snapshot>::iterator it = m_snapshots.find(slot);
+  if (it == m_snapshots.end()) {
+    return false;
+  }
+
+  const Snapshot &snapshot = it->second;
+
+  std::map<unsigned long long, unsigned int> savedIndices;
+  for (unsigned int i = 0, size = m_objectlist->GetCount(); i < size; ++i) {
+    KX_GameObject *gameobj = m_objectlist->GetValue(i);
+    const unsigned long long id = gameobj->GetSnapshotId();
+
+    unsigned int index = i;
+    // The object list is usually unchanged, else search the object in the saved objects.
+    if (i >= snapshot.m_objects.size() || snapshot.m_objects[i].m_objectId != id) {
+      if (savedIndices.empty()) {
+        for (unsigned int j = 0, numSaved = snapshot.m_objects.size(); j < numSaved; ++j) {
+          savedIndices[snapshot.m_objects[j].m_objectId] = j;
+        }
+      }
+
+      std::map<unsigned long long, unsigned int>::const_iterator sit = savedIndices.find(id);
+      if (sit == savedIndices.end()) {
+        continue;
+      }
+      index = sit->second;
+    }
+
+    const Snapshot::ObjectState &state = snapshot.m_objects[index];
+    SG_Node *node = gameobj->GetSGNode();
+    // The local transform schedules the update of the node, the world transform is set now.
+    node->SetLocalPosition(state.m_localPosition);
+    node->SetLocalOrientation(state.m_localOrientation);
+    node->SetLocalScale(state.m_localScale);
+    node->SetWorldPosition(state.m_worldPosition);
+    node->SetWorldOrientation(state.m_worldOrientation);
+    node->SetWorldScale(state.m_worldScale);
+  }
+
+  if (m_physicsEnvironment && snapshot.m_physicsSnapshot) {
+    m_physicsEnvironment->RestoreSnapshot(snapshot.m_physicsSnapshot);
+  }
+
+  return true;
+}
+
+bool KX_Scene::RemoveSnapshot(int slot)
+{
+  std::map<int, Snapshot>::iterator it = m_snapshots.find(slot);
+  if (it == m_snapshots.end()) {
+    return false;
+  }
+
+  delete it->second.m_physicsSnapshot;
+  m_snapshots.erase(it);
+
+  return true;
+}
+
 void KX_Scene::SetSuspendedDelta(double suspendeddelta)
 {
   m_suspendeddelta = suspendeddelta;
@@ -2126,6 +2714,40 @@ bool KX_Scene::MergeScene(KX_Scene *other)
     }
   }
 
+  // The merged objects keep their pending transform synchronization.
+  for (KX_GameObject *gameobj : other->m_transformDirtyObjects) {
+    AppendToTransformDirtyObjects(gameobj);
+  }
+  other->m_transformDirtyObjects.clear();
+  for (KX_GameObject *gameobj : *other->GetObjectList()) {
+    gameobj->SetTransformDirty();
+  }
+
+  // The merged objects keep their interpolation.
+  for (KX_GameObject *gameobj : other->m_interpolationDirtyObjects) {
+    AppendToInterpolationDirtyObjects(gameobj);
+  }
+  other->m_interpolationDirtyObjects.clear();
+  for (KX_GameObject *gameobj : other->m_interpolatedObjects) {
+    gameobj->SetInterpolatedIndex(m_interpolatedObjects.size());
+    m_interpolatedObjects.push_back(gameobj);
+  }
+  other->m_interpolatedObjects.clear();
+
+  // The merged objects keep their components updated.
+  for (KX_PythonComponent *component : other->m_components) {
+    if (component) {
+      component->SetUpdateIndex(m_components.size());
+      m_components.push_back(component);
+    }
+  }
+  other->m_components.clear();
+  other->m_unregisteredComponents = 0;
+
+  // The activity grid is rebuilt with the merged objects at the next logic frame.
+  other->m_activityGrid.Clear();
+  m_activityGrid.Clear();
+
   GetObjectList()->MergeList(other->GetObjectList());
   other->GetObjectList()->ReleaseAndRemoveAll();
 
@@ -2256,12 +2878,17 @@ PyTypeObject KX_Scene::Type = {PyVarObject_HEAD_INIT(nullptr, 0) "KX_Scene",
 
 PyMethodDef KX_Scene::Methods[] = {
     KX_PYMETHODTABLE(KX_Scene, addObject),
+    KX_PYMETHODTABLE(KX_Scene, setObjectPoolSize),
     KX_PYMETHODTABLE(KX_Scene, end),
     KX_PYMETHODTABLE(KX_Scene, restart),
     KX_PYMETHODTABLE(KX_Scene, replace),
     KX_PYMETHODTABLE(KX_Scene, suspend),
     KX_PYMETHODTABLE(KX_Scene, resume),
     KX_PYMETHODTABLE(KX_Scene, drawObstacleSimulation),
+    KX_PYMETHODTABLE(KX_Scene, rayCastBatch),
+    KX_PYMETHODTABLE_O(KX_Scene, saveSnapshot),
+    KX_PYMETHODTABLE_O(KX_Scene, restoreSnapshot),
+    KX_PYMETHODTABLE_O(KX_Scene, removeSnapshot),
 
     /* dict style access */
     KX_PYMETHODTABLE(KX_Scene, get),
@@ -2544,6 +3171,27 @@ int KX_Scene::pyattr_set_gravity(PyObjectPlus *self_v,
   return PY_SET_ATTR_SUCCESS;
 }
 
+PyObject *KX_Scene::pyattr_get_collision_statistics(PyObjectPlus *self_v,
+                                                    const KX_PYATTRIBUTE_DEF *attrdef)
+{
+  KX_Scene *self = static_cast<KX_Scene *>(self_v);
+  KX_CollisionEventManager *collisionmgr = static_cast<KX_CollisionEventManager *>(
+      self->GetLogicManager()->FindEventManager(SCA_EventManager::TOUCH_EVENTMGR));
+
+  KX_CollisionEventManager::Statistics statistics = {0, 0, 0};
+  if (collisionmgr) {
+    statistics = collisionmgr->GetStatistics();
+  }
+
+  return Py_BuildValue("{s:I,s:I,s:I}",
+                       "collisions",
+                       statistics.m_numCollisions,
+                       "pairs",
+                       statistics.m_numPairs,
+                       "callbacks",
+                       statistics.m_numCallbacks);
+}
+
 PyAttributeDef KX_Scene::Attributes[] = {
     KX_PYATTRIBUTE_RO_FUNCTION("name", KX_Scene, pyattr_get_name),
     KX_PYATTRIBUTE_RO_FUNCTION("objects", KX_Scene, pyattr_get_objects),
@@ -2565,6 +3213,8 @@ PyAttributeDef KX_Scene::Attributes[] = {
     KX_PYATTRIBUTE_RW_FUNCTION(
         "pre_draw_setup", KX_Scene, pyattr_get_drawing_callback, pyattr_set_drawing_callback),
     KX_PYATTRIBUTE_RW_FUNCTION("gravity", KX_Scene, pyattr_get_gravity, pyattr_set_gravity),
+    KX_PYATTRIBUTE_RO_FUNCTION(
+        "collisionStatistics", KX_Scene, pyattr_get_collision_statistics),
     KX_PYATTRIBUTE_BOOL_RO("suspended", KX_Scene, m_suspend),
     KX_PYATTRIBUTE_BOOL_RO("activity_culling", KX_Scene, m_activity_culling),
     KX_PYATTRIBUTE_FLOAT_RW(
@@ -2615,6 +3265,44 @@ KX_PYMETHODDEF_DOC(KX_Scene,
   return replica->GetProxy();
 }
 
+KX_PYMETHODDEF_DOC(KX_Scene,
+                   setObjectPoolSize,
+                   "setObjectPoolSize(object, size)\n"
+                   "Set the number of hidden copies kept for the replicas of an object.\n")
+{
+  PyObject *pyob;
+  KX_GameObject *ob;
+  int size;
+
+  if (!PyArg_ParseTuple(args, "Oi:setObjectPoolSize", &pyob, &size))
+    return nullptr;
+
+  if (!ConvertPythonToGameObject(m_logicmgr,
+                                 pyob,
+                                 &ob,
+                                 false,
+                                 "scene.setObjectPoolSize(object, size): KX_Scene (first argument)"))
+    return nullptr;
+
+  if (!m_inactivelist->SearchValue(ob)) {
+    PyErr_Format(PyExc_ValueError,
+                 "scene.setObjectPoolSize(object, size): KX_Scene (first argument): object "
+                 "must be in an inactive layer");
+    return nullptr;
+  }
+
+  if (size < 0 || size > 10000) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.setObjectPoolSize(object, size): KX_Scene (second argument): size "
+                    "must be between 0 and 10000");
+    return nullptr;
+  }
+
+  SetReplicaPoolSize(ob, size);
+
+  Py_RETURN_NONE;
+}
+
 KX_PYMETHODDEF_DOC(KX_Scene,
                    end,
                    "end()\n"
@@ -2685,6 +3373,291 @@ KX_PYMETHODDEF_DOC(KX_Scene,
   Py_RETURN_NONE;
 }
 
+/// Filter the objects hit by a batch of casts by their user collision group.
+class KX_CastFilter : public PHY_ICastFilter {
+ private:
+  unsigned short m_mask;
+
+ public:
+  KX_CastFilter(unsigned short mask) : m_mask(mask)
+  {
+  }
+
+  virtual bool NeedCast(PHY_IPhysicsController *controller) const
+  {
+    KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(controller->GetNewClientInfo());
+    return (info && info->isActor() && (info->m_gameobject->GetUserCollisionGroup() & m_mask));
+  }
+};
+
+/** Convert a buffer of float or double coordinates, or a sequence of vectors, to points.
+ * \return False with a python error set if the conversion failed.
+ */
+static bool py_points_from_object(PyObject *value,
+                                  std::vector<MT_Vector3> &r_points,
+                                  const char *error_prefix)
+{
+  if (PyObject_CheckBuffer(value)) {
+    Py_buffer view;
+    if (PyObject_GetBuffer(value, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == -1) {
+      return false;
+    }
+
+    const char *format = view.format ? view.format : "B";
+    // Skip the native byte order and alignment prefix.
+    if (ELEM(format[0], '@', '=')) {
+      ++format;
+    }
+    const bool isFloat = STREQ(format, "f");
+    const bool isDouble = STREQ(format, "d");
+    const Py_ssize_t numValues = view.len / view.itemsize;
+
+    if ((!isFloat && !isDouble) || (numValues % 3) != 0) {
+      PyErr_Format(PyExc_TypeError,
+                   "%s, expected a buffer of float or double coordinates by groups of three",
+                   error_prefix);
+      PyBuffer_Release(&view);
+      return false;
+    }
+
+    r_points.resize(numValues / 3);
+    for (unsigned int i = 0, size = r_points.size(); i < size; ++i) {
+      for (unsigned short j = 0; j < 3; ++j) {
+        r_points[i][j] = isFloat ? ((float *)view.buf)[i * 3 + j] :
+                                   ((double *)view.buf)[i * 3 + j];
+      }
+    }
+
+    PyBuffer_Release(&view);
+    return true;
+  }
+
+  PyObject *fast = PySequence_Fast(value, error_prefix);
+  if (!fast) {
+    return false;
+  }
+
+  const Py_ssize_t size = PySequence_Fast_GET_SIZE(fast);
+  PyObject **items = PySequence_Fast_ITEMS(fast);
+  r_points.resize(size);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    if (!PyVecTo(items[i], r_points[i])) {
+      Py_DECREF(fast);
+      return false;
+    }
+  }
+
+  Py_DECREF(fast);
+  return true;
+}
+
+/// Return the hit points or normals of casts as a (n, 3) float memory view.
+static PyObject *py_cast_vectors(const std::vector<PHY_CastResult> &results,
+                                 MT_Vector3 PHY_CastResult::*member)
+{
+  const Py_ssize_t size = results.size();
+  PyObject *bytes = PyByteArray_FromStringAndSize(nullptr, size * 3 * sizeof(float));
+  if (!bytes) {
+    return nullptr;
+  }
+
+  float *data = (float *)PyByteArray_AS_STRING(bytes);
+  for (Py_ssize_t i = 0; i < size; ++i) {
+    const PHY_CastResult &result = results[i];
+    if (result.m_controller) {
+      (result.*member).getValue(&data[i * 3]);
+    }
+    else {
+      data[i * 3] = data[i * 3 + 1] = data[i * 3 + 2] = 0.0f;
+    }
+  }
+
+  PyObject *view = PyMemoryView_FromObject(bytes);
+  Py_DECREF(bytes);
+  if (!view) {
+    return nullptr;
+  }
+
+  // A memory view can't have an empty dimension.
+  PyObject *shapedView = (size > 0) ?
+                             PyObject_CallMethod(view, "cast", "s(ni)", "f", size, 3) :
+                             PyObject_CallMethod(view, "cast", "s", "f");
+  Py_DECREF(view);
+
+  return shapedView;
+}
+
+KX_PYMETHODDEF_DOC(
+    KX_Scene,
+    rayCastBatch,
+    "rayCastBatch(fromPoints, toPoints, radius=0.0, mask=0xFFFF, ignore=None)\n"
+    "Cast rays, or spheres if the radius is positive, between pairs of points.\n"
+    "Return a list of the hit objects and the hit points and normals as (n, 3) float arrays.\n")
+{
+  PyObject *pyfrom;
+  PyObject *pyto;
+  float radius = 0.0f;
+  int mask = (1 << OB_MAX_COL_MASKS) - 1;
+  PyObject *pyignore = Py_None;
+
+  if (!PyArg_ParseTuple(
+          args, "OO|fiO:rayCastBatch", &pyfrom, &pyto, &radius, &mask, &pyignore)) {
+    return nullptr;
+  }
+
+  std::vector<MT_Vector3> fromPoints;
+  std::vector<MT_Vector3> toPoints;
+  if (!py_points_from_object(
+          pyfrom, fromPoints, "scene.rayCastBatch(fromPoints, toPoints): KX_Scene, fromPoints") ||
+      !py_points_from_object(
+          pyto, toPoints, "scene.rayCastBatch(fromPoints, toPoints): KX_Scene, toPoints")) {
+    return nullptr;
+  }
+
+  const unsigned int numQueries = fromPoints.size();
+  if (toPoints.size() != numQueries) {
+    PyErr_SetString(PyExc_ValueError,
+                    "scene.rayCastBatch(fromPoints, toPoints): KX_Scene, expected the same "
+                    "number of start and end points");
+    return nullptr;
+  }
+
+  if (mask == 0 || mask & ~((1 << OB_MAX_COL_MASKS) - 1)) {
+    PyErr_Format(PyExc_ValueError,
+                 "scene.rayCastBatch(fromPoints, toPoints, radius, mask): KX_Scene, mask "
+                 "argument must be an int bitfield, 0 < mask < %i",
+                 (1 << OB_MAX_COL_MASKS));
+    return nullptr;
+  }
+
+  std::vector<PHY_CastQuery> queries(numQueries);
+  for (unsigned int i = 0; i < numQueries; ++i) {
+    queries[i] = {fromPoints[i], toPoints[i], nullptr};
+  }
+
+  // A single object ignored by all the casts or an object per cast.
+  if (pyignore != Py_None) {
+    const char *ignorePrefix =
+        "scene.rayCastBatch(fromPoints, toPoints, radius, mask, ignore): KX_Scene, ignore";
+    KX_GameObject *ignoreObject;
+    if (PySequence_Check(pyignore)) {
+      if (PySequence_Size(pyignore) != (Py_ssize_t)numQueries) {
+        PyErr_Format(PyExc_ValueError, "%s, expected an object per cast", ignorePrefix);
+        return nullptr;
+      }
+
+      for (unsigned int i = 0; i < numQueries; ++i) {
+        PyObject *item = PySequence_GetItem(pyignore, i);
+        const bool converted = ConvertPythonToGameObject(
+            m_logicmgr, item, &ignoreObject, true, ignorePrefix);
+        Py_DECREF(item);
+        if (!converted) {
+          return nullptr;
+        }
+        queries[i].m_ignoreController = ignoreObject ? ignoreObject->GetPhysicsController() :
+                                                       nullptr;
+      }
+    }
+    else {
+      if (!ConvertPythonToGameObject(m_logicmgr, pyignore, &ignoreObject, true, ignorePrefix)) {
+        return nullptr;
+      }
+      PHY_IPhysicsController *ignoreController = ignoreObject ?
+                                                     ignoreObject->GetPhysicsController() :
+                                                     nullptr;
+      for (PHY_CastQuery &query : queries) {
+        query.m_ignoreController = ignoreController;
+      }
+    }
+  }
+
+  const KX_CastFilter filter(mask);
+  std::vector<PHY_CastResult> results;
+  m_physicsEnvironment->CastTestBatch(queries, radius, &filter, results);
+
+  PyObject *pyobjects = PyList_New(numQueries);
+  for (unsigned int i = 0; i < numQueries; ++i) {
+    PyObject *item = Py_None;
+    if (results[i].m_controller) {
+      KX_ClientObjectInfo *info = static_cast<KX_ClientObjectInfo *>(
+          results[i].m_controller->GetNewClientInfo());
+      item = info->m_gameobject->GetProxy();
+    }
+    else {
+      Py_INCREF(item);
+    }
+    PyList_SET_ITEM(pyobjects, i, item);
+  }
+
+  PyObject *pypoints = py_cast_vectors(results, &PHY_CastResult::m_hitPoint);
+  PyObject *pynormals = py_cast_vectors(results, &PHY_CastResult::m_hitNormal);
+  if (!pypoints || !pynormals) {
+    Py_DECREF(pyobjects);
+    Py_XDECREF(pypoints);
+    Py_XDECREF(pynormals);
+    return nullptr;
+  }
+
+  return Py_BuildValue("NNN", pyobjects, pypoints, pynormals);
+}
+
+KX_PYMETHODDEF_DOC_O(KX_Scene,
+                     saveSnapshot,
+                     "saveSnapshot(slot)\n"
+                     "Save the object transforms and the physics state in a slot.\n")
+{
+  const int slot = PyLong_AsLong(value);
+  if (slot == -1 && PyErr_Occurred()) {
+    PyErr_SetString(PyExc_TypeError, "scene.saveSnapshot(slot): KX_Scene, expected an int");
+    return nullptr;
+  }
+
+  SaveSnapshot(slot);
+  Py_RETURN_NONE;
+}
+
+KX_PYMETHODDEF_DOC_O(KX_Scene,
+                     restoreSnapshot,
+                     "restoreSnapshot(slot)\n"
+                     "Restore the object transforms and the physics state saved in a slot.\n"
+                     "The objects added since are kept and the removed objects are not "
+                     "added back.\n")
+{
+  const int slot = PyLong_AsLong(value);
+  if (slot == -1 && PyErr_Occurred()) {
+    PyErr_SetString(PyExc_TypeError, "scene.restoreSnapshot(slot): KX_Scene, expected an int");
+    return nullptr;
+  }
+
+  if (!RestoreSnapshot(slot)) {
+    PyErr_Format(
+        PyExc_ValueError, "scene.restoreSnapshot(slot): KX_Scene, no snapshot in slot %i", slot);
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
+KX_PYMETHODDEF_DOC_O(KX_Scene,
+                     removeSnapshot,
+                     "removeSnapshot(slot)\n"
+                     "Free the snapshot saved in a slot.\n")
+{
+  const int slot = PyLong_AsLong(value);
+  if (slot == -1 && PyErr_Occurred()) {
+    PyErr_SetString(PyExc_TypeError, "scene.removeSnapshot(slot): KX_Scene, expected an int");
+    return nullptr;
+  }
+
+  if (!RemoveSnapshot(slot)) {
+    PyErr_Format(
+        PyExc_ValueError, "scene.removeSnapshot(slot): KX_Scene, no snapshot in slot %i", slot);
+    return nullptr;
+  }
+
+  Py_RETURN_NONE;
+}
+
 /* Matches python dict.get(key, [default]) */
 KX_PYMETHODDEF_DOC(KX_Scene, get, "")
 {
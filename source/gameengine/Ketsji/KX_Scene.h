@@ -33,10 +33,12 @@
 #define __KX_SCENE_H__
 
 #include "KX_PhysicsEngineEnums.h"
+#include "KX_ActivityGrid.h"
 
 #include <vector>
 #include <set>
 #include <list>
+#include <map>
 
 #include "SG_Node.h"
 #include "SG_Frustum.h"
@@ -73,6 +75,7 @@ class KX_Camera;
 class KX_FontObject;
 class KX_GameObject;
 class KX_LightObject;
+class KX_PythonComponent;
 class RAS_MeshObject;
 class RAS_BucketManager;
 class RAS_MaterialBucket;
@@ -121,7 +124,22 @@ class KX_Scene : public CValue, public SCA_IScene {
  protected:
   /***************EEVEE INTEGRATION*****************/
 
-  std::vector<KX_GameObject *> m_staticObjects;
+  /// Objects moved since last render, their blender object need to be synchronized.
+  std::vector<KX_GameObject *> m_transformDirtyObjects;
+
+  /// Objects moved during the current logic frame, used by the render interpolation.
+  std::vector<KX_GameObject *> m_interpolationDirtyObjects;
+  /// Objects moved during the last logic frame and rendered interpolated.
+  std::vector<KX_GameObject *> m_interpolatedObjects;
+  /// Fraction of the next logic frame elapsed at render time.
+  float m_interpolationFactor;
+
+  /// Hidden blender objects kept for the next replicas, per original blender object.
+  std::map<Object *, std::vector<Object *>> m_replicaObjectPool;
+  /// Maximum number of hidden blender objects kept per original blender object.
+  std::map<Object *, unsigned int> m_replicaObjectPoolSize;
+  /// True when pooled objects were hidden or shown since the last layer collection sync.
+  bool m_replicaObjectPoolDirty;
 
   int m_taaSamplesBackup;
   bool m_resetTaaSamples;
@@ -158,6 +176,15 @@ class KX_Scene : public CValue, public SCA_IScene {
   /// All animated objects, no need of CListValue because the list isn't exposed in python.
   std::vector<KX_GameObject *> m_animatedlist;
 
+  /// Python components of the active objects, in update order.
+  std::vector<KX_PythonComponent *> m_components;
+  /// Number of unregistered components left as null in the update list until the next update.
+  unsigned int m_unregisteredComponents;
+  /// Number of logic frames the components were updated, used for their update interval.
+  unsigned int m_componentFrame;
+  /// Update phase given to the next registered component.
+  unsigned int m_componentPhase;
+
   /// The set of cameras for this scene
   CListValue<KX_Camera> *m_cameralist;
   /// The set of fonts for this scene
@@ -182,6 +209,32 @@ class KX_Scene : public CValue, public SCA_IScene {
   // e_PhysicsEngine m_physicsEngine; //who needs this ?
   class PHY_IPhysicsEnvironment *m_physicsEnvironment;
 
+  /** Saved transforms of the objects and state of the physics bodies. The states are matched
+   * with the objects by snapshot identifier, a removed object is never matched even if a new
+   * object reuses its address.
+   */
+  struct Snapshot {
+    struct ObjectState {
+      unsigned long long m_objectId;
+      MT_Vector3 m_localPosition;
+      MT_Matrix3x3 m_localOrientation;
+      MT_Vector3 m_localScale;
+      MT_Vector3 m_worldPosition;
+      MT_Matrix3x3 m_worldOrientation;
+      MT_Vector3 m_worldScale;
+    };
+
+    std::vector<ObjectState> m_objects;
+    class PHY_IPhysicsSnapshot *m_physicsSnapshot;
+
+    Snapshot() : m_physicsSnapshot(nullptr)
+    {
+    }
+  };
+
+  /// Snapshots saved by the user, indexed by slot.
+  std::map<int, Snapshot> m_snapshots;
+
   /**
    * The name of the scene
    */
@@ -265,6 +318,9 @@ class KX_Scene : public CValue, public SCA_IScene {
    */
   bool m_activity_culling;
 
+  /// Grid of the objects used to only update the activity of the objects near the boundary.
+  KX_ActivityGrid m_activityGrid;
+
   /**
    * Toggle to enable or disable culling via DBVT broadphase of Bullet.
    */
@@ -301,6 +357,9 @@ class KX_Scene : public CValue, public SCA_IScene {
   AnimationPoolData m_animationPoolData;
   TaskPool *m_animationPool;
 
+  /// Cull the mesh children of the animated armatures to skip the pose update of hidden armatures.
+  void UpdateAnimationsCulling();
+
   /**
    * LOD Hysteresis settings
    */
@@ -317,10 +376,23 @@ class KX_Scene : public CValue, public SCA_IScene {
   virtual ~KX_Scene();
 
   /******************EEVEE INTEGRATION************************/
-  void AppendToStaticObjects(KX_GameObject *gameobj);
+  void AppendToTransformDirtyObjects(KX_GameObject *gameobj);
+  /// Unregister a transform dirty object, the last registered object takes its place.
+  void RemoveFromTransformDirtyObjects(KX_GameObject *gameobj);
+  /// Forget the objects moved since the last render, used when nothing is rendered.
+  void ClearTransformDirtyObjects();
   bool ObjectsAreStatic();
   void ResetTaaSamples();
 
+  void AppendToInterpolationDirtyObjects(KX_GameObject *gameobj);
+  /// Unregister an object from the interpolation lists, the last objects take its places.
+  void RemoveFromInterpolatedObjects(KX_GameObject *gameobj);
+  /// Store the transforms of the objects moved during the logic frame to interpolate them.
+  void UpdateInterpolatedObjects();
+  /// Render the interpolated objects at a fraction of the next logic frame.
+  void InterpolateObjects(float factor);
+  float GetInterpolationFactor() const;
+
   bool m_isRuntime;  // Too lazy to put that in protected
   std::vector<Object *> m_hiddenObjectsDuringRuntime;
 
@@ -332,6 +404,23 @@ class KX_Scene : public CValue, public SCA_IScene {
   void SetLastReplicatedParentObject(Object *ob);
   Object *GetLastReplicatedParentObject();
   void ResetLastReplicatedParentObject();
+
+  /** Set the number of blender objects kept for the replicas of an object, the missing
+   * objects are created immediately. Only objects without parent and children can be pooled.
+   * \param original The inactive object to replicate.
+   * \param size The number of pooled blender objects, 0 to disable the pool.
+   */
+  void SetReplicaPoolSize(KX_GameObject *original, unsigned int size);
+  /// Return a pooled copy of the blender object or nullptr if the pool is empty.
+  Object *GetPooledReplicaObject(Object *original);
+  /** Hide a replica blender object and keep it in the pool of its original object.
+   * \return False if the object is not pooled and must be freed.
+   */
+  bool ReleasePooledReplicaObject(Object *original, Object *replica);
+  /// Free the pooled blender objects, only the ones of tagged original objects if taggedOnly.
+  void FreeReplicaObjectPool(bool taggedOnly);
+  /// Sync the layer collections once for all the pooled objects hidden or shown in the frame.
+  void SyncReplicaObjectPool();
   Object *GetGameDefaultCamera();
   void InitBlenderContextVariables();
   void AddOverlayCollection(KX_Camera *overlay_cam, struct Collection *collection);
@@ -356,6 +445,10 @@ class KX_Scene : public CValue, public SCA_IScene {
   static bool KX_ScenegraphUpdateFunc(SG_Node *node, void *gameobj, void *scene);
   static bool KX_ScenegraphRescheduleFunc(SG_Node *node, void *gameobj, void *scene);
   void UpdateParents(double curtime);
+  /** Update the scheduled nodes on several threads, one familly per task.
+   * \return False if there's not enough nodes to update and nothing was done.
+   */
+  bool UpdateParentsParallel(double curtime);
   void DupliGroupRecurse(KX_GameObject *groupobj, int level);
   bool IsObjectInGroup(KX_GameObject *gameobj)
   {
@@ -377,6 +470,12 @@ class KX_Scene : public CValue, public SCA_IScene {
 
   void AddAnimatedObject(KX_GameObject *gameobj);
 
+  /// Register the python components of an active object to be updated every logic frame.
+  void RegisterComponents(KX_GameObject *gameobj);
+  void UnregisterComponents(KX_GameObject *gameobj);
+  /// Start and update the registered python components.
+  void UpdateComponents();
+
   /**
    * \section Logic stuff
    * Initiate an update of the logic system.
@@ -497,6 +596,9 @@ class KX_Scene : public CValue, public SCA_IScene {
 
   // Enable/disable activity culling.
   void SetActivityCulling(bool b);
+  bool GetActivityCulling() const;
+  /// Register an object moved since the last activity update.
+  void AppendToActivityDirtyObjects(KX_GameObject *gameobj);
 
   // Set the radius of the activity culling box.
   void SetActivityCullingRadius(float f);
@@ -528,6 +630,17 @@ class KX_Scene : public CValue, public SCA_IScene {
 
   void SetPhysicsEnvironment(class PHY_IPhysicsEnvironment *physEnv);
 
+  /// Save the transforms of the objects and the physics state in a slot, reusing its memory.
+  void SaveSnapshot(int slot);
+  /** Restore the objects and physics state saved in a slot. This is a rollback of the
+   * transforms and bodies only: the objects added since the snapshot are kept unmodified and
+   * the removed objects are not added back.
+   * \return False if the slot is empty.
+   */
+  bool RestoreSnapshot(int slot);
+  /// Free the snapshot of a slot, return false if the slot is empty.
+  bool RemoveSnapshot(int slot);
+
   void SetGravity(const MT_Vector3 &gravity);
   MT_Vector3 GetGravity();
 
@@ -559,6 +672,7 @@ class KX_Scene : public CValue, public SCA_IScene {
   /* --------------------------------------------------------------------- */
 
   KX_PYMETHOD_DOC(KX_Scene, addObject);
+  KX_PYMETHOD_DOC(KX_Scene, setObjectPoolSize);
   KX_PYMETHOD_DOC(KX_Scene, end);
   KX_PYMETHOD_DOC(KX_Scene, restart);
   KX_PYMETHOD_DOC(KX_Scene, replace);
@@ -566,6 +680,10 @@ class KX_Scene : public CValue, public SCA_IScene {
   KX_PYMETHOD_DOC(KX_Scene, resume);
   KX_PYMETHOD_DOC(KX_Scene, get);
   KX_PYMETHOD_DOC(KX_Scene, drawObstacleSimulation);
+  KX_PYMETHOD_DOC(KX_Scene, rayCastBatch);
+  KX_PYMETHOD_DOC_O(KX_Scene, saveSnapshot);
+  KX_PYMETHOD_DOC_O(KX_Scene, restoreSnapshot);
+  KX_PYMETHOD_DOC_O(KX_Scene, removeSnapshot);
 
   /* attributes */
   static PyObject *pyattr_get_name(PyObjectPlus *self_v, const KX_PYATTRIBUTE_DEF *attrdef);
@@ -596,6 +714,8 @@ class KX_Scene : public CValue, public SCA_IScene {
   static int pyattr_set_gravity(PyObjectPlus *self_v,
                                 const KX_PYATTRIBUTE_DEF *attrdef,
                                 PyObject *value);
+  static PyObject *pyattr_get_collision_statistics(PyObjectPlus *self_v,
+                                                   const KX_PYATTRIBUTE_DEF *attrdef);
 
   /* getitem/setitem */
   static PyMappingMethods Mapping;
@@ -60,8 +60,10 @@
 #include "DEV_Joystick.h"
 
 #include "CM_Message.h"
+#include "CM_Profiler.h"
 
 #include "MEM_guardedalloc.h"
+#include "PIL_time.h"
 
 extern "C" {
 #include "GPU_extensions.h"
@@ -111,7 +113,8 @@ LA_Launcher::LA_Launcher(GHOST_ISystem *system,
       m_stereoMode(stereoMode),
       m_argc(argc),
       m_argv(argv),
-      m_context(C)
+      m_context(C),
+      m_fastForward(false)
 {
   m_pythonConsole.use = false;
 }
@@ -160,11 +163,34 @@ void LA_Launcher::InitEngine()
   bool frameRate = (SYS_GetCommandLineInt(syshandle, "show_framerate", 0) != 0);
   bool nodepwarnings = (SYS_GetCommandLineInt(syshandle, "ignore_deprecation_warnings", 1) != 0);
   bool restrictAnimFPS = (gm.flag & GAME_RESTRICT_ANIM_UPDATES) != 0;
+  bool parallelScenes = (gm.flag & GAME_USE_PARALLEL_SCENES) != 0;
+  bool parallelSceneGraph = (gm.flag & GAME_USE_PARALLEL_SCENEGRAPH) != 0;
+  bool bakeLoopActions = (gm.flag & GAME_BAKE_LOOP_ACTIONS) != 0;
+  bool renderInterpolation = (gm.flag & GAME_USE_RENDER_INTERPOLATION) != 0;
+
+  // Record the frame phases of the whole game when a trace file is given.
+  m_traceFile = SYS_GetCommandLineString(syshandle, "trace_file", "");
+  if (!m_traceFile.empty()) {
+    CM_Profiler::Start(CM_Profiler::DEFAULT_NUM_EVENTS);
+  }
+
+  // Without system the game runs headless, the simulation is always stepped at the tic rate.
+  const bool headless = (m_system == nullptr);
+  if (headless) {
+    fixed_framerate = true;
+    m_fastForward = (SYS_GetCommandLineInt(syshandle, "fast_forward", 0) != 0);
+  }
 
   const KX_KetsjiEngine::FlagType flags = (KX_KetsjiEngine::FlagType)(
       (fixed_framerate ? KX_KetsjiEngine::FIXED_FRAMERATE : 0) |
       (frameRate ? KX_KetsjiEngine::SHOW_FRAMERATE : 0) |
       (restrictAnimFPS ? KX_KetsjiEngine::RESTRICT_ANIMATION : 0) |
+      (parallelScenes ? KX_KetsjiEngine::PARALLEL_SCENES : 0) |
+      (parallelSceneGraph ? KX_KetsjiEngine::PARALLEL_SCENEGRAPH : 0) |
+      (bakeLoopActions ? KX_KetsjiEngine::BAKE_LOOP_ACTIONS : 0) |
+      (renderInterpolation ? KX_KetsjiEngine::RENDER_INTERPOLATION : 0) |
+      (headless ? KX_KetsjiEngine::HEADLESS : 0) |
+      (m_fastForward ? KX_KetsjiEngine::USE_EXTERNAL_CLOCK : 0) |
       (properties ? KX_KetsjiEngine::SHOW_DEBUG_PROPERTIES : 0) |
       (profile ? KX_KetsjiEngine::SHOW_PROFILE : 0));
 
@@ -174,10 +200,12 @@ void LA_Launcher::InitEngine()
   m_rasterizer->SetStereoMode(m_stereoMode);
   m_rasterizer->SetEyeSeparation(m_startScene->gm.eyeseparation);
 
-  // Copy current anisotropic level to restore it at the game end.
-  m_savedData.anisotropic = m_rasterizer->GetAnisotropicFiltering();
-  // Copy current mipmap mode to restore at the game end.
-  m_savedData.mipmap = m_rasterizer->GetMipmapping();
+  if (!headless) {
+    // Copy current anisotropic level to restore it at the game end.
+    m_savedData.anisotropic = m_rasterizer->GetAnisotropicFiltering();
+    // Copy current mipmap mode to restore at the game end.
+    m_savedData.mipmap = m_rasterizer->GetMipmapping();
+  }
 
   // Create the canvas, rasterizer and rendertools.
   m_canvas = CreateCanvas(m_startScene);
@@ -205,8 +233,10 @@ void LA_Launcher::InitEngine()
 
   // Create the inputdevices.
   m_inputDevice = new DEV_InputDevice();
-  m_eventConsumer = new DEV_EventConsumer(m_system, m_inputDevice, m_canvas);
-  m_system->addEventConsumer(m_eventConsumer);
+  if (!headless) {
+    m_eventConsumer = new DEV_EventConsumer(m_system, m_inputDevice, m_canvas);
+    m_system->addEventConsumer(m_eventConsumer);
+  }
 
   // Create a ketsjisystem (only needed for timing and stuff).
   m_kxsystem = new LA_System();
@@ -233,7 +263,7 @@ void LA_Launcher::InitEngine()
 #endif
 
   m_ketsjiEngine->SetFlag(flags, true);
-  m_ketsjiEngine->SetRender(true);
+  m_ketsjiEngine->SetRender(!headless);
 
   m_ketsjiEngine->SetTicRate(gm.ticrate);
   m_ketsjiEngine->SetMaxLogicFrame(gm.maxlogicstep);
@@ -242,7 +272,9 @@ void LA_Launcher::InitEngine()
   // Set the global settings (carried over if restart/load new files).
   m_ketsjiEngine->SetGlobalSettings(m_globalSettings);
 
-  m_rasterizer->Init(m_canvas);
+  if (!headless) {
+    m_rasterizer->Init(m_canvas);
+  }
   InitCamera();
 
 #ifdef WITH_PYTHON
@@ -292,6 +324,13 @@ void LA_Launcher::ExitEngine()
   DEV_Joystick::Close();
   m_ketsjiEngine->StopEngine();
 
+  if (!m_traceFile.empty()) {
+    CM_Profiler::Stop();
+    if (!CM_Profiler::Save(m_traceFile)) {
+      CM_Error("can't write the profiling trace file \"" << m_traceFile << "\"");
+    }
+  }
+
 #ifdef WITH_PYTHON
 
   /* Clears the dictionary by hand:
@@ -313,11 +352,13 @@ void LA_Launcher::ExitEngine()
     m_canvas->SetMouseState(RAS_ICanvas::MOUSE_NORMAL);
   }
 
-  // Set anisotropic settign back to its original value.
-  m_rasterizer->SetAnisotropicFiltering(m_savedData.anisotropic);
+  if (m_system) {
+    // Set anisotropic settign back to its original value.
+    m_rasterizer->SetAnisotropicFiltering(m_savedData.anisotropic);
 
-  // Set mipmap setting back to its original value.
-  m_rasterizer->SetMipmapping(m_savedData.mipmap);
+    // Set mipmap setting back to its original value.
+    m_rasterizer->SetMipmapping(m_savedData.mipmap);
+  }
 
   // Set vsync mode back to original value.
   m_canvas->SetSwapInterval(m_savedData.vsync);
@@ -458,6 +499,8 @@ bool LA_Launcher::EngineNextFrame()
   // Check if we can create a python console debugging.
   HandlePythonConsole();
 #endif
+  const double frameStartTime = m_kxsystem->GetTimeInSeconds();
+
   // Kick the engine.
   bool renderFrame = m_ketsjiEngine->NextFrame();
 
@@ -471,8 +514,13 @@ bool LA_Launcher::EngineNextFrame()
     }
   }
 
-  m_system->processEvents(false);
-  m_system->dispatchEvents();
+  if (m_system) {
+    m_system->processEvents(false);
+    m_system->dispatchEvents();
+  }
+  else {
+    HeadlessWaitNextFrame(frameStartTime);
+  }
 
   if (m_inputDevice->GetInput((SCA_IInputDevice::SCA_EnumInputs)m_ketsjiEngine->GetExitKey())
           .Find(SCA_InputEvent::ACTIVE) &&
@@ -491,6 +539,29 @@ bool LA_Launcher::EngineNextFrame()
   return (m_exitRequested == KX_ExitRequest::NO_REQUEST);
 }
 
+void LA_Launcher::HeadlessWaitNextFrame(double frameStartTime)
+{
+  const double ticrate = m_ketsjiEngine->GetTicRate();
+  const double timescale = m_ketsjiEngine->GetTimeScale();
+
+  if (m_fastForward) {
+    // Make the next call to NextFrame proceed exactly one logic frame.
+    m_ketsjiEngine->SetClockTime(m_ketsjiEngine->GetClockTime() + timescale / ticrate);
+    return;
+  }
+
+  // Sleep until the next logic frame is due instead of spinning on the clock.
+  double nextFrameDelay = 1.0 / ticrate;
+  if (timescale > 0.0) {
+    nextFrameDelay += (m_ketsjiEngine->GetFrameTime() - m_ketsjiEngine->GetClockTime()) /
+                      timescale;
+  }
+  const double wait = nextFrameDelay - (m_kxsystem->GetTimeInSeconds() - frameStartTime);
+  if (wait > 0.0) {
+    PIL_sleep_ms((int)(wait * 1000.0));
+  }
+}
+
 void LA_Launcher::EngineMainLoop()
 {
 #ifdef WITH_PYTHON
@@ -60,7 +60,7 @@ class LA_Launcher {
   std::string m_exitString;
   GlobalSettings *m_globalSettings;
 
-  /// GHOST system abstraction.
+  /// GHOST system abstraction, nullptr when running headless: without window and render.
   GHOST_ISystem *m_system;
 
   /// The gameengine itself.
@@ -96,6 +96,12 @@ class LA_Launcher {
 
   struct bContext *m_context;
 
+  /// Advance the clock of one logic tic per frame instead of waiting, only when headless.
+  bool m_fastForward;
+
+  /// File the profiling trace is saved to at exit, empty to not record a trace.
+  std::string m_traceFile;
+
   /// Saved data to restore at the game end.
   struct SavedData {
     int vsync;
@@ -114,6 +120,11 @@ class LA_Launcher {
 
   /// Execute engine render, overrided to render background.
   virtual void RenderEngine();
+  /** Wait for the next logic frame when running headless, or advance the clock of one frame in
+   * fast forward.
+   * \param frameStartTime The real time before the last call to KX_KetsjiEngine::NextFrame.
+   */
+  void HeadlessWaitNextFrame(double frameStartTime);
 
 #ifdef WITH_PYTHON
   /** Return true if the user use a valid python script for main loop and copy the python code
@@ -41,6 +41,8 @@ extern "C" {
 #include "BKE_sound.h"
 
 #include "BLI_fileops.h"
+
+#include "DNA_scene_types.h"
 }
 
 #include "MEM_guardedalloc.h"
@@ -137,7 +139,9 @@ void LA_PlayerLauncher::InitEngine()
   BKE_sound_init(m_maggie);
   LA_Launcher::InitEngine();
 
-  m_rasterizer->PrintHardwareInfo();
+  if (m_system) {
+    m_rasterizer->PrintHardwareInfo();
+  }
 }
 
 void LA_PlayerLauncher::ExitEngine()
@@ -148,7 +152,8 @@ void LA_PlayerLauncher::ExitEngine()
 
 bool LA_PlayerLauncher::EngineNextFrame()
 {
-  if (m_inputDevice->GetInput(SCA_IInputDevice::WINRESIZE).Find(SCA_InputEvent::ACTIVE)) {
+  if (m_mainWindow &&
+      m_inputDevice->GetInput(SCA_IInputDevice::WINRESIZE).Find(SCA_InputEvent::ACTIVE)) {
     GHOST_Rect bnds;
     m_mainWindow->getClientBounds(bnds);
     m_canvas->Resize(bnds.getWidth(), bnds.getHeight());
@@ -161,5 +166,11 @@ bool LA_PlayerLauncher::EngineNextFrame()
 
 RAS_ICanvas *LA_PlayerLauncher::CreateCanvas(Scene *startscene)
 {
-  return (new GPG_Canvas(m_rasterizer, m_mainWindow, startscene));
+  GPG_Canvas *canvas = new GPG_Canvas(m_rasterizer, m_mainWindow, startscene);
+  // Without window the canvas keeps the player size for the cameras projection.
+  if (!m_mainWindow) {
+    canvas->Resize(startscene->gm.xplay, startscene->gm.yplay);
+  }
+
+  return canvas;
 }
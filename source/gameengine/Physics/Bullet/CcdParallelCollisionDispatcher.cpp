@@ -0,0 +1,323 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdParallelCollisionDispatcher.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdParallelCollisionDispatcher.h"
+
+#include "BulletCollision/BroadphaseCollision/btOverlappingPairCache.h"
+#include "BulletCollision/CollisionDispatch/btCollisionConfiguration.h"
+#include "BulletCollision/CollisionDispatch/btCollisionObject.h"
+#include "BulletCollision/CollisionDispatch/btConvexConvexAlgorithm.h"
+#include "BulletCollision/CollisionShapes/btCollisionShape.h"
+#include "BulletCollision/NarrowPhaseCollision/btPersistentManifold.h"
+#include "BulletCollision/NarrowPhaseCollision/btVoronoiSimplexSolver.h"
+#include "LinearMath/btPoolAllocator.h"
+
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+#include <algorithm>
+#include <vector>
+
+extern int gNumManifold;
+
+/** Convex algorithm using its own simplex solver, the solver of the default algorithm is
+ * shared by all the algorithms of the collision configuration and can't be used concurrently.
+ */
+class CcdConvexConvexAlgorithm : public btConvexConvexAlgorithm {
+ private:
+  btVoronoiSimplexSolver m_ownSimplexSolver;
+
+ public:
+  CcdConvexConvexAlgorithm(btPersistentManifold *manifold,
+                           const btCollisionAlgorithmConstructionInfo &ci,
+                           const btCollisionObjectWrapper *body0Wrap,
+                           const btCollisionObjectWrapper *body1Wrap,
+                           btConvexPenetrationDepthSolver *pdSolver,
+                           int numPerturbationIterations,
+                           int minimumPointsPerturbationThreshold)
+      // The solver is only referenced by the base class constructor.
+      : btConvexConvexAlgorithm(manifold,
+                                ci,
+                                body0Wrap,
+                                body1Wrap,
+                                &m_ownSimplexSolver,
+                                pdSolver,
+                                numPerturbationIterations,
+                                minimumPointsPerturbationThreshold)
+  {
+  }
+};
+
+class CcdConvexConvexCreateFunc : public btConvexConvexAlgorithm::CreateFunc {
+ public:
+  CcdConvexConvexCreateFunc(const btConvexConvexAlgorithm::CreateFunc &other)
+      : btConvexConvexAlgorithm::CreateFunc(other.m_simplexSolver, other.m_pdSolver)
+  {
+    m_numPerturbationIterations = other.m_numPerturbationIterations;
+    m_minimumPointsPerturbationThreshold = other.m_minimumPointsPerturbationThreshold;
+    m_swapped = other.m_swapped;
+  }
+
+  virtual btCollisionAlgorithm *CreateCollisionAlgorithm(btCollisionAlgorithmConstructionInfo &ci,
+                                                         const btCollisionObjectWrapper *body0Wrap,
+                                                         const btCollisionObjectWrapper *body1Wrap)
+  {
+    void *mem = ci.m_dispatcher1->allocateCollisionAlgorithm(sizeof(CcdConvexConvexAlgorithm));
+    return new (mem) CcdConvexConvexAlgorithm(ci.m_manifold,
+                                              ci,
+                                              body0Wrap,
+                                              body1Wrap,
+                                              m_pdSolver,
+                                              m_numPerturbationIterations,
+                                              m_minimumPointsPerturbationThreshold);
+  }
+};
+
+/// Number of overlapping pairs under which the narrowphase is computed in a single thread.
+#define DISPATCH_PARALLEL_THRESHOLD 256
+/// Number of overlapping pairs dispatched per task.
+#define DISPATCH_CHUNK_SIZE 64
+
+CcdParallelCollisionDispatcher::CcdParallelCollisionDispatcher(
+    btCollisionConfiguration *collisionConfiguration)
+    : btCollisionDispatcher(collisionConfiguration),
+      m_scheduler(nullptr),
+      m_dispatchingInParallel(false)
+{
+  BLI_spin_init(&m_lock);
+
+  // Replace the creation of the default convex algorithms by the thread safe version.
+  btCollisionAlgorithmCreateFunc *defaultFunc =
+      collisionConfiguration->getCollisionAlgorithmCreateFunc(CONVEX_HULL_SHAPE_PROXYTYPE,
+                                                              CONVEX_HULL_SHAPE_PROXYTYPE);
+  m_convexConvexCreateFunc = new CcdConvexConvexCreateFunc(
+      *static_cast<btConvexConvexAlgorithm::CreateFunc *>(defaultFunc));
+
+  for (int i = 0; i < MAX_BROADPHASE_COLLISION_TYPES; ++i) {
+    for (int j = 0; j < MAX_BROADPHASE_COLLISION_TYPES; ++j) {
+      if (m_doubleDispatch[i][j] == defaultFunc) {
+        registerCollisionCreateFunc(i, j, m_convexConvexCreateFunc);
+      }
+    }
+  }
+}
+
+CcdParallelCollisionDispatcher::~CcdParallelCollisionDispatcher()
+{
+  delete m_convexConvexCreateFunc;
+  BLI_spin_end(&m_lock);
+}
+
+int CcdParallelCollisionDispatcher::GetCollisionAlgorithmMaxElementSize()
+{
+  return sizeof(CcdConvexConvexAlgorithm);
+}
+
+void CcdParallelCollisionDispatcher::SetTaskScheduler(TaskScheduler *scheduler)
+{
+  m_scheduler = scheduler;
+}
+
+btPersistentManifold *CcdParallelCollisionDispatcher::getNewManifold(
+    const btCollisionObject *body0, const btCollisionObject *body1)
+{
+  BLI_spin_lock(&m_lock);
+  btPersistentManifold *manifold = btCollisionDispatcher::getNewManifold(body0, body1);
+  BLI_spin_unlock(&m_lock);
+
+  return manifold;
+}
+
+void CcdParallelCollisionDispatcher::releaseManifold(btPersistentManifold *manifold)
+{
+  if (!m_dispatchingInParallel) {
+    btCollisionDispatcher::releaseManifold(manifold);
+    return;
+  }
+
+  clearManifold(manifold);
+
+  BLI_spin_lock(&m_lock);
+  /* Removing the manifold would move the last manifold and change its index while it could be
+   * used by another task, the empty slot is removed once all the pairs are dispatched. */
+  m_manifoldsPtr[manifold->m_index1a] = nullptr;
+  --gNumManifold;
+
+  manifold->~btPersistentManifold();
+  if (m_persistentManifoldPoolAllocator->validPtr(manifold)) {
+    m_persistentManifoldPoolAllocator->freeMemory(manifold);
+  }
+  else {
+    btAlignedFree(manifold);
+  }
+  BLI_spin_unlock(&m_lock);
+}
+
+void *CcdParallelCollisionDispatcher::allocateCollisionAlgorithm(int size)
+{
+  BLI_spin_lock(&m_lock);
+  void *mem;
+  if (size <= m_collisionAlgorithmPoolAllocator->getElementSize() &&
+      m_collisionAlgorithmPoolAllocator->getFreeCount()) {
+    mem = m_collisionAlgorithmPoolAllocator->allocate(size);
+  }
+  else {
+    mem = btAlignedAlloc(size, 16);
+  }
+  BLI_spin_unlock(&m_lock);
+
+  return mem;
+}
+
+void CcdParallelCollisionDispatcher::freeCollisionAlgorithm(void *ptr)
+{
+  BLI_spin_lock(&m_lock);
+  btCollisionDispatcher::freeCollisionAlgorithm(ptr);
+  BLI_spin_unlock(&m_lock);
+}
+
+/// Soft bodies and GImpact shapes are modified by the collision of each of their pairs.
+static bool is_object_parallel_safe(const btCollisionObject *object)
+{
+  return (object->getInternalType() != btCollisionObject::CO_SOFT_BODY &&
+          object->getCollisionShape()->getShapeType() != GIMPACT_SHAPE_PROXYTYPE);
+}
+
+static bool is_pair_parallel_safe(const btBroadphasePair &pair)
+{
+  return (is_object_parallel_safe((btCollisionObject *)pair.m_pProxy0->m_clientObject) &&
+          is_object_parallel_safe((btCollisionObject *)pair.m_pProxy1->m_clientObject));
+}
+
+void CcdParallelCollisionDispatcher::DispatchPairs(btBroadphasePair *begin,
+                                                   btBroadphasePair *end,
+                                                   const btDispatcherInfo &dispatchInfo)
+{
+  btNearCallback nearCallback = getNearCallback();
+  for (btBroadphasePair *pair = begin; pair != end; ++pair) {
+    if (is_pair_parallel_safe(*pair)) {
+      nearCallback(*pair, *this, dispatchInfo);
+    }
+  }
+}
+
+struct DispatchPairsChunk {
+  CcdParallelCollisionDispatcher *m_dispatcher;
+  btBroadphasePair *m_begin;
+  btBroadphasePair *m_end;
+  const btDispatcherInfo *m_dispatchInfo;
+};
+
+static void dispatch_pairs_thread_func(TaskPool *UNUSED(pool),
+                                       void *taskdata,
+                                       int UNUSED(threadid))
+{
+  const DispatchPairsChunk *chunk = (DispatchPairsChunk *)taskdata;
+  chunk->m_dispatcher->DispatchPairs(chunk->m_begin, chunk->m_end, *chunk->m_dispatchInfo);
+}
+
+void CcdParallelCollisionDispatcher::dispatchAllCollisionPairs(
+    btOverlappingPairCache *pairCache,
+    const btDispatcherInfo &dispatchInfo,
+    btDispatcher *dispatcher)
+{
+  const int numPairs = pairCache->getNumOverlappingPairs();
+  // The continuous dispatch writes the time of impact in the shared dispatch info.
+  if (!m_scheduler || numPairs < DISPATCH_PARALLEL_THRESHOLD ||
+      dispatchInfo.m_dispatchFunc != btDispatcherInfo::DISPATCH_DISCRETE ||
+      BLI_task_scheduler_num_threads(m_scheduler) < 2) {
+    btCollisionDispatcher::dispatchAllCollisionPairs(pairCache, dispatchInfo, dispatcher);
+    // The manifolds are in the same order as after a parallel dispatch.
+    SortManifolds();
+    return;
+  }
+
+  btBroadphasePair *pairs = pairCache->getOverlappingPairArrayPtr();
+  std::vector<DispatchPairsChunk> chunks;
+  chunks.reserve(numPairs / DISPATCH_CHUNK_SIZE + 1);
+  for (int i = 0; i < numPairs; i += DISPATCH_CHUNK_SIZE) {
+    const int end = std::min(i + DISPATCH_CHUNK_SIZE, numPairs);
+    chunks.push_back({this, pairs + i, pairs + end, &dispatchInfo});
+  }
+
+  m_dispatchingInParallel = true;
+
+  TaskPool *pool = BLI_task_pool_create(m_scheduler, nullptr);
+  for (DispatchPairsChunk &chunk : chunks) {
+    BLI_task_pool_push(pool, dispatch_pairs_thread_func, &chunk, false, TASK_PRIORITY_HIGH);
+  }
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
+
+  // Dispatch the remaining pairs in their order.
+  btNearCallback nearCallback = getNearCallback();
+  for (int i = 0; i < numPairs; ++i) {
+    if (!is_pair_parallel_safe(pairs[i])) {
+      nearCallback(pairs[i], *this, dispatchInfo);
+    }
+  }
+
+  m_dispatchingInParallel = false;
+
+  SortManifolds();
+}
+
+/// Order the manifolds by the unique identifiers of their objects, assigned in creation order.
+static bool manifold_less(const btPersistentManifold *manifold1,
+                          const btPersistentManifold *manifold2)
+{
+  const int id10 = manifold1->getBody0()->getBroadphaseHandle()->m_uniqueId;
+  const int id20 = manifold2->getBody0()->getBroadphaseHandle()->m_uniqueId;
+  if (id10 != id20) {
+    return (id10 < id20);
+  }
+  return (manifold1->getBody1()->getBroadphaseHandle()->m_uniqueId <
+          manifold2->getBody1()->getBroadphaseHandle()->m_uniqueId);
+}
+
+void CcdParallelCollisionDispatcher::SortManifolds()
+{
+  int numManifolds = 0;
+  for (int i = 0, size = m_manifoldsPtr.size(); i < size; ++i) {
+    if (m_manifoldsPtr[i]) {
+      m_manifoldsPtr[numManifolds++] = m_manifoldsPtr[i];
+    }
+  }
+  m_manifoldsPtr.resize(numManifolds);
+
+  if (numManifolds == 0) {
+    return;
+  }
+
+  /* The manifolds of a same pair are created in order by a single task, a stable sort gives
+   * the same order whatever the number of threads. */
+  btPersistentManifold **manifolds = &m_manifoldsPtr[0];
+  std::stable_sort(manifolds, manifolds + numManifolds, manifold_less);
+
+  for (int i = 0; i < numManifolds; ++i) {
+    manifolds[i]->m_index1a = i;
+  }
+}
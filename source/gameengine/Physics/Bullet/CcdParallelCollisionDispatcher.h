@@ -0,0 +1,84 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdParallelCollisionDispatcher.h
+ *  \ingroup physbullet
+ */
+
+#ifndef __CCDPARALLELCOLLISIONDISPATCHER_H__
+#define __CCDPARALLELCOLLISIONDISPATCHER_H__
+
+#include "BulletCollision/CollisionDispatch/btCollisionDispatcher.h"
+
+#include "BLI_threads.h"
+
+struct TaskScheduler;
+class CcdConvexConvexCreateFunc;
+
+/** Collision dispatcher computing the narrowphase of the overlapping pairs in parallel.
+ * The pairs are independent except for the shared pools and manifold array which are locked,
+ * the manifolds created or released by the tasks are sorted afterward so the result doesn't
+ * depend on the order the tasks were run.
+ * With few pairs or threads the pairs are dispatched by the default Bullet implementation and
+ * the manifolds are sorted the same way, the result doesn't depend on the number of threads.
+ */
+class CcdParallelCollisionDispatcher : public btCollisionDispatcher {
+ private:
+  /// Scheduler of the narrowphase tasks, nullptr to dispatch in a single thread.
+  TaskScheduler *m_scheduler;
+  /// Lock of the pools and of the manifold array used by the narrowphase tasks.
+  SpinLock m_lock;
+  /// True while the pairs are dispatched by the tasks.
+  bool m_dispatchingInParallel;
+  /// Creation of the convex algorithms which share a simplex solver by default.
+  CcdConvexConvexCreateFunc *m_convexConvexCreateFunc;
+
+  /// Remove the manifolds released during the parallel dispatch and sort the manifolds by pair.
+  void SortManifolds();
+
+ public:
+  CcdParallelCollisionDispatcher(btCollisionConfiguration *collisionConfiguration);
+  virtual ~CcdParallelCollisionDispatcher();
+
+  /// Return the size of the largest collision algorithm allocated by the dispatcher.
+  static int GetCollisionAlgorithmMaxElementSize();
+
+  void SetTaskScheduler(TaskScheduler *scheduler);
+
+  virtual btPersistentManifold *getNewManifold(const btCollisionObject *body0,
+                                               const btCollisionObject *body1);
+  virtual void releaseManifold(btPersistentManifold *manifold);
+
+  virtual void *allocateCollisionAlgorithm(int size);
+  virtual void freeCollisionAlgorithm(void *ptr);
+
+  virtual void dispatchAllCollisionPairs(btOverlappingPairCache *pairCache,
+                                         const btDispatcherInfo &dispatchInfo,
+                                         btDispatcher *dispatcher);
+
+  /// Dispatch a range of pairs, the pairs not safe to dispatch in parallel are skipped.
+  void DispatchPairs(btBroadphasePair *begin,
+                     btBroadphasePair *end,
+                     const btDispatcherInfo &dispatchInfo);
+};
+
+#endif  // __CCDPARALLELCOLLISIONDISPATCHER_H__
@@ -0,0 +1,299 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdParallelDynamicsWorld.cpp
+ *  \ingroup physbullet
+ */
+
+#include "CcdParallelDynamicsWorld.h"
+
+#include "BulletCollision/CollisionDispatch/btSimulationIslandManager.h"
+#include "BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolver.h"
+#include "BulletDynamics/ConstraintSolver/btTypedConstraint.h"
+#include "BulletDynamics/Dynamics/btRigidBody.h"
+#include "LinearMath/btQuickprof.h"
+
+#include "BLI_task.h"
+#include "BLI_utildefines.h"
+
+void CcdParallelDynamicsWorld::IslandSet::Clear()
+{
+  m_bodies.clear();
+  m_manifolds.clear();
+  m_constraints.clear();
+  m_batches.clear();
+  BeginBatch();
+}
+
+void CcdParallelDynamicsWorld::IslandSet::BeginBatch()
+{
+  m_batches.push_back({(int)m_bodies.size(),
+                       0,
+                       (int)m_manifolds.size(),
+                       0,
+                       (int)m_constraints.size(),
+                       0});
+}
+
+bool CcdParallelDynamicsWorld::IslandSet::IsBatchEmpty() const
+{
+  // An island always contains at least one body.
+  return (m_batches.back().m_numBodies == 0);
+}
+
+void CcdParallelDynamicsWorld::IslandSet::AddIsland(btCollisionObject **bodies,
+                                                     int numBodies,
+                                                     btPersistentManifold **manifolds,
+                                                     int numManifolds,
+                                                     btTypedConstraint **constraints,
+                                                     int numConstraints)
+{
+  m_bodies.insert(m_bodies.end(), bodies, bodies + numBodies);
+  m_manifolds.insert(m_manifolds.end(), manifolds, manifolds + numManifolds);
+  m_constraints.insert(m_constraints.end(), constraints, constraints + numConstraints);
+
+  IslandBatch &batch = m_batches.back();
+  batch.m_numBodies += numBodies;
+  batch.m_numManifolds += numManifolds;
+  batch.m_numConstraints += numConstraints;
+}
+
+/// Same island of a constraint as the default Bullet world.
+static int get_constraint_island_id(const btTypedConstraint *constraint)
+{
+  const btCollisionObject &object0 = constraint->getRigidBodyA();
+  const btCollisionObject &object1 = constraint->getRigidBodyB();
+  return (object0.getIslandTag() >= 0) ? object0.getIslandTag() : object1.getIslandTag();
+}
+
+class CcdConstraintIslandLess {
+ public:
+  bool operator()(const btTypedConstraint *constraint1, const btTypedConstraint *constraint2) const
+  {
+    return (get_constraint_island_id(constraint1) < get_constraint_island_id(constraint2));
+  }
+};
+
+/// Copy the islands built by the island manager into the parallel and serial sets.
+class CcdIslandRecorder : public btSimulationIslandManager::IslandCallback {
+ private:
+  CcdParallelDynamicsWorld::IslandSet &m_parallelIslands;
+  CcdParallelDynamicsWorld::IslandSet &m_serialIslands;
+  btTypedConstraint **m_sortedConstraints;
+  int m_numConstraints;
+  /// Index of the first constraint not yet attributed to an island.
+  int m_constraintIndex;
+  /// Number of manifolds and constraints over which a batch of islands is completed.
+  int m_minimumBatchSize;
+
+ public:
+  CcdIslandRecorder(CcdParallelDynamicsWorld::IslandSet &parallelIslands,
+                    CcdParallelDynamicsWorld::IslandSet &serialIslands,
+                    btTypedConstraint **sortedConstraints,
+                    int numConstraints,
+                    int minimumBatchSize)
+      : m_parallelIslands(parallelIslands),
+        m_serialIslands(serialIslands),
+        m_sortedConstraints(sortedConstraints),
+        m_numConstraints(numConstraints),
+        m_constraintIndex(0),
+        m_minimumBatchSize(minimumBatchSize)
+  {
+  }
+
+  virtual void processIsland(btCollisionObject **bodies,
+                             int numBodies,
+                             btPersistentManifold **manifolds,
+                             int numManifolds,
+                             int islandId)
+  {
+    // The islands are not split, all the objects are solved together.
+    if (islandId < 0) {
+      m_serialIslands.AddIsland(
+          bodies, numBodies, manifolds, numManifolds, m_sortedConstraints, m_numConstraints);
+      return;
+    }
+
+    // The islands are processed by increasing identifier, as the sorted constraints.
+    while (m_constraintIndex < m_numConstraints &&
+           get_constraint_island_id(m_sortedConstraints[m_constraintIndex]) < islandId) {
+      ++m_constraintIndex;
+    }
+    btTypedConstraint **constraints = m_sortedConstraints + m_constraintIndex;
+    while (m_constraintIndex < m_numConstraints &&
+           get_constraint_island_id(m_sortedConstraints[m_constraintIndex]) == islandId) {
+      ++m_constraintIndex;
+    }
+    const int numConstraints = (m_sortedConstraints + m_constraintIndex) - constraints;
+
+    // Kinematic objects are not part of the island bodies but can be shared by islands.
+    bool kinematic = false;
+    for (int i = 0; i < numManifolds && !kinematic; ++i) {
+      kinematic = (manifolds[i]->getBody0()->isKinematicObject() ||
+                   manifolds[i]->getBody1()->isKinematicObject());
+    }
+    for (int i = 0; i < numConstraints && !kinematic; ++i) {
+      kinematic = (constraints[i]->getRigidBodyA().isKinematicObject() ||
+                   constraints[i]->getRigidBodyB().isKinematicObject());
+    }
+
+    if (kinematic) {
+      m_serialIslands.AddIsland(
+          bodies, numBodies, manifolds, numManifolds, constraints, numConstraints);
+      return;
+    }
+
+    m_parallelIslands.AddIsland(
+        bodies, numBodies, manifolds, numManifolds, constraints, numConstraints);
+
+    const CcdParallelDynamicsWorld::IslandBatch &batch = m_parallelIslands.m_batches.back();
+    if ((batch.m_numManifolds + batch.m_numConstraints) >= m_minimumBatchSize) {
+      m_parallelIslands.BeginBatch();
+    }
+  }
+};
+
+CcdParallelDynamicsWorld::CcdParallelDynamicsWorld(
+    btDispatcher *dispatcher,
+    btBroadphaseInterface *pairCache,
+    btConstraintSolver *constraintSolver,
+    btCollisionConfiguration *collisionConfiguration)
+    : btSoftRigidDynamicsWorld(dispatcher, pairCache, constraintSolver, collisionConfiguration),
+      m_scheduler(nullptr)
+{
+}
+
+CcdParallelDynamicsWorld::~CcdParallelDynamicsWorld()
+{
+  SetTaskScheduler(nullptr);
+}
+
+void CcdParallelDynamicsWorld::SetTaskScheduler(TaskScheduler *scheduler)
+{
+  for (btSequentialImpulseConstraintSolver *solver : m_threadSolvers) {
+    delete solver;
+  }
+  m_threadSolvers.clear();
+
+  m_scheduler = scheduler;
+
+  if (m_scheduler) {
+    // The thread ids go from 0 for the thread waiting the tasks to the number of threads.
+    const int numThreads = BLI_task_scheduler_num_threads(m_scheduler) + 1;
+    for (int i = 0; i < numThreads; ++i) {
+      m_threadSolvers.push_back(new btSequentialImpulseConstraintSolver());
+    }
+  }
+}
+
+void CcdParallelDynamicsWorld::SolveIslandBatch(IslandSet &islands,
+                                                const IslandBatch &batch,
+                                                const btContactSolverInfo &solverInfo,
+                                                int threadid)
+{
+  btSequentialImpulseConstraintSolver *solver = m_threadSolvers[threadid];
+  // Don't depend on the batches previously solved by the thread.
+  solver->setRandSeed(0);
+  solver->solveGroup(islands.m_bodies.data() + batch.m_firstBody,
+                     batch.m_numBodies,
+                     islands.m_manifolds.data() + batch.m_firstManifold,
+                     batch.m_numManifolds,
+                     islands.m_constraints.data() + batch.m_firstConstraint,
+                     batch.m_numConstraints,
+                     solverInfo,
+                     m_debugDrawer,
+                     m_dispatcher1);
+}
+
+struct SolveIslandBatchTask {
+  CcdParallelDynamicsWorld *m_world;
+  CcdParallelDynamicsWorld::IslandSet *m_islands;
+  const CcdParallelDynamicsWorld::IslandBatch *m_batch;
+  const btContactSolverInfo *m_solverInfo;
+};
+
+static void solve_island_batch_thread_func(TaskPool *UNUSED(pool), void *taskdata, int threadid)
+{
+  const SolveIslandBatchTask *task = (SolveIslandBatchTask *)taskdata;
+  task->m_world->SolveIslandBatch(*task->m_islands, *task->m_batch, *task->m_solverInfo, threadid);
+}
+
+void CcdParallelDynamicsWorld::solveConstraints(btContactSolverInfo &solverInfo)
+{
+  if (!m_scheduler) {
+    btSoftRigidDynamicsWorld::solveConstraints(solverInfo);
+    return;
+  }
+
+  BT_PROFILE("solveConstraints");
+
+  const int numConstraints = getNumConstraints();
+  m_sortedConstraints.resize(numConstraints);
+  for (int i = 0; i < numConstraints; ++i) {
+    m_sortedConstraints[i] = m_constraints[i];
+  }
+  m_sortedConstraints.quickSort(CcdConstraintIslandLess());
+
+  m_parallelIslands.Clear();
+  m_serialIslands.Clear();
+
+  CcdIslandRecorder recorder(m_parallelIslands,
+                             m_serialIslands,
+                             (numConstraints > 0) ? &m_sortedConstraints[0] : nullptr,
+                             numConstraints,
+                             solverInfo.m_minimumSolverBatchSize);
+
+  m_constraintSolver->prepareSolve(getNumCollisionObjects(), m_dispatcher1->getNumManifolds());
+
+  m_islandManager->buildAndProcessIslands(m_dispatcher1, this, &recorder);
+
+  if (m_parallelIslands.IsBatchEmpty()) {
+    m_parallelIslands.m_batches.pop_back();
+  }
+
+  const std::vector<IslandBatch> &batches = m_parallelIslands.m_batches;
+  if (batches.size() > 1 && BLI_task_scheduler_num_threads(m_scheduler) > 1) {
+    std::vector<SolveIslandBatchTask> tasks;
+    tasks.reserve(batches.size());
+    for (const IslandBatch &batch : batches) {
+      tasks.push_back({this, &m_parallelIslands, &batch, &solverInfo});
+    }
+
+    TaskPool *pool = BLI_task_pool_create(m_scheduler, nullptr);
+    for (SolveIslandBatchTask &task : tasks) {
+      BLI_task_pool_push(pool, solve_island_batch_thread_func, &task, false, TASK_PRIORITY_HIGH);
+    }
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+  else {
+    for (const IslandBatch &batch : batches) {
+      SolveIslandBatch(m_parallelIslands, batch, solverInfo, 0);
+    }
+  }
+
+  if (!m_serialIslands.IsBatchEmpty()) {
+    SolveIslandBatch(m_serialIslands, m_serialIslands.m_batches.back(), solverInfo, 0);
+  }
+
+  m_constraintSolver->allSolved(solverInfo, m_debugDrawer);
+}
@@ -0,0 +1,106 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdParallelDynamicsWorld.h
+ *  \ingroup physbullet
+ */
+
+#ifndef __CCDPARALLELDYNAMICSWORLD_H__
+#define __CCDPARALLELDYNAMICSWORLD_H__
+
+#include "BulletSoftBody/btSoftRigidDynamicsWorld.h"
+
+#include <vector>
+
+struct TaskScheduler;
+class btSequentialImpulseConstraintSolver;
+
+/** Dynamics world solving the simulation islands in parallel.
+ * The islands are grouped in batches in island order and each batch is solved by a sequential
+ * impulse solver reset before use, the result doesn't depend on the number of threads.
+ * The islands touching a kinematic object are solved in a single thread after the others as
+ * the solver writes its temporary data in the kinematic objects shared between islands.
+ * Without scheduler the constraints are solved by the default Bullet implementation.
+ */
+class CcdParallelDynamicsWorld : public btSoftRigidDynamicsWorld {
+ public:
+  /// Range of the bodies, manifolds and constraints of islands solved together.
+  struct IslandBatch {
+    int m_firstBody;
+    int m_numBodies;
+    int m_firstManifold;
+    int m_numManifolds;
+    int m_firstConstraint;
+    int m_numConstraints;
+  };
+
+  /// Islands copied from the island manager to be solved once all the islands are known.
+  struct IslandSet {
+    std::vector<btCollisionObject *> m_bodies;
+    std::vector<btPersistentManifold *> m_manifolds;
+    std::vector<btTypedConstraint *> m_constraints;
+    std::vector<IslandBatch> m_batches;
+
+    void Clear();
+    /// Start a new batch at the end of the arrays.
+    void BeginBatch();
+    /// Return true if the current batch is empty.
+    bool IsBatchEmpty() const;
+    void AddIsland(btCollisionObject **bodies,
+                   int numBodies,
+                   btPersistentManifold **manifolds,
+                   int numManifolds,
+                   btTypedConstraint **constraints,
+                   int numConstraints);
+  };
+
+ private:
+  /// Scheduler of the solver tasks, nullptr to solve the islands in a single thread.
+  TaskScheduler *m_scheduler;
+  /// Solver of each thread of the scheduler indexed by thread id.
+  std::vector<btSequentialImpulseConstraintSolver *> m_threadSolvers;
+
+  /// Islands without kinematic objects solved in parallel.
+  IslandSet m_parallelIslands;
+  /// Islands with kinematic objects solved in a single batch.
+  IslandSet m_serialIslands;
+
+ protected:
+  virtual void solveConstraints(btContactSolverInfo &solverInfo);
+
+ public:
+  CcdParallelDynamicsWorld(btDispatcher *dispatcher,
+                           btBroadphaseInterface *pairCache,
+                           btConstraintSolver *constraintSolver,
+                           btCollisionConfiguration *collisionConfiguration);
+  virtual ~CcdParallelDynamicsWorld();
+
+  void SetTaskScheduler(TaskScheduler *scheduler);
+
+  /// Solve a batch of islands with the solver of a thread.
+  void SolveIslandBatch(IslandSet &islands,
+                        const IslandBatch &batch,
+                        const btContactSolverInfo &solverInfo,
+                        int threadid);
+};
+
+#endif  // __CCDPARALLELDYNAMICSWORLD_H__
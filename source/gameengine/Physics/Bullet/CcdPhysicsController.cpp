@@ -23,9 +23,12 @@
 #  include <stdint.h>
 #endif
 
+#include <atomic>
+
 #include "CM_Message.h"
 
 #include "CcdPhysicsController.h"
+#include "CcdShapeCache.h"
 #include "btBulletDynamicsCommon.h"
 #include "BulletCollision/CollisionDispatch/btGhostObject.h"
 #include "BulletCollision/CollisionShapes/btScaledBvhTriangleMeshShape.h"
@@ -189,8 +192,12 @@ bool CleanPairCallback::processOverlap(btBroadphasePair &pair)
   return false;
 }
 
+/// Last identifier given to a controller, the scenes can be converted in loading threads.
+static std::atomic<unsigned long long> lastSnapshotId(0);
+
 CcdPhysicsController::CcdPhysicsController(const CcdConstructionInfo &ci) : m_cci(ci)
 {
+  m_snapshotId = ++lastSnapshotId;
   m_prototypeTransformInitialized = false;
   m_softbodyMappingDone = false;
   m_collisionDelay = 0;
@@ -220,6 +227,8 @@ CcdPhysicsController::CcdPhysicsController(const CcdConstructionInfo &ci) : m_cc
   m_savedMass = 0.0f;
   m_savedDyna = false;
   m_suspended = false;
+  m_motionStateModified = true;
+  m_compoundModified = false;
 
   CreateRigidbody();
 }
@@ -699,6 +708,12 @@ bool CcdPhysicsController::DeleteControllerShape()
   return false;
 }
 
+/// Return the shape cache of the environment of a controller or nullptr.
+static CcdShapeCache *get_shape_cache(const CcdConstructionInfo &cci)
+{
+  return (cci.m_physicsEnv) ? cci.m_physicsEnv->GetShapeCache() : nullptr;
+}
+
 bool CcdPhysicsController::ReplaceControllerShape(btCollisionShape *newShape)
 {
   if (m_collisionShape)
@@ -706,7 +721,8 @@ bool CcdPhysicsController::ReplaceControllerShape(btCollisionShape *newShape)
 
   // If newShape is nullptr it means to create a new Bullet shape.
   if (!newShape)
-    newShape = m_shapeInfo->CreateBulletShape(m_cci.m_margin, m_cci.m_bGimpact, !m_cci.m_bSoft);
+    newShape = m_shapeInfo->CreateBulletShape(
+        m_cci.m_margin, m_cci.m_bGimpact, !m_cci.m_bSoft, get_shape_cache(m_cci));
 
   m_object->setCollisionShape(newShape);
   m_collisionShape = newShape;
@@ -742,8 +758,12 @@ bool CcdPhysicsController::ReplaceControllerShape(btCollisionShape *newShape)
 CcdPhysicsController::~CcdPhysicsController()
 {
   // will be reference counted, due to sharing
-  if (m_cci.m_physicsEnv)
+  if (m_cci.m_physicsEnv) {
     m_cci.m_physicsEnv->RemoveCcdPhysicsController(this, true);
+    if (m_compoundModified) {
+      m_cci.m_physicsEnv->RemoveModifiedCompound(this);
+    }
+  }
 
   if (m_MotionState)
     delete m_MotionState;
@@ -829,12 +849,26 @@ bool CcdPhysicsController::SynchronizeMotionStates(float time)
     m_MotionState->CalculateWorldTransformations();
   }
 
-  const MT_Vector3 &scale = m_MotionState->GetWorldScaling();
-  GetCollisionShape()->setLocalScaling(ToBullet(scale));
+  const btVector3 scale = ToBullet(m_MotionState->GetWorldScaling());
+  btCollisionShape *shape = GetCollisionShape();
+  // Avoid the recomputation of the shape bounds when the scale is unchanged.
+  if (shape->getLocalScaling() != scale) {
+    shape->setLocalScaling(scale);
+  }
 
   return true;
 }
 
+bool CcdPhysicsController::SynchronizeModifiedMotionState(float time)
+{
+  if (!m_motionStateModified && !m_object->isActive()) {
+    return false;
+  }
+
+  m_motionStateModified = false;
+  return SynchronizeMotionStates(time);
+}
+
 /**
  * WriteMotionStateToDynamics synchronizes dynas, kinematic and deformable entities (and do 'late
  * binding')
@@ -854,7 +888,10 @@ void CcdPhysicsController::PostProcessReplica(class PHY_IMotionState *motionstat
                                               class PHY_IPhysicsController *parentctrl)
 {
   SetParentCtrl((CcdPhysicsController *)parentctrl);
+  m_snapshotId = ++lastSnapshotId;
   m_softBodyTransformInitialized = false;
+  m_motionStateModified = true;
+  m_compoundModified = false;
   m_MotionState = motionstate;
   m_registerCount = 0;
   m_collisionShape = nullptr;
@@ -866,7 +903,7 @@ void CcdPhysicsController::PostProcessReplica(class PHY_IMotionState *motionstat
   if (m_shapeInfo) {
     m_shapeInfo->AddRef();
     m_collisionShape = m_shapeInfo->CreateBulletShape(
-        m_cci.m_margin, m_cci.m_bGimpact, !m_cci.m_bSoft);
+        m_cci.m_margin, m_cci.m_bGimpact, !m_cci.m_bSoft, get_shape_cache(m_cci));
 
     if (m_collisionShape) {
       // new shape has no scaling, apply initial scaling
@@ -1174,6 +1211,8 @@ void CcdPhysicsController::SetTransform()
   const MT_Vector3 pos = m_MotionState->GetWorldPosition();
   const MT_Matrix3x3 rot = m_MotionState->GetWorldOrientation();
   ForceWorldTransform(ToBullet(rot), ToBullet(pos));
+  // The scale can change with the transform, e.g when a parent is scaled.
+  m_motionStateModified = true;
 
   if (!IsDynamic() && !GetConstructionInfo().m_bSensor && !GetCharacterController()) {
     btCollisionObject *object = GetRigidBody();
@@ -1567,7 +1606,10 @@ void CcdPhysicsController::AddCompoundChild(PHY_IPhysicsController *child)
   GetShapeInfo()->AddShape(proxyShapeInfo);
   // create new bullet collision shape from the object shapeinfo and set scaling
   btCollisionShape *newChildShape = proxyShapeInfo->CreateBulletShape(
-      childCtrl->GetMargin(), childCtrl->GetConstructionInfo().m_bGimpact, true);
+      childCtrl->GetMargin(),
+      childCtrl->GetConstructionInfo().m_bGimpact,
+      true,
+      get_shape_cache(m_cci));
   newChildShape->setLocalScaling(relativeScale);
   // add bullet collision shape to parent compound collision shape
   compoundShape->addChildShape(proxyShapeInfo->m_childTrans, newChildShape);
@@ -1575,15 +1617,8 @@ void CcdPhysicsController::AddCompoundChild(PHY_IPhysicsController *child)
   proxyShapeInfo->Release();
   // remember we created this shape
   childCtrl->m_bulletChildShape = newChildShape;
-  // recompute inertia of parent
-  if (!rootBody->isStaticOrKinematicObject()) {
-    btVector3 localInertia;
-    float mass = 1.0f / rootBody->getInvMass();
-    compoundShape->calculateLocalInertia(mass, localInertia);
-    rootBody->setMassProps(mass, localInertia);
-  }
-  // must update the broadphase cache,
-  GetPhysicsEnvironment()->RefreshCcdPhysicsController(this);
+  // inertia and broadphase cache are updated once for all the children added in the frame
+  SetCompoundModified();
   // remove the children
   GetPhysicsEnvironment()->RemoveCcdPhysicsController(childCtrl, true);
 }
@@ -1619,25 +1654,50 @@ void CcdPhysicsController::RemoveCompoundChild(PHY_IPhysicsController *child)
     int numChildren = compoundShape->getNumChildShapes();
     for (i = 0; i < numChildren; i++) {
       if (compoundShape->getChildShape(i) == childCtrl->m_bulletChildShape) {
+        // Removed from the dynamic tree of the compound, the bounds are updated later.
         compoundShape->removeChildShapeByIndex(i);
-        compoundShape->recalculateLocalAabb();
         break;
       }
     }
     delete childCtrl->m_bulletChildShape;
     childCtrl->m_bulletChildShape = nullptr;
   }
+  // bounds, inertia and broadphase cache are updated once for all the children removed
+  SetCompoundModified();
+  // reactivate the children
+  GetPhysicsEnvironment()->AddCcdPhysicsController(childCtrl);
+}
+
+void CcdPhysicsController::SetCompoundModified()
+{
+  if (!m_compoundModified) {
+    m_compoundModified = true;
+    GetPhysicsEnvironment()->AddModifiedCompound(this);
+  }
+}
+
+void CcdPhysicsController::UpdateCompound()
+{
+  m_compoundModified = false;
+
+  btRigidBody *body = GetRigidBody();
+  if (!body || !body->getCollisionShape()->isCompound()) {
+    return;
+  }
+
+  btCompoundShape *compoundShape = (btCompoundShape *)body->getCollisionShape();
+  // The removed children don't shrink the bounds of the compound.
+  compoundShape->recalculateLocalAabb();
+
   // recompute inertia of parent
-  if (!rootBody->isStaticOrKinematicObject()) {
+  if (!body->isStaticOrKinematicObject()) {
     btVector3 localInertia;
-    float mass = 1.f / rootBody->getInvMass();
+    float mass = 1.0f / body->getInvMass();
     compoundShape->calculateLocalInertia(mass, localInertia);
-    rootBody->setMassProps(mass, localInertia);
+    body->setMassProps(mass, localInertia);
   }
   // must update the broadphase cache,
   GetPhysicsEnvironment()->RefreshCcdPhysicsController(this);
-  // reactivate the children
-  GetPhysicsEnvironment()->AddCcdPhysicsController(childCtrl);
 }
 
 PHY_IPhysicsController *CcdPhysicsController::GetReplica()
@@ -1858,6 +1918,8 @@ void CcdShapeConstructionInfo::ProcessReplica()
   m_userData = nullptr;
   m_meshObject = nullptr;
   m_triangleIndexVertexArray = nullptr;
+  m_optimizedBvh = nullptr;
+  m_optimizedBvhBuffer = nullptr;
   m_forceReInstance = false;
   m_shapeProxy = nullptr;
   m_vertexArray.clear();
@@ -2777,13 +2839,14 @@ bool CcdShapeConstructionInfo::SetProxy(CcdShapeConstructionInfo *shapeInfo)
 
 btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
                                                               bool useGimpact,
-                                                              bool useBvh)
+                                                              bool useBvh,
+                                                              CcdShapeCache *shapeCache)
 {
   btCollisionShape *collisionShape = nullptr;
   btCompoundShape *compoundShape = nullptr;
 
   if (m_shapeType == PHY_SHAPE_PROXY && m_shapeProxy != nullptr)
-    return m_shapeProxy->CreateBulletShape(margin, useGimpact, useBvh);
+    return m_shapeProxy->CreateBulletShape(margin, useGimpact, useBvh, shapeCache);
 
   switch (m_shapeType) {
     default:
@@ -2832,6 +2895,7 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
         if (!m_triangleIndexVertexArray || m_forceReInstance) {
           if (m_triangleIndexVertexArray)
             delete m_triangleIndexVertexArray;
+          FreeOptimizedBvh();
 
           m_triangleIndexVertexArray = new btTriangleIndexVertexArray(m_polygonIndexArray.size(),
                                                                       m_triFaceArray.data(),
@@ -2849,6 +2913,7 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
       }
       else {
         if (!m_triangleIndexVertexArray || m_forceReInstance) {
+          FreeOptimizedBvh();
           /// enable welding, only for the objects that need it (such as soft bodies)
           if (0.0f != m_weldingThreshold1) {
             btTriangleMesh *collisionMeshData = new btTriangleMesh(true, false);
@@ -2882,7 +2947,10 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
         }
 
         btBvhTriangleMeshShape *unscaledShape = new btBvhTriangleMeshShape(
-            m_triangleIndexVertexArray, true, useBvh);
+            m_triangleIndexVertexArray, true, false);
+        if (useBvh) {
+          SetupOptimizedBvh(unscaledShape, shapeCache);
+        }
         unscaledShape->setMargin(margin);
         collisionShape = new btScaledBvhTriangleMeshShape(unscaledShape,
                                                           btVector3(1.0f, 1.0f, 1.0f));
@@ -2896,7 +2964,7 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
         for (std::vector<CcdShapeConstructionInfo *>::iterator sit = m_shapeArray.begin();
              sit != m_shapeArray.end();
              sit++) {
-          collisionShape = (*sit)->CreateBulletShape(margin, useGimpact, useBvh);
+          collisionShape = (*sit)->CreateBulletShape(margin, useGimpact, useBvh, shapeCache);
           if (collisionShape) {
             collisionShape->setLocalScaling((*sit)->m_childScale);
             compoundShape->addChildShape((*sit)->m_childTrans, collisionShape);
@@ -2909,6 +2977,42 @@ btCollisionShape *CcdShapeConstructionInfo::CreateBulletShape(btScalar margin,
   return collisionShape;
 }
 
+void CcdShapeConstructionInfo::SetupOptimizedBvh(btBvhTriangleMeshShape *shape,
+                                                 CcdShapeCache *shapeCache)
+{
+  if (!m_optimizedBvh && shapeCache) {
+    m_optimizedBvh = shapeCache->LoadBvh(m_triangleIndexVertexArray, &m_optimizedBvhBuffer);
+  }
+
+  if (!m_optimizedBvh) {
+    // Same build as btBvhTriangleMeshShape but kept to be shared by all the shapes.
+    void *mem = btAlignedAlloc(sizeof(btOptimizedBvh), 16);
+    m_optimizedBvh = new (mem) btOptimizedBvh();
+    m_optimizedBvh->build(
+        m_triangleIndexVertexArray, true, shape->getLocalAabbMin(), shape->getLocalAabbMax());
+
+    if (shapeCache) {
+      shapeCache->SaveBvh(m_triangleIndexVertexArray, m_optimizedBvh);
+    }
+  }
+
+  shape->setOptimizedBvh(m_optimizedBvh);
+}
+
+void CcdShapeConstructionInfo::FreeOptimizedBvh()
+{
+  if (m_optimizedBvhBuffer) {
+    // The hierarchy was deserialized in place and doesn't own its arrays.
+    btAlignedFree(m_optimizedBvhBuffer);
+    m_optimizedBvhBuffer = nullptr;
+  }
+  else if (m_optimizedBvh) {
+    m_optimizedBvh->~btOptimizedBvh();
+    btAlignedFree(m_optimizedBvh);
+  }
+  m_optimizedBvh = nullptr;
+}
+
 void CcdShapeConstructionInfo::AddShape(CcdShapeConstructionInfo *shapeInfo)
 {
   m_shapeArray.push_back(shapeInfo);
@@ -2924,6 +3028,7 @@ CcdShapeConstructionInfo::~CcdShapeConstructionInfo()
   }
   m_shapeArray.clear();
 
+  FreeOptimizedBvh();
   if (m_triangleIndexVertexArray)
     delete m_triangleIndexVertexArray;
   m_vertexArray.clear();
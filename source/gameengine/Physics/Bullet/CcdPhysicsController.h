@@ -47,6 +47,7 @@ extern float gAngularSleepingTreshold;
 extern bool gDisableDeactivation;
 class CcdPhysicsEnvironment;
 class CcdPhysicsController;
+class CcdShapeCache;
 class btMotionState;
 class RAS_MeshObject;
 struct DerivedMesh;
@@ -84,6 +85,8 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
         m_userData(nullptr),
         m_meshObject(nullptr),
         m_triangleIndexVertexArray(nullptr),
+        m_optimizedBvh(nullptr),
+        m_optimizedBvhBuffer(nullptr),
         m_forceReInstance(false),
         m_weldingThreshold1(0.0f),
         m_shapeProxy(nullptr)
@@ -161,9 +164,13 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
     return m_shapeProxy;
   }
 
+  /** Create the bullet shape.
+   * \param shapeCache The cache of the triangle mesh hierarchies to use, can be nullptr.
+   */
   btCollisionShape *CreateBulletShape(btScalar margin,
                                       bool useGimpact = false,
-                                      bool useBvh = true);
+                                      bool useBvh = true,
+                                      CcdShapeCache *shapeCache = nullptr);
 
   // member variables
   PHY_ShapeType m_shapeType;
@@ -199,8 +206,17 @@ class CcdShapeConstructionInfo : public CM_RefCount<CcdShapeConstructionInfo> {
   RAS_MeshObject *m_meshObject;
   /// The list of vertexes and indexes for the triangle mesh, shared between Bullet shape.
   btTriangleIndexVertexArray *m_triangleIndexVertexArray;
+  /// The hierarchy of the triangle mesh, shared between Bullet shape.
+  btOptimizedBvh *m_optimizedBvh;
+  /// The memory of the hierarchy if loaded from the shape cache.
+  void *m_optimizedBvhBuffer;
   /// for compound shapes
   std::vector<CcdShapeConstructionInfo *> m_shapeArray;
+
+  /// Set the hierarchy of a triangle mesh shape, loaded from the shape cache or built once.
+  void SetupOptimizedBvh(btBvhTriangleMeshShape *shape, CcdShapeCache *shapeCache);
+  void FreeOptimizedBvh();
+
   /// use gimpact for concave dynamic/moving collision detection
   bool m_forceReInstance;
   /// welding closeby vertices together can improve softbody stability etc.
@@ -576,9 +592,20 @@ class CcdPhysicsController : public PHY_IPhysicsController {
   MT_Scalar m_savedMass;
   bool m_savedDyna;
   bool m_suspended;
+  /// The transform was set from the motion state since the last synchronization.
+  bool m_motionStateModified;
+  /// Children were added to or removed from the compound shape since the last physics step.
+  bool m_compoundModified;
+  /// Identifier never reused by another controller, matches the controller in the snapshots.
+  unsigned long long m_snapshotId;
 
   void GetWorldOrientation(btMatrix3x3 &mat);
 
+  /// Register the compound shape to be updated before the next physics step.
+  void SetCompoundModified();
+  /// Recompute the bounds and inertia of the compound shape and its broadphase pairs.
+  void UpdateCompound();
+
   void CreateRigidbody();
   bool CreateSoftbody();
   bool CreateCharacterController();
@@ -632,6 +659,11 @@ class CcdPhysicsController : public PHY_IPhysicsController {
     return m_cci;
   }
 
+  unsigned long long GetSnapshotId() const
+  {
+    return m_snapshotId;
+  }
+
   btRigidBody *GetRigidBody();
   const btRigidBody *GetRigidBody() const;
   btCollisionObject *GetCollisionObject();
@@ -656,6 +688,11 @@ class CcdPhysicsController : public PHY_IPhysicsController {
    * binding')
    */
   virtual bool SynchronizeMotionStates(float time);
+  /** Synchronize the motion state only if the object can have moved since the last
+   * synchronization: the object is active for Bullet or its transform was set.
+   * \return True if the motion state was synchronized.
+   */
+  bool SynchronizeModifiedMotionState(float time);
 
   /**
    * Called for every physics simulation step. Use this method for
@@ -24,6 +24,9 @@
 #include "CcdGraphicController.h"
 #include "CcdConstraint.h"
 #include "CcdMathUtils.h"
+#include "CcdParallelCollisionDispatcher.h"
+#include "CcdParallelDynamicsWorld.h"
+#include "CcdShapeCache.h"
 
 #include <algorithm>
 #include "btBulletDynamicsCommon.h"
@@ -55,6 +58,11 @@
 
 extern "C" {
 #include "BLI_utildefines.h"
+#include "BLI_task.h"
+#include "BLI_threads.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BKE_appdir.h"
 #include "BKE_object.h"
 }
 
@@ -69,6 +77,8 @@ static btRaycastVehicle::btVehicleTuning gTuning;
 #include "LinearMath/btAabbUtil2.h"
 #include "MT_MinMax.h"
 
+#include "CM_Profiler.h"
+
 #ifdef WIN32
 void DrawRasterizerLine(const float *from, const float *to, int color);
 #endif
@@ -389,6 +399,8 @@ void CcdPhysicsEnvironment::SetDebugDrawer(btIDebugDraw *debugDrawer)
 }
 
 CcdPhysicsEnvironment::CcdPhysicsEnvironment(bool useDbvtCulling,
+                                             bool parallel,
+                                             int numThreads,
                                              btDispatcher *dispatcher,
                                              btOverlappingPairCache *pairCache)
     : m_cullingCache(nullptr),
@@ -401,22 +413,52 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(bool useDbvtCulling,
       m_linearDeactivationThreshold(0.8f),
       m_angularDeactivationThreshold(1.0f),
       m_contactBreakingThreshold(0.02f),
+      m_controllerArraysModified(false),
+      m_numCollData(0),
       m_solver(nullptr),
       m_ownPairCache(nullptr),
       m_filterCallback(nullptr),
       m_ghostPairCallback(nullptr),
-      m_ownDispatcher(nullptr)
+      m_ownDispatcher(nullptr),
+      m_ownScheduler(nullptr),
+      m_shapeCache(nullptr)
 {
   for (int i = 0; i < PHY_NUM_RESPONSE; i++) {
     m_triggerCallbacks[i] = nullptr;
   }
 
+  TaskScheduler *scheduler = nullptr;
+  if (parallel) {
+    if (numThreads > 0) {
+      m_ownScheduler = BLI_task_scheduler_create(numThreads);
+      scheduler = m_ownScheduler;
+    }
+    else {
+      scheduler = KX_GetActiveEngine()->GetParallelScheduler();
+    }
+  }
+
+  btDefaultCollisionConstructionInfo constructionInfo;
+  if (parallel) {
+    // Pool the convex algorithms of the parallel dispatcher.
+    constructionInfo.m_customCollisionAlgorithmMaxElementSize =
+        CcdParallelCollisionDispatcher::GetCollisionAlgorithmMaxElementSize();
+  }
   //	m_collisionConfiguration = new btDefaultCollisionConfiguration();
-  m_collisionConfiguration = new btSoftBodyRigidBodyCollisionConfiguration();
+  m_collisionConfiguration = new btSoftBodyRigidBodyCollisionConfiguration(constructionInfo);
   // m_collisionConfiguration->setConvexConvexMultipointIterations();
 
   if (!dispatcher) {
-    btCollisionDispatcher *disp = new btCollisionDispatcher(m_collisionConfiguration);
+    btCollisionDispatcher *disp;
+    if (parallel) {
+      CcdParallelCollisionDispatcher *parallelDisp = new CcdParallelCollisionDispatcher(
+          m_collisionConfiguration);
+      parallelDisp->SetTaskScheduler(scheduler);
+      disp = parallelDisp;
+    }
+    else {
+      disp = new btCollisionDispatcher(m_collisionConfiguration);
+    }
     dispatcher = disp;
     btGImpactCollisionAlgorithm::registerAlgorithm(disp);
     m_ownDispatcher = dispatcher;
@@ -439,8 +481,16 @@ CcdPhysicsEnvironment::CcdPhysicsEnvironment(bool useDbvtCulling,
   SetSolverType(1);  // issues with quickstep and memory allocations
   //	m_dynamicsWorld = new
   // btDiscreteDynamicsWorld(dispatcher,m_broadphase,m_solver,m_collisionConfiguration);
-  m_dynamicsWorld = new btSoftRigidDynamicsWorld(
-      dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+  if (parallel) {
+    CcdParallelDynamicsWorld *parallelWorld = new CcdParallelDynamicsWorld(
+        dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+    parallelWorld->SetTaskScheduler(scheduler);
+    m_dynamicsWorld = parallelWorld;
+  }
+  else {
+    m_dynamicsWorld = new btSoftRigidDynamicsWorld(
+        dispatcher, m_broadphase, m_solver, m_collisionConfiguration);
+  }
   m_dynamicsWorld->setInternalTickCallback(&CcdPhysicsEnvironment::StaticSimulationSubtickCallback,
                                            this);
   // m_dynamicsWorld->getSolverInfo().m_linearSlop = 0.01f;
@@ -457,6 +507,9 @@ void CcdPhysicsEnvironment::AddCcdPhysicsController(CcdPhysicsController *ctrl)
   if (!m_controllers.insert(ctrl).second) {
     return;
   }
+  m_controllerArraysModified = true;
+  // The object could have moved while it was not in the environment.
+  ctrl->m_motionStateModified = true;
 
   btRigidBody *body = ctrl->GetRigidBody();
   btCollisionObject *obj = ctrl->GetCollisionObject();
@@ -579,8 +632,11 @@ bool CcdPhysicsEnvironment::RemoveCcdPhysicsController(CcdPhysicsController *ctr
 {
   // if the physics controller is already removed we do nothing
   if (!m_controllers.erase(ctrl)) {
+    // The proximity sensors are not part of the world.
+    RemoveProximitySensor(ctrl);
     return false;
   }
+  m_controllerArraysModified = true;
 
   // also remove constraint
   btRigidBody *body = ctrl->GetRigidBody();
@@ -669,6 +725,28 @@ void CcdPhysicsEnvironment::RefreshCcdPhysicsController(CcdPhysicsController *ct
   }
 }
 
+void CcdPhysicsEnvironment::AddModifiedCompound(CcdPhysicsController *ctrl)
+{
+  m_modifiedCompounds.push_back(ctrl);
+}
+
+void CcdPhysicsEnvironment::RemoveModifiedCompound(CcdPhysicsController *ctrl)
+{
+  std::vector<CcdPhysicsController *>::iterator it = std::find(
+      m_modifiedCompounds.begin(), m_modifiedCompounds.end(), ctrl);
+  if (it != m_modifiedCompounds.end()) {
+    m_modifiedCompounds.erase(it);
+  }
+}
+
+void CcdPhysicsEnvironment::UpdateModifiedCompounds()
+{
+  for (CcdPhysicsController *ctrl : m_modifiedCompounds) {
+    ctrl->UpdateCompound();
+  }
+  m_modifiedCompounds.clear();
+}
+
 bool CcdPhysicsEnvironment::IsActiveCcdPhysicsController(CcdPhysicsController *ctrl)
 {
   return (m_controllers.find(ctrl) != m_controllers.end());
@@ -741,25 +819,121 @@ void CcdPhysicsEnvironment::StaticSimulationSubtickCallback(btDynamicsWorld *wor
 
 void CcdPhysicsEnvironment::SimulationSubtickCallback(btScalar timeStep)
 {
-  std::set<CcdPhysicsController *>::iterator it;
+  // Only the rigid bodies have their velocity clamped.
+  for (CcdPhysicsController *ctrl : m_rigidBodyControllers) {
+    ctrl->SimulationTick(timeStep);
+  }
+}
+
+void CcdPhysicsEnvironment::UpdateControllerArrays()
+{
+  if (!m_controllerArraysModified) {
+    return;
+  }
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SimulationTick(timeStep);
+  m_rigidBodyControllers.clear();
+  m_softBodyControllers.clear();
+  m_collisionObjectControllers.clear();
+  m_fhSpringControllers.clear();
+
+  for (CcdPhysicsController *ctrl : m_controllers) {
+    if (ctrl->GetRigidBody()) {
+      m_rigidBodyControllers.push_back(ctrl);
+
+      const CcdConstructionInfo &info = ctrl->GetConstructionInfo();
+      if (info.m_do_fh || info.m_do_rot_fh) {
+        m_fhSpringControllers.push_back(ctrl);
+      }
+    }
+    else if (ctrl->GetSoftBody()) {
+      m_softBodyControllers.push_back(ctrl);
+    }
+    else {
+      m_collisionObjectControllers.push_back(ctrl);
+    }
   }
+
+  m_controllerArraysModified = false;
+}
+
+/// Number of controllers under which the motion states are synchronized in a single thread.
+#define SYNCHRONIZE_MOTION_STATES_PARALLEL_THRESHOLD 512
+/// Number of controllers synchronized per task.
+#define SYNCHRONIZE_MOTION_STATES_CHUNK_SIZE 256
+
+struct SynchronizeMotionStatesChunk {
+  CcdPhysicsController **m_begin;
+  CcdPhysicsController **m_end;
+  float m_timeStep;
+};
+
+static void synchronize_motion_states_thread_func(TaskPool *UNUSED(pool),
+                                                  void *taskdata,
+                                                  int UNUSED(threadid))
+{
+  const SynchronizeMotionStatesChunk *chunk = (SynchronizeMotionStatesChunk *)taskdata;
+  for (CcdPhysicsController **it = chunk->m_begin; it != chunk->m_end; ++it) {
+    (*it)->SynchronizeModifiedMotionState(chunk->m_timeStep);
+  }
+}
+
+void CcdPhysicsEnvironment::SynchronizeMotionStates(float timeStep)
+{
+  // Soft bodies are deformed each step and are always synchronized.
+  for (CcdPhysicsController *ctrl : m_softBodyControllers) {
+    ctrl->SynchronizeMotionStates(timeStep);
+  }
+
+  for (CcdPhysicsController *ctrl : m_collisionObjectControllers) {
+    ctrl->SynchronizeModifiedMotionState(timeStep);
+  }
+
+  const unsigned int numBodies = m_rigidBodyControllers.size();
+  // Don't start the parallel scheduler for a few bodies.
+  TaskScheduler *scheduler = (numBodies < SYNCHRONIZE_MOTION_STATES_PARALLEL_THRESHOLD) ?
+                                 nullptr :
+                                 KX_GetActiveEngine()->GetParallelScheduler();
+  if (!scheduler || BLI_task_scheduler_num_threads(scheduler) < 2) {
+    for (CcdPhysicsController *ctrl : m_rigidBodyControllers) {
+      ctrl->SynchronizeModifiedMotionState(timeStep);
+    }
+    return;
+  }
+
+  /* The motion states are independent, the scheduling of the modified scene graph nodes is
+   * already protected for the parallel scene graph update. */
+  CcdPhysicsController **controllers = m_rigidBodyControllers.data();
+  std::vector<SynchronizeMotionStatesChunk> chunks;
+  chunks.reserve(numBodies / SYNCHRONIZE_MOTION_STATES_CHUNK_SIZE + 1);
+  for (unsigned int i = 0; i < numBodies; i += SYNCHRONIZE_MOTION_STATES_CHUNK_SIZE) {
+    const unsigned int end = std::min(i + SYNCHRONIZE_MOTION_STATES_CHUNK_SIZE, numBodies);
+    chunks.push_back({controllers + i, controllers + end, timeStep});
+  }
+
+  TaskPool *pool = BLI_task_pool_create(scheduler, nullptr);
+  for (SynchronizeMotionStatesChunk &chunk : chunks) {
+    BLI_task_pool_push(
+        pool, synchronize_motion_states_thread_func, &chunk, false, TASK_PRIORITY_HIGH);
+  }
+  BLI_task_pool_work_and_wait(pool);
+  BLI_task_pool_free(pool);
 }
 
 bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, float interval)
 {
-  std::set<CcdPhysicsController *>::iterator it;
+  CM_ProfileScope profileScope("physics", "ProceedDeltaTime");
+
   int i;
 
   // Update Bullet global variables.
   gDeactivationTime = m_deactivationTime;
   gContactBreakingThreshold = m_contactBreakingThreshold;
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
-  }
+  UpdateControllerArrays();
+
+  UpdateModifiedCompounds();
+
+  SynchronizeMotionStates(timeStep);
 
   float subStep = timeStep / float(m_numTimeSubSteps);
   i = m_dynamicsWorld->stepSimulation(
@@ -769,14 +943,7 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
 
   ProcessFhSprings(curTime, i * subStep);
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    (*it)->SynchronizeMotionStates(timeStep);
-  }
-
-  // for (it=m_controllers.begin(); it!=m_controllers.end(); it++)
-  //{
-  //	(*it)->SynchronizeMotionStates(timeStep);
-  //}
+  SynchronizeMotionStates(timeStep);
 
   for (i = 0; i < m_wrapperVehicles.size(); i++) {
     WrapperVehicle *veh = m_wrapperVehicles[i];
@@ -785,9 +952,23 @@ bool CcdPhysicsEnvironment::ProceedDeltaTime(double curTime, float timeStep, flo
 
   CallbackTriggers();
 
+  ProcessProximitySensors();
+
   return true;
 }
 
+bool CcdPhysicsEnvironment::CanProceedConcurrently(PHY_IPhysicsEnvironment *other) const
+{
+  const CcdPhysicsEnvironment *env = dynamic_cast<CcdPhysicsEnvironment *>(other);
+  // Other physics environments don't use the Bullet globals.
+  if (!env) {
+    return true;
+  }
+
+  return (m_deactivationTime == env->m_deactivationTime &&
+          m_contactBreakingThreshold == env->m_contactBreakingThreshold);
+}
+
 class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultCallback {
   btCollisionObject *m_owner;
   btCollisionObject *m_parent;
@@ -818,126 +999,121 @@ class ClosestRayResultCallbackNotMe : public btCollisionWorld::ClosestRayResultC
 
 void CcdPhysicsEnvironment::ProcessFhSprings(double curTime, float interval)
 {
-  std::set<CcdPhysicsController *>::iterator it;
-
   const float step = interval * KX_GetActiveEngine()->GetTicRate();
 
-  for (it = m_controllers.begin(); it != m_controllers.end(); it++) {
-    CcdPhysicsController *ctrl = (*it);
+  for (CcdPhysicsController *ctrl : m_fhSpringControllers) {
     btRigidBody *body = ctrl->GetRigidBody();
 
-    if (body && (ctrl->GetConstructionInfo().m_do_fh || ctrl->GetConstructionInfo().m_do_rot_fh)) {
-      // re-implement SM_FhObject.cpp using btCollisionWorld::rayTest and info from
-      // ctrl->getConstructionInfo() send a ray from {0.0, 0.0, 0.0} towards {0.0, 0.0, -10.0}, in
-      // local coordinates
-      CcdPhysicsController *parentCtrl = ctrl->GetParentCtrl();
-      btRigidBody *parentBody = parentCtrl ? parentCtrl->GetRigidBody() : nullptr;
-      btRigidBody *cl_object = parentBody ? parentBody : body;
+    // re-implement SM_FhObject.cpp using btCollisionWorld::rayTest and info from
+    // ctrl->getConstructionInfo() send a ray from {0.0, 0.0, 0.0} towards {0.0, 0.0, -10.0}, in
+    // local coordinates
+    CcdPhysicsController *parentCtrl = ctrl->GetParentCtrl();
+    btRigidBody *parentBody = parentCtrl ? parentCtrl->GetRigidBody() : nullptr;
+    btRigidBody *cl_object = parentBody ? parentBody : body;
 
-      if (body->isStaticOrKinematicObject())
-        continue;
+    if (body->isStaticOrKinematicObject())
+      continue;
 
-      btVector3 rayDirLocal(0.0f, 0.0f, -10.0f);
+    btVector3 rayDirLocal(0.0f, 0.0f, -10.0f);
 
-      // m_dynamicsWorld
-      // ctrl->GetRigidBody();
-      btVector3 rayFromWorld = body->getCenterOfMassPosition();
-      // btVector3	rayToWorld = rayFromWorld + body->getCenterOfMassTransform().getBasis() *
-      // rayDirLocal; ray always points down the z axis in world space...
-      btVector3 rayToWorld = rayFromWorld + rayDirLocal;
+    // m_dynamicsWorld
+    // ctrl->GetRigidBody();
+    btVector3 rayFromWorld = body->getCenterOfMassPosition();
+    // btVector3	rayToWorld = rayFromWorld + body->getCenterOfMassTransform().getBasis() *
+    // rayDirLocal; ray always points down the z axis in world space...
+    btVector3 rayToWorld = rayFromWorld + rayDirLocal;
 
-      ClosestRayResultCallbackNotMe resultCallback(rayFromWorld, rayToWorld, body, parentBody);
+    ClosestRayResultCallbackNotMe resultCallback(rayFromWorld, rayToWorld, body, parentBody);
 
-      m_dynamicsWorld->rayTest(rayFromWorld, rayToWorld, resultCallback);
-      if (resultCallback.hasHit()) {
-        // we hit this one: resultCallback.m_collisionObject;
-        CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
-            resultCallback.m_collisionObject->getUserPointer());
+    m_dynamicsWorld->rayTest(rayFromWorld, rayToWorld, resultCallback);
+    if (resultCallback.hasHit()) {
+      // we hit this one: resultCallback.m_collisionObject;
+      CcdPhysicsController *controller = static_cast<CcdPhysicsController *>(
+          resultCallback.m_collisionObject->getUserPointer());
 
-        if (controller) {
-          if (controller->GetConstructionInfo().m_fh_distance < SIMD_EPSILON)
-            continue;
+      if (controller) {
+        if (controller->GetConstructionInfo().m_fh_distance < SIMD_EPSILON)
+          continue;
 
-          btRigidBody *hit_object = controller->GetRigidBody();
-          if (!hit_object)
-            continue;
+        btRigidBody *hit_object = controller->GetRigidBody();
+        if (!hit_object)
+          continue;
 
-          CcdConstructionInfo &hitObjShapeProps = controller->GetConstructionInfo();
+        CcdConstructionInfo &hitObjShapeProps = controller->GetConstructionInfo();
 
-          float distance = resultCallback.m_closestHitFraction * rayDirLocal.length() -
-                           ctrl->GetConstructionInfo().m_radius;
-          if (distance >= hitObjShapeProps.m_fh_distance)
-            continue;
+        float distance = resultCallback.m_closestHitFraction * rayDirLocal.length() -
+                         ctrl->GetConstructionInfo().m_radius;
+        if (distance >= hitObjShapeProps.m_fh_distance)
+          continue;
 
-          // btVector3 ray_dir = cl_object->getCenterOfMassTransform().getBasis()*
-          // rayDirLocal.normalized();
-          btVector3 ray_dir = rayDirLocal.normalized();
-          btVector3 normal = resultCallback.m_hitNormalWorld;
-          normal.normalize();
+        // btVector3 ray_dir = cl_object->getCenterOfMassTransform().getBasis()*
+        // rayDirLocal.normalized();
+        btVector3 ray_dir = rayDirLocal.normalized();
+        btVector3 normal = resultCallback.m_hitNormalWorld;
+        normal.normalize();
 
-          if (ctrl->GetConstructionInfo().m_do_fh) {
-            btVector3 lspot = cl_object->getCenterOfMassPosition() +
-                              rayDirLocal * resultCallback.m_closestHitFraction;
+        if (ctrl->GetConstructionInfo().m_do_fh) {
+          btVector3 lspot = cl_object->getCenterOfMassPosition() +
+                            rayDirLocal * resultCallback.m_closestHitFraction;
 
-            lspot -= hit_object->getCenterOfMassPosition();
-            btVector3 rel_vel = cl_object->getLinearVelocity() -
-                                hit_object->getVelocityInLocalPoint(lspot);
-            btScalar rel_vel_ray = ray_dir.dot(rel_vel);
-            btScalar spring_extent = 1.0f - distance / hitObjShapeProps.m_fh_distance;
+          lspot -= hit_object->getCenterOfMassPosition();
+          btVector3 rel_vel = cl_object->getLinearVelocity() -
+                              hit_object->getVelocityInLocalPoint(lspot);
+          btScalar rel_vel_ray = ray_dir.dot(rel_vel);
+          btScalar spring_extent = 1.0f - distance / hitObjShapeProps.m_fh_distance;
 
-            btScalar i_spring = spring_extent * hitObjShapeProps.m_fh_spring;
-            btScalar i_damp = rel_vel_ray * hitObjShapeProps.m_fh_damping;
+          btScalar i_spring = spring_extent * hitObjShapeProps.m_fh_spring;
+          btScalar i_damp = rel_vel_ray * hitObjShapeProps.m_fh_damping;
 
+          cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
+                                       (-(i_spring + i_damp) * ray_dir) * step);
+          if (hitObjShapeProps.m_fh_normal) {
             cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
-                                         (-(i_spring + i_damp) * ray_dir) * step);
-            if (hitObjShapeProps.m_fh_normal) {
-              cl_object->setLinearVelocity(cl_object->getLinearVelocity() +
-                                           (i_spring + i_damp) *
-                                               (normal - normal.dot(ray_dir) * ray_dir) * step);
-            }
+                                         (i_spring + i_damp) *
+                                             (normal - normal.dot(ray_dir) * ray_dir) * step);
+          }
 
-            btVector3 lateral = rel_vel - rel_vel_ray * ray_dir;
+          btVector3 lateral = rel_vel - rel_vel_ray * ray_dir;
 
-            if (ctrl->GetConstructionInfo().m_do_anisotropic) {
-              // Bullet basis contains no scaling/shear etc.
-              const btMatrix3x3 &lcs = cl_object->getCenterOfMassTransform().getBasis();
-              btVector3 loc_lateral = lateral * lcs;
-              const btVector3 &friction_scaling = cl_object->getAnisotropicFriction();
-              loc_lateral *= friction_scaling;
-              lateral = lcs * loc_lateral;
-            }
+          if (ctrl->GetConstructionInfo().m_do_anisotropic) {
+            // Bullet basis contains no scaling/shear etc.
+            const btMatrix3x3 &lcs = cl_object->getCenterOfMassTransform().getBasis();
+            btVector3 loc_lateral = lateral * lcs;
+            const btVector3 &friction_scaling = cl_object->getAnisotropicFriction();
+            loc_lateral *= friction_scaling;
+            lateral = lcs * loc_lateral;
+          }
 
-            btScalar rel_vel_lateral = lateral.length();
+          btScalar rel_vel_lateral = lateral.length();
 
-            if (rel_vel_lateral > SIMD_EPSILON) {
-              btScalar friction_factor = hit_object->getFriction();  // cl_object->getFriction();
+          if (rel_vel_lateral > SIMD_EPSILON) {
+            btScalar friction_factor = hit_object->getFriction();  // cl_object->getFriction();
 
-              btScalar max_friction = friction_factor * btMax(btScalar(0.0), i_spring);
+            btScalar max_friction = friction_factor * btMax(btScalar(0.0), i_spring);
 
-              btScalar rel_mom_lateral = rel_vel_lateral / cl_object->getInvMass();
+            btScalar rel_mom_lateral = rel_vel_lateral / cl_object->getInvMass();
 
-              btVector3 friction = (rel_mom_lateral > max_friction) ?
-                                       -lateral * (max_friction / rel_vel_lateral) :
-                                       -lateral;
+            btVector3 friction = (rel_mom_lateral > max_friction) ?
+                                     -lateral * (max_friction / rel_vel_lateral) :
+                                     -lateral;
 
-              cl_object->applyCentralImpulse(friction * step);
-            }
+            cl_object->applyCentralImpulse(friction * step);
           }
+        }
 
-          if (ctrl->GetConstructionInfo().m_do_rot_fh) {
-            btVector3 up2 = cl_object->getWorldTransform().getBasis().getColumn(2);
+        if (ctrl->GetConstructionInfo().m_do_rot_fh) {
+          btVector3 up2 = cl_object->getWorldTransform().getBasis().getColumn(2);
 
-            btVector3 t_spring = up2.cross(normal) * hitObjShapeProps.m_fh_spring;
-            btVector3 ang_vel = cl_object->getAngularVelocity();
+          btVector3 t_spring = up2.cross(normal) * hitObjShapeProps.m_fh_spring;
+          btVector3 ang_vel = cl_object->getAngularVelocity();
 
-            // only rotations that tilt relative to the normal are damped
-            ang_vel -= ang_vel.dot(normal) * normal;
+          // only rotations that tilt relative to the normal are damped
+          ang_vel -= ang_vel.dot(normal) * normal;
 
-            btVector3 t_damp = ang_vel * hitObjShapeProps.m_fh_damping;
+          btVector3 t_damp = ang_vel * hitObjShapeProps.m_fh_damping;
 
-            cl_object->setAngularVelocity(cl_object->getAngularVelocity() +
-                                          (t_spring - t_damp) * step);
-          }
+          cl_object->setAngularVelocity(cl_object->getAngularVelocity() +
+                                        (t_spring - t_damp) * step);
         }
       }
     }
@@ -1340,6 +1516,221 @@ PHY_IPhysicsController *CcdPhysicsEnvironment::RayTest(PHY_IRayCastFilterCallbac
   return result.m_controller;
 }
 
+/// Number of casts under which a batch is computed in a single thread.
+#define CAST_BATCH_PARALLEL_THRESHOLD 64
+/// Number of casts computed per task.
+#define CAST_BATCH_CHUNK_SIZE 32
+
+/** Data shared by the casts of a batch. The broadphase trees are traversed with the re-entrant
+ * btDbvt queries, the queries of the world use a persistent stack per tree. */
+struct CastBatch {
+  btDbvtBroadphase *m_broadphase;
+  const std::vector<PHY_CastQuery> *m_queries;
+  std::vector<PHY_CastResult> *m_results;
+  /// Sphere swept by the casts, nullptr for rays.
+  const btSphereShape *m_sphere;
+  const PHY_ICastFilter *m_filter;
+  /// Lock of the GImpact shapes which are modified by the queries.
+  SpinLock m_lock;
+};
+
+/// Test a cast against the objects of the overlapped broadphase leaves.
+struct CastBatchLeafTester : public btDbvt::ICollide {
+  CastBatch &m_batch;
+  const PHY_CastQuery &m_query;
+  btTransform m_from;
+  btTransform m_to;
+  btCollisionWorld::ClosestRayResultCallback m_rayCallback;
+  btCollisionWorld::ClosestConvexResultCallback m_sweepCallback;
+
+  CastBatchLeafTester(CastBatch &batch,
+                      const PHY_CastQuery &query,
+                      const btVector3 &from,
+                      const btVector3 &to)
+      : m_batch(batch),
+        m_query(query),
+        m_from(btMatrix3x3::getIdentity(), from),
+        m_to(btMatrix3x3::getIdentity(), to),
+        m_rayCallback(from, to),
+        m_sweepCallback(from, to)
+  {
+    // Same as the single ray test.
+    m_rayCallback.m_flags |= btTriangleRaycastCallback::kF_UseSubSimplexConvexCastRaytest;
+  }
+
+  bool NeedCast(const btCollisionObject *object) const
+  {
+    // Don't collide with sensor objects as the single ray test.
+    const btBroadphaseProxy *proxy = object->getBroadphaseHandle();
+    if (!(proxy->m_collisionFilterGroup &
+          (CcdConstructionInfo::AllFilter ^ CcdConstructionInfo::SensorFilter)) ||
+        !(proxy->m_collisionFilterMask & CcdConstructionInfo::DefaultFilter)) {
+      return false;
+    }
+
+    CcdPhysicsController *ctrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+    if (!ctrl || ctrl == m_query.m_ignoreController) {
+      return false;
+    }
+
+    return (!m_batch.m_filter || m_batch.m_filter->NeedCast(ctrl));
+  }
+
+  virtual void Process(const btDbvtNode *leaf)
+  {
+    btCollisionObject *object = (btCollisionObject *)((btDbvtProxy *)leaf->data)->m_clientObject;
+    if (!NeedCast(object)) {
+      return;
+    }
+
+    const btCollisionShape *shape = object->getCollisionShape();
+    const bool lock = (shape->getShapeType() == GIMPACT_SHAPE_PROXYTYPE);
+    if (lock) {
+      BLI_spin_lock(&m_batch.m_lock);
+    }
+
+    if (m_batch.m_sphere) {
+      btCollisionWorld::objectQuerySingle(m_batch.m_sphere,
+                                          m_from,
+                                          m_to,
+                                          object,
+                                          shape,
+                                          object->getWorldTransform(),
+                                          m_sweepCallback,
+                                          0.0f);
+    }
+    else {
+      btSoftRigidDynamicsWorld::rayTestSingle(
+          m_from, m_to, object, shape, object->getWorldTransform(), m_rayCallback);
+    }
+
+    if (lock) {
+      BLI_spin_unlock(&m_batch.m_lock);
+    }
+  }
+};
+
+static void cast_batch_query(CastBatch &batch, unsigned int index)
+{
+  const PHY_CastQuery &query = (*batch.m_queries)[index];
+  const btVector3 from = ToBullet(query.m_from);
+  const btVector3 to = ToBullet(query.m_to);
+
+  CastBatchLeafTester tester(batch, query, from, to);
+  if (batch.m_sphere) {
+    // Bounding box of the swept sphere.
+    const btScalar radius = batch.m_sphere->getRadius();
+    btVector3 aabbMin = from;
+    btVector3 aabbMax = from;
+    aabbMin.setMin(to);
+    aabbMax.setMax(to);
+    const btVector3 extent(radius, radius, radius);
+    const btDbvtVolume volume = btDbvtVolume::FromMM(aabbMin - extent, aabbMax + extent);
+    for (btDbvt &tree : batch.m_broadphase->m_sets) {
+      tree.collideTV(tree.m_root, volume, tester);
+    }
+  }
+  else {
+    for (btDbvt &tree : batch.m_broadphase->m_sets) {
+      btDbvt::rayTest(tree.m_root, from, to, tester);
+    }
+  }
+
+  const btCollisionObject *hitObject;
+  btVector3 hitPoint;
+  btVector3 hitNormal;
+  float hitFraction;
+  if (batch.m_sphere) {
+    hitObject = tester.m_sweepCallback.m_hitCollisionObject;
+    hitPoint = tester.m_sweepCallback.m_hitPointWorld;
+    hitNormal = tester.m_sweepCallback.m_hitNormalWorld;
+    hitFraction = tester.m_sweepCallback.m_closestHitFraction;
+  }
+  else {
+    hitObject = tester.m_rayCallback.m_collisionObject;
+    hitPoint = tester.m_rayCallback.m_hitPointWorld;
+    hitNormal = tester.m_rayCallback.m_hitNormalWorld;
+    hitFraction = tester.m_rayCallback.m_closestHitFraction;
+  }
+
+  PHY_CastResult &result = (*batch.m_results)[index];
+  if (!hitObject) {
+    result.m_controller = nullptr;
+    result.m_hitFraction = 1.0f;
+    return;
+  }
+
+  if (hitNormal.length2() > (SIMD_EPSILON * SIMD_EPSILON)) {
+    hitNormal.normalize();
+  }
+  else {
+    hitNormal.setValue(1.0f, 0.0f, 0.0f);
+  }
+
+  result.m_controller = static_cast<CcdPhysicsController *>(hitObject->getUserPointer());
+  result.m_hitPoint = ToMoto(hitPoint);
+  result.m_hitNormal = ToMoto(hitNormal);
+  result.m_hitFraction = hitFraction;
+}
+
+struct CastBatchChunk {
+  CastBatch *m_batch;
+  unsigned int m_begin;
+  unsigned int m_end;
+};
+
+static void cast_batch_thread_func(TaskPool *UNUSED(pool), void *taskdata, int UNUSED(threadid))
+{
+  const CastBatchChunk *chunk = (CastBatchChunk *)taskdata;
+  for (unsigned int i = chunk->m_begin; i < chunk->m_end; ++i) {
+    cast_batch_query(*chunk->m_batch, i);
+  }
+}
+
+void CcdPhysicsEnvironment::CastTestBatch(const std::vector<PHY_CastQuery> &queries,
+                                          float radius,
+                                          const PHY_ICastFilter *filter,
+                                          std::vector<PHY_CastResult> &results)
+{
+  const unsigned int numQueries = queries.size();
+  results.resize(numQueries);
+
+  btSphereShape sphere(radius);
+
+  CastBatch batch;
+  batch.m_broadphase = static_cast<btDbvtBroadphase *>(m_broadphase);
+  batch.m_queries = &queries;
+  batch.m_results = &results;
+  batch.m_sphere = (radius > 0.0f) ? &sphere : nullptr;
+  batch.m_filter = filter;
+  BLI_spin_init(&batch.m_lock);
+
+  TaskScheduler *scheduler = (numQueries < CAST_BATCH_PARALLEL_THRESHOLD) ?
+                                 nullptr :
+                                 KX_GetActiveEngine()->GetParallelScheduler();
+  if (!scheduler || BLI_task_scheduler_num_threads(scheduler) < 2) {
+    for (unsigned int i = 0; i < numQueries; ++i) {
+      cast_batch_query(batch, i);
+    }
+  }
+  else {
+    std::vector<CastBatchChunk> chunks;
+    chunks.reserve(numQueries / CAST_BATCH_CHUNK_SIZE + 1);
+    for (unsigned int i = 0; i < numQueries; i += CAST_BATCH_CHUNK_SIZE) {
+      chunks.push_back({&batch, i, std::min(i + CAST_BATCH_CHUNK_SIZE, numQueries)});
+    }
+
+    TaskPool *pool = BLI_task_pool_create(scheduler, nullptr);
+    for (CastBatchChunk &chunk : chunks) {
+      BLI_task_pool_push(pool, cast_batch_thread_func, &chunk, false, TASK_PRIORITY_HIGH);
+    }
+    BLI_task_pool_work_and_wait(pool);
+    BLI_task_pool_free(pool);
+  }
+
+  BLI_spin_end(&batch.m_lock);
+}
+
 // Handles occlusion culling.
 // The implementation is based on the CDTestFramework
 struct OcclusionBuffer {
@@ -1986,6 +2377,11 @@ btDispatcher *CcdPhysicsEnvironment::GetDispatcher()
   return m_dynamicsWorld->getDispatcher();
 }
 
+CcdShapeCache *CcdPhysicsEnvironment::GetShapeCache() const
+{
+  return m_shapeCache;
+}
+
 void CcdPhysicsEnvironment::MergeEnvironment(PHY_IPhysicsEnvironment *other_env)
 {
   CcdPhysicsEnvironment *other = dynamic_cast<CcdPhysicsEnvironment *>(other_env);
@@ -2003,6 +2399,16 @@ void CcdPhysicsEnvironment::MergeEnvironment(PHY_IPhysicsEnvironment *other_env)
     other->RemoveCcdPhysicsController(ctrl, true);
     this->AddCcdPhysicsController(ctrl);
   }
+
+  m_modifiedCompounds.insert(m_modifiedCompounds.end(),
+                            other->m_modifiedCompounds.begin(),
+                            other->m_modifiedCompounds.end());
+  other->m_modifiedCompounds.clear();
+
+  m_proximitySensors.insert(m_proximitySensors.end(),
+                            other->m_proximitySensors.begin(),
+                            other->m_proximitySensors.end());
+  other->m_proximitySensors.clear();
 }
 
 CcdPhysicsEnvironment::~CcdPhysicsEnvironment()
@@ -2022,6 +2428,13 @@ CcdPhysicsEnvironment::~CcdPhysicsEnvironment()
   if (nullptr != m_ownDispatcher)
     delete m_ownDispatcher;
 
+  // After the world and dispatcher which could still use it.
+  if (m_ownScheduler) {
+    BLI_task_scheduler_free(m_ownScheduler);
+  }
+
+  delete m_shapeCache;
+
   if (nullptr != m_solver)
     delete m_solver;
 
@@ -2034,6 +2447,10 @@ CcdPhysicsEnvironment::~CcdPhysicsEnvironment()
   if (nullptr != m_ghostPairCallback)
     delete m_ghostPairCallback;
 
+  for (CcdCollData *collData : m_collDataPool) {
+    delete collData;
+  }
+
   if (nullptr != m_collisionConfiguration)
     delete m_collisionConfiguration;
 
@@ -2081,6 +2498,28 @@ void CcdPhysicsEnvironment::RemoveSensor(PHY_IPhysicsController *ctrl)
   RemoveCcdPhysicsController((CcdPhysicsController *)ctrl, true);
 }
 
+void CcdPhysicsEnvironment::AddProximitySensor(PHY_IPhysicsController *ctrl)
+{
+  CcdPhysicsController *ccdCtrl = (CcdPhysicsController *)ctrl;
+  if (std::find(m_proximitySensors.begin(), m_proximitySensors.end(), ccdCtrl) !=
+      m_proximitySensors.end()) {
+    return;
+  }
+
+  // The user pointer is used to find the sensor controller in the response callbacks.
+  ccdCtrl->GetCollisionObject()->setUserPointer(ccdCtrl);
+  m_proximitySensors.push_back(ccdCtrl);
+}
+
+void CcdPhysicsEnvironment::RemoveProximitySensor(PHY_IPhysicsController *ctrl)
+{
+  std::vector<CcdPhysicsController *>::iterator it = std::find(
+      m_proximitySensors.begin(), m_proximitySensors.end(), (CcdPhysicsController *)ctrl);
+  if (it != m_proximitySensors.end()) {
+    m_proximitySensors.erase(it);
+  }
+}
+
 void CcdPhysicsEnvironment::AddCollisionCallback(int response_class,
                                                  PHY_ResponseCallback callback,
                                                  void *user)
@@ -2096,6 +2535,8 @@ bool CcdPhysicsEnvironment::RequestCollisionCallback(PHY_IPhysicsController *ctr
 
 void CcdPhysicsEnvironment::CallbackTriggers()
 {
+  CM_ProfileScope profileScope("physics", "CallbackTriggers");
+
   bool draw_contact_points = m_debugDrawer &&
                              (m_debugDrawer->getDebugMode() & btIDebugDraw::DBG_DrawContactPoints);
 
@@ -2139,7 +2580,12 @@ void CcdPhysicsEnvironment::CallbackTriggers()
     }
 
     if (usecallback) {
-      const CcdCollData *coll_data = new CcdCollData(manifold);
+      // Reuse the collision data released by the previous frames.
+      if (m_numCollData == m_collDataPool.size()) {
+        m_collDataPool.push_back(new CcdCollData(manifold));
+      }
+      CcdCollData *coll_data = m_collDataPool[m_numCollData++];
+      coll_data->SetManifold(manifold);
 
       m_triggerCallbacks[PHY_OBJECT_RESPONSE](m_triggerCallbacksUserPtrs[PHY_OBJECT_RESPONSE],
                                               colliding_ctrl0 ? ctrl0 : ctrl1,
@@ -2158,6 +2604,132 @@ void CcdPhysicsEnvironment::CallbackTriggers()
   }
 }
 
+void CcdPhysicsEnvironment::ReleaseCollisionData()
+{
+  m_numCollData = 0;
+}
+
+/// Collect the broadphase proxies overlapping a box.
+class CcdProximityAabbCallback : public btBroadphaseAabbCallback {
+ private:
+  std::vector<btBroadphaseProxy *> &m_proxies;
+
+ public:
+  CcdProximityAabbCallback(std::vector<btBroadphaseProxy *> &proxies) : m_proxies(proxies)
+  {
+  }
+
+  virtual bool process(const btBroadphaseProxy *proxy)
+  {
+    m_proxies.push_back(const_cast<btBroadphaseProxy *>(proxy));
+    return true;
+  }
+};
+
+/// Detect a contact point as close as the persistent manifolds keep them.
+class CcdProximityContactCallback : public btCollisionWorld::ContactResultCallback {
+ private:
+  btScalar m_threshold;
+
+ public:
+  bool m_hit;
+
+  CcdProximityContactCallback(btScalar threshold) : m_threshold(threshold), m_hit(false)
+  {
+  }
+
+  virtual btScalar addSingleResult(btManifoldPoint &cp,
+                                   const btCollisionObjectWrapper *UNUSED(colObj0Wrap),
+                                   int UNUSED(partId0),
+                                   int UNUSED(index0),
+                                   const btCollisionObjectWrapper *UNUSED(colObj1Wrap),
+                                   int UNUSED(partId1),
+                                   int UNUSED(index1))
+  {
+    if (cp.getDistance() <= m_threshold) {
+      m_hit = true;
+    }
+    return 0.0f;
+  }
+};
+
+void CcdPhysicsEnvironment::ProcessProximitySensors()
+{
+  if (m_proximitySensors.empty() || !m_triggerCallbacks[PHY_PROXIMITY_RESPONSE]) {
+    return;
+  }
+
+  CM_ProfileScope profileScope("physics", "ProcessProximitySensors");
+
+  btDispatcher *dispatcher = m_dynamicsWorld->getDispatcher();
+  const bool drawShapes = m_debugDrawer &&
+                          (m_debugDrawer->getDebugMode() & btIDebugDraw::DBG_DrawWireframe);
+  const btVector3 margin(
+      gContactBreakingThreshold, gContactBreakingThreshold, gContactBreakingThreshold);
+
+  for (CcdPhysicsController *sensorCtrl : m_proximitySensors) {
+    btCollisionObject *sensorObj = sensorCtrl->GetCollisionObject();
+    btCollisionShape *sensorShape = sensorObj->getCollisionShape();
+    const btTransform &sensorTrans = sensorObj->getWorldTransform();
+    KX_GameObject *sensorGameObj = KX_GameObject::GetClientObject(
+        (KX_ClientObjectInfo *)sensorCtrl->GetNewClientInfo());
+
+    if (drawShapes) {
+      m_dynamicsWorld->debugDrawObject(sensorTrans, sensorShape, btVector3(1.0f, 1.0f, 0.0f));
+    }
+
+    btVector3 aabbMin, aabbMax;
+    sensorShape->getAabb(sensorTrans, aabbMin, aabbMax);
+
+    m_proximityProxies.clear();
+    CcdProximityAabbCallback aabbCallback(m_proximityProxies);
+    m_broadphase->aabbTest(aabbMin - margin, aabbMax + margin, aabbCallback);
+
+    for (btBroadphaseProxy *proxy : m_proximityProxies) {
+      btCollisionObject *colObj = (btCollisionObject *)proxy->m_clientObject;
+      CcdPhysicsController *objCtrl = (CcdPhysicsController *)colObj->getUserPointer();
+      // Soft bodies never produced manifold contacts with the sensors.
+      if (!objCtrl || colObj->getInternalType() == btCollisionObject::CO_SOFT_BODY) {
+        continue;
+      }
+
+      // Same filtering as the pairs of the world in CcdOverlapFilterCallBack.
+      if (!(sensorCtrl->GetCollisionFilterGroup() & proxy->m_collisionFilterMask) ||
+          !(proxy->m_collisionFilterGroup & sensorCtrl->GetCollisionFilterMask())) {
+        continue;
+      }
+
+      KX_GameObject *gameobj = KX_GameObject::GetClientObject(
+          (KX_ClientObjectInfo *)objCtrl->GetNewClientInfo());
+      if (sensorGameObj && gameobj &&
+          (!sensorGameObj->CheckCollision(gameobj) || !gameobj->CheckCollision(sensorGameObj))) {
+        continue;
+      }
+
+      if (m_triggerCallbacks[PHY_BROADPH_RESPONSE] &&
+          !m_triggerCallbacks[PHY_BROADPH_RESPONSE](
+              m_triggerCallbacksUserPtrs[PHY_BROADPH_RESPONSE], sensorCtrl, objCtrl, nullptr)) {
+        continue;
+      }
+
+      if (!dispatcher->needsCollision(sensorObj, colObj)) {
+        continue;
+      }
+
+      const btScalar threshold = std::min(
+          sensorShape->getContactBreakingThreshold(gContactBreakingThreshold),
+          colObj->getCollisionShape()->getContactBreakingThreshold(gContactBreakingThreshold));
+      CcdProximityContactCallback contactCallback(threshold);
+      m_dynamicsWorld->contactPairTest(sensorObj, colObj, contactCallback);
+
+      if (contactCallback.m_hit) {
+        m_triggerCallbacks[PHY_PROXIMITY_RESPONSE](
+            m_triggerCallbacksUserPtrs[PHY_PROXIMITY_RESPONSE], sensorCtrl, objCtrl, nullptr);
+      }
+    }
+  }
+}
+
 // This call back is called before a pair is added in the cache
 // Handy to remove objects that must be ignored by sensors
 bool CcdOverlapFilterCallBack::needBroadphaseCollision(btBroadphaseProxy *proxy0,
@@ -2705,6 +3277,251 @@ void CcdPhysicsEnvironment::ExportFile(const std::string &filename)
   }
 }
 
+/// Return the snapshot identifier of the controller of a collision object, 0 without controller.
+static unsigned long long get_snapshot_id(const btCollisionObject *object)
+{
+  const CcdPhysicsController *ctrl = static_cast<CcdPhysicsController *>(object->getUserPointer());
+  return (ctrl) ? ctrl->GetSnapshotId() : 0;
+}
+
+/** Saved state of the rigid bodies and of the contact manifolds of an environment. The states
+ * are matched with the controllers by snapshot identifier, a freed controller is never matched
+ * even if a new controller reuses its address.
+ */
+class CcdPhysicsSnapshot : public PHY_IPhysicsSnapshot {
+ public:
+  struct BodyState {
+    unsigned long long m_controllerId;
+    btTransform m_worldTransform;
+    btTransform m_interpolationWorldTransform;
+    btVector3 m_linearVelocity;
+    btVector3 m_angularVelocity;
+    btVector3 m_interpolationLinearVelocity;
+    btVector3 m_interpolationAngularVelocity;
+    int m_activationState;
+    btScalar m_deactivationTime;
+  };
+
+  /// Contact points of a pair of objects, used to warm start the solver after a restore.
+  struct ManifoldState {
+    /// Snapshot identifiers of the controllers of the objects.
+    unsigned long long m_id0;
+    unsigned long long m_id1;
+    /// Indices of the compound children owning the manifold or -1 for the other shapes.
+    int m_childIndex0;
+    int m_childIndex1;
+    int m_numContacts;
+    btManifoldPoint m_points[MANIFOLD_CACHE_SIZE];
+  };
+
+  std::vector<BodyState> m_bodies;
+  std::vector<ManifoldState> m_manifolds;
+};
+
+/** Key identifying a manifold of a pair. A pair using a compound shape has a manifold per
+ * overlapping child, identified by the child index stored in the contact points.
+ */
+struct CcdManifoldKey {
+  unsigned long long m_id0;
+  unsigned long long m_id1;
+  int m_childIndex0;
+  int m_childIndex1;
+
+  CcdManifoldKey(unsigned long long id0, unsigned long long id1, int childIndex0, int childIndex1)
+      : m_id0(id0), m_id1(id1), m_childIndex0(childIndex0), m_childIndex1(childIndex1)
+  {
+  }
+
+  /// Build the key of a manifold from its first contact point or nullptr without contacts.
+  CcdManifoldKey(const btPersistentManifold *manifold, const btManifoldPoint *point)
+      : m_id0(get_snapshot_id(manifold->getBody0())),
+        m_id1(get_snapshot_id(manifold->getBody1())),
+        m_childIndex0(
+            (point && manifold->getBody0()->getCollisionShape()->isCompound()) ? point->m_index0 :
+                                                                                 -1),
+        m_childIndex1(
+            (point && manifold->getBody1()->getCollisionShape()->isCompound()) ? point->m_index1 :
+                                                                                 -1)
+  {
+  }
+
+  bool operator<(const CcdManifoldKey &other) const
+  {
+    if (m_id0 != other.m_id0) {
+      return m_id0 < other.m_id0;
+    }
+    if (m_id1 != other.m_id1) {
+      return m_id1 < other.m_id1;
+    }
+    if (m_childIndex0 != other.m_childIndex0) {
+      return m_childIndex0 < other.m_childIndex0;
+    }
+    return m_childIndex1 < other.m_childIndex1;
+  }
+
+  bool operator==(const CcdManifoldKey &other) const
+  {
+    return m_id0 == other.m_id0 && m_id1 == other.m_id1 &&
+           m_childIndex0 == other.m_childIndex0 && m_childIndex1 == other.m_childIndex1;
+  }
+};
+
+PHY_IPhysicsSnapshot *CcdPhysicsEnvironment::SaveSnapshot(PHY_IPhysicsSnapshot *snapshot)
+{
+  CcdPhysicsSnapshot *ccdSnapshot;
+  if (snapshot) {
+    ccdSnapshot = static_cast<CcdPhysicsSnapshot *>(snapshot);
+  }
+  else {
+    ccdSnapshot = new CcdPhysicsSnapshot();
+  }
+
+  UpdateControllerArrays();
+
+  ccdSnapshot->m_bodies.resize(m_rigidBodyControllers.size());
+  for (unsigned int i = 0, size = m_rigidBodyControllers.size(); i < size; ++i) {
+    CcdPhysicsController *ctrl = m_rigidBodyControllers[i];
+    const btRigidBody *body = ctrl->GetRigidBody();
+    CcdPhysicsSnapshot::BodyState &state = ccdSnapshot->m_bodies[i];
+
+    state.m_controllerId = ctrl->GetSnapshotId();
+    state.m_worldTransform = body->getWorldTransform();
+    state.m_interpolationWorldTransform = body->getInterpolationWorldTransform();
+    state.m_linearVelocity = body->getLinearVelocity();
+    state.m_angularVelocity = body->getAngularVelocity();
+    state.m_interpolationLinearVelocity = body->getInterpolationLinearVelocity();
+    state.m_interpolationAngularVelocity = body->getInterpolationAngularVelocity();
+    state.m_activationState = body->getActivationState();
+    state.m_deactivationTime = body->getDeactivationTime();
+  }
+
+  btDispatcher *dispatcher = m_dynamicsWorld->getDispatcher();
+  const int numManifolds = dispatcher->getNumManifolds();
+  ccdSnapshot->m_manifolds.clear();
+  for (int i = 0; i < numManifolds; ++i) {
+    const btPersistentManifold *manifold = dispatcher->getManifoldByIndexInternal(i);
+    const int numContacts = manifold->getNumContacts();
+    if (numContacts == 0) {
+      continue;
+    }
+
+    const CcdManifoldKey key(manifold, &manifold->getContactPoint(0));
+    if (key.m_id0 == 0 || key.m_id1 == 0) {
+      continue;
+    }
+
+    ccdSnapshot->m_manifolds.emplace_back();
+    CcdPhysicsSnapshot::ManifoldState &state = ccdSnapshot->m_manifolds.back();
+    state.m_id0 = key.m_id0;
+    state.m_id1 = key.m_id1;
+    state.m_childIndex0 = key.m_childIndex0;
+    state.m_childIndex1 = key.m_childIndex1;
+    state.m_numContacts = numContacts;
+    for (int j = 0; j < numContacts; ++j) {
+      state.m_points[j] = manifold->getContactPoint(j);
+      // The user data is destroyed with the contact point.
+      state.m_points[j].m_userPersistentData = nullptr;
+    }
+  }
+
+  return ccdSnapshot;
+}
+
+typedef std::pair<CcdManifoldKey, btPersistentManifold *> CcdManifoldEntry;
+
+/// Order the manifold entries by key only.
+class CcdManifoldEntryLess {
+ public:
+  bool operator()(const CcdManifoldEntry &entry1, const CcdManifoldEntry &entry2) const
+  {
+    return entry1.first < entry2.first;
+  }
+};
+
+void CcdPhysicsEnvironment::RestoreSnapshot(PHY_IPhysicsSnapshot *snapshot)
+{
+  CcdPhysicsSnapshot *ccdSnapshot = static_cast<CcdPhysicsSnapshot *>(snapshot);
+
+  UpdateControllerArrays();
+
+  // Only the bodies in the world are restored, the suspended controllers keep their state.
+  std::map<unsigned long long, unsigned int> savedIndices;
+  for (unsigned int i = 0, size = m_rigidBodyControllers.size(); i < size; ++i) {
+    CcdPhysicsController *ctrl = m_rigidBodyControllers[i];
+    btRigidBody *body = ctrl->GetRigidBody();
+    if (!body) {
+      continue;
+    }
+
+    const unsigned long long id = ctrl->GetSnapshotId();
+    unsigned int index = i;
+    // The controllers are usually unchanged, else search the controller in the saved states.
+    if (i >= ccdSnapshot->m_bodies.size() || ccdSnapshot->m_bodies[i].m_controllerId != id) {
+      if (savedIndices.empty()) {
+        for (unsigned int j = 0, numSaved = ccdSnapshot->m_bodies.size(); j < numSaved; ++j) {
+          savedIndices[ccdSnapshot->m_bodies[j].m_controllerId] = j;
+        }
+      }
+
+      std::map<unsigned long long, unsigned int>::const_iterator it = savedIndices.find(id);
+      if (it == savedIndices.end()) {
+        continue;
+      }
+      index = it->second;
+    }
+
+    const CcdPhysicsSnapshot::BodyState &state = ccdSnapshot->m_bodies[index];
+
+    body->setWorldTransform(state.m_worldTransform);
+    body->setInterpolationWorldTransform(state.m_interpolationWorldTransform);
+    body->setLinearVelocity(state.m_linearVelocity);
+    body->setAngularVelocity(state.m_angularVelocity);
+    body->setInterpolationLinearVelocity(state.m_interpolationLinearVelocity);
+    body->setInterpolationAngularVelocity(state.m_interpolationAngularVelocity);
+    body->forceActivationState(state.m_activationState);
+    body->setDeactivationTime(state.m_deactivationTime);
+    body->clearForces();
+
+    m_dynamicsWorld->updateSingleAabb(body);
+    // Write the restored transform to the motion state at the next synchronization.
+    ctrl->m_motionStateModified = true;
+  }
+
+  /* Replace the contact points of the pairs still overlapping, the other pairs are
+   * recomputed at the next step. */
+  btDispatcher *dispatcher = m_dynamicsWorld->getDispatcher();
+  const int numManifolds = dispatcher->getNumManifolds();
+  /* Each manifold is matched with its saved state by the pair and the compound children. An
+   * empty manifold of a compound child is not identified and is recomputed. */
+  std::vector<CcdManifoldEntry> manifolds;
+  manifolds.reserve(numManifolds);
+  for (int i = 0; i < numManifolds; ++i) {
+    btPersistentManifold *manifold = dispatcher->getManifoldByIndexInternal(i);
+    const btManifoldPoint *point = (manifold->getNumContacts() > 0) ?
+                                       &manifold->getContactPoint(0) :
+                                       nullptr;
+    manifolds.emplace_back(CcdManifoldKey(manifold, point), manifold);
+    manifold->clearManifold();
+  }
+  std::sort(manifolds.begin(), manifolds.end(), CcdManifoldEntryLess());
+
+  for (const CcdPhysicsSnapshot::ManifoldState &state : ccdSnapshot->m_manifolds) {
+    const CcdManifoldEntry key(
+        CcdManifoldKey(state.m_id0, state.m_id1, state.m_childIndex0, state.m_childIndex1),
+        nullptr);
+    std::vector<CcdManifoldEntry>::const_iterator it = std::lower_bound(
+        manifolds.begin(), manifolds.end(), key, CcdManifoldEntryLess());
+    if (it == manifolds.end() || !(it->first == key.first)) {
+      continue;
+    }
+
+    btPersistentManifold *manifold = it->second;
+    for (int i = 0; i < state.m_numContacts; ++i) {
+      manifold->addManifoldPoint(state.m_points[i]);
+    }
+  }
+}
+
 struct BlenderDebugDraw : public btIDebugDraw {
   BlenderDebugDraw() : m_debugMode(0)
   {
@@ -2748,14 +3565,34 @@ struct BlenderDebugDraw : public btIDebugDraw {
   }
 };
 
+/// Maximum size of the physics cache directory, the least recently used files are removed.
+static const size_t PHYSICS_CACHE_MAX_SIZE = 256 * 1024 * 1024;
+
 CcdPhysicsEnvironment *CcdPhysicsEnvironment::Create(Scene *blenderscene, bool visualizePhysics)
 {
-  CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(false);
+  CcdPhysicsEnvironment *ccdPhysEnv = new CcdPhysicsEnvironment(
+      false,
+      (blenderscene->gm.flag & GAME_USE_PARALLEL_PHYSICS) != 0,
+      blenderscene->gm.physicsthreads);
   ccdPhysEnv->SetDebugDrawer(new BlenderDebugDraw());
   ccdPhysEnv->SetDeactivationLinearTreshold(blenderscene->gm.lineardeactthreshold);
   ccdPhysEnv->SetDeactivationAngularTreshold(blenderscene->gm.angulardeactthreshold);
   ccdPhysEnv->SetDeactivationTime(blenderscene->gm.deactivationtime);
 
+  if (blenderscene->gm.flag & GAME_USE_PHYSICS_CACHE) {
+    // Store the cache next to the blend file or in the temporary directory if unsaved.
+    char directory[FILE_MAX];
+    const std::string &mainPath = KX_GetMainPath();
+    if (mainPath.empty()) {
+      BLI_strncpy(directory, BKE_tempdir_base(), sizeof(directory));
+    }
+    else {
+      BLI_split_dir_part(mainPath.c_str(), directory, sizeof(directory));
+    }
+    BLI_path_append(directory, sizeof(directory), "physics_cache");
+    ccdPhysEnv->m_shapeCache = new CcdShapeCache(directory, PHYSICS_CACHE_MAX_SIZE);
+  }
+
   if (visualizePhysics)
     ccdPhysEnv->SetDebugMode(btIDebugDraw::DBG_DrawWireframe | btIDebugDraw::DBG_DrawAabb |
                              btIDebugDraw::DBG_DrawContactPoints | btIDebugDraw::DBG_DrawText |
@@ -3029,7 +3866,8 @@ void CcdPhysicsEnvironment::ConvertObject(KX_BlenderSceneConverter &converter,
         shapeInfo->setVertexWeldingThreshold1(0.0f);  // todo: expose this to the UI
       }
 
-      bm = shapeInfo->CreateBulletShape(ci.m_margin, useGimpact, !isbulletsoftbody);
+      bm = shapeInfo->CreateBulletShape(
+          ci.m_margin, useGimpact, !isbulletsoftbody, m_shapeCache);
       // should we compute inertia for dynamic shape?
       // bm->calculateLocalInertia(ci.m_mass,ci.m_localInertiaTensor);
 
@@ -3314,6 +4152,11 @@ CcdCollData::~CcdCollData()
 {
 }
 
+void CcdCollData::SetManifold(const btPersistentManifold *manifoldPoint)
+{
+  m_manifoldPoint = manifoldPoint;
+}
+
 unsigned int CcdCollData::GetNumContacts() const
 {
   return m_manifoldPoint->getNumContacts();
@@ -48,12 +48,15 @@ class WrapperVehicle;
 class btPersistentManifold;
 class btBroadphaseInterface;
 struct btDbvtBroadphase;
+struct btBroadphaseProxy;
 class btOverlappingPairCache;
 class btIDebugDraw;
 class btDynamicsWorld;
 class PHY_IVehicle;
 class CcdOverlapFilterCallBack;
 class CcdShapeConstructionInfo;
+class CcdShapeCache;
+class CcdCollData;
 
 /** CcdPhysicsEnvironment is an experimental mainloop for physics simulation using optional
  * continuous collision detection. Physics Environment takes care of stepping the simulation and is
@@ -98,8 +101,22 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   void ProcessFhSprings(double curTime, float timeStep);
 
+  /// Rebuild the dense controller arrays if controllers were added or removed.
+  void UpdateControllerArrays();
+  /// Update once the compound controllers whose children changed since the last step.
+  void UpdateModifiedCompounds();
+  /// Synchronize the motion states of the soft bodies and of the modified or active objects.
+  void SynchronizeMotionStates(float timeStep);
+
  public:
+  /** \param parallel Compute the narrowphase and solve the islands with a task scheduler, else
+   * the default Bullet dispatcher and world are used.
+   * \param numThreads The number of threads of the parallel physics, 0 to share the engine
+   * task scheduler.
+   */
   CcdPhysicsEnvironment(bool useDbvtCulling,
+                        bool parallel = false,
+                        int numThreads = 0,
                         btDispatcher *dispatcher = nullptr,
                         btOverlappingPairCache *pairCache = nullptr);
 
@@ -141,6 +158,8 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   }
   /// Perform an integration step of duration 'timeStep'.
   virtual bool ProceedDeltaTime(double curTime, float timeStep, float interval);
+  /// Bullet deactivation time and contact breaking threshold are globals shared by all worlds.
+  virtual bool CanProceedConcurrently(PHY_IPhysicsEnvironment *other) const;
 
   /**
    * Called by Bullet for every physical simulation (sub)tick.
@@ -207,6 +226,10 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
                                           float toX,
                                           float toY,
                                           float toZ);
+  virtual void CastTestBatch(const std::vector<PHY_CastQuery> &queries,
+                             float radius,
+                             const PHY_ICastFilter *filter,
+                             std::vector<PHY_CastResult> &results);
   virtual bool CullingTest(PHY_CullingCallback callback,
                            void *userData,
                            const std::array<MT_Vector4, 6> &planes,
@@ -220,6 +243,11 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   virtual void AddCollisionCallback(int response_class, PHY_ResponseCallback callback, void *user);
   virtual bool RequestCollisionCallback(PHY_IPhysicsController *ctrl);
   virtual bool RemoveCollisionCallback(PHY_IPhysicsController *ctrl);
+  virtual void ReleaseCollisionData();
+  virtual void AddProximitySensor(PHY_IPhysicsController *ctrl);
+  virtual void RemoveProximitySensor(PHY_IPhysicsController *ctrl);
+  /// Report the objects overlapping the proximity sensors, using the broadphase of the world.
+  void ProcessProximitySensors();
   // These two methods are used *solely* to create controllers for Near/Radar sensor! Don't use for
   // anything else
   virtual PHY_IPhysicsController *CreateSphereController(float radius, const MT_Vector3 &position);
@@ -251,6 +279,10 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
 
   void RefreshCcdPhysicsController(CcdPhysicsController *ctrl);
 
+  /// Delay the update of a compound controller whose children changed to the next step.
+  void AddModifiedCompound(CcdPhysicsController *ctrl);
+  void RemoveModifiedCompound(CcdPhysicsController *ctrl);
+
   bool IsActiveCcdPhysicsController(CcdPhysicsController *ctrl);
 
   void AddCcdGraphicController(CcdGraphicController *ctrl);
@@ -282,6 +314,9 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
     return m_dynamicsWorld;
   }
 
+  /// Return the cache of the triangle mesh hierarchies or nullptr if disabled.
+  CcdShapeCache *GetShapeCache() const;
+
   class btConstraintSolver *GetConstraintSolver();
 
   void MergeEnvironment(PHY_IPhysicsEnvironment *other_env);
@@ -308,8 +343,30 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
  protected:
   std::set<CcdPhysicsController *> m_controllers;
 
+  /** Dense arrays of the controllers partitioned by type, rebuilt from m_controllers when it
+   * changes. The static, kinematic and dynamic rigid bodies share the same array as this state
+   * changes at runtime without removing the controller. */
+  std::vector<CcdPhysicsController *> m_rigidBodyControllers;
+  std::vector<CcdPhysicsController *> m_softBodyControllers;
+  /// Collision objects without body: sensors, characters and no collision objects.
+  std::vector<CcdPhysicsController *> m_collisionObjectControllers;
+  /// Rigid bodies using a linear or angular Fh spring.
+  std::vector<CcdPhysicsController *> m_fhSpringControllers;
+  bool m_controllerArraysModified;
+  /// Compound controllers whose children changed since the last step.
+  std::vector<CcdPhysicsController *> m_modifiedCompounds;
+
   PHY_ResponseCallback m_triggerCallbacks[PHY_NUM_RESPONSE];
   void *m_triggerCallbacksUserPtrs[PHY_NUM_RESPONSE];
+  /// Collision data passed to the response callbacks, reused once released.
+  std::vector<CcdCollData *> m_collDataPool;
+  /// Number of collision data of the pool in use.
+  unsigned int m_numCollData;
+
+  /// Controllers of the Near and Radar sensors, not added to the dynamics world.
+  std::vector<CcdPhysicsController *> m_proximitySensors;
+  /// Broadphase proxies overlapping a proximity sensor, reused between the sensors.
+  std::vector<btBroadphaseProxy *> m_proximityProxies;
 
   std::vector<WrapperVehicle *> m_wrapperVehicles;
 
@@ -331,8 +388,15 @@ class CcdPhysicsEnvironment : public PHY_IPhysicsEnvironment {
   class btGhostPairCallback *m_ghostPairCallback;
 
   class btDispatcher *m_ownDispatcher;
+  /// Scheduler of the parallel physics created for a specific number of threads.
+  struct TaskScheduler *m_ownScheduler;
+  /// Cache of the triangle mesh hierarchies, nullptr if disabled.
+  CcdShapeCache *m_shapeCache;
 
   virtual void ExportFile(const std::string &filename);
+
+  virtual PHY_IPhysicsSnapshot *SaveSnapshot(PHY_IPhysicsSnapshot *snapshot);
+  virtual void RestoreSnapshot(PHY_IPhysicsSnapshot *snapshot);
 };
 
 class CcdCollData : public PHY_CollData {
@@ -342,6 +406,8 @@ class CcdCollData : public PHY_CollData {
   CcdCollData(const btPersistentManifold *manifoldPoint);
   virtual ~CcdCollData();
 
+  void SetManifold(const btPersistentManifold *manifoldPoint);
+
   virtual unsigned int GetNumContacts() const;
   virtual MT_Vector3 GetLocalPointA(unsigned int index, bool first) const;
   virtual MT_Vector3 GetLocalPointB(unsigned int index, bool first) const;
@@ -0,0 +1,260 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdShapeCache.cpp
+ *  \ingroup physbullet
+ */
+
+
+#include "CcdShapeCache.h"
+
+#include "BulletCollision/CollisionShapes/btOptimizedBvh.h"
+#include "BulletCollision/CollisionShapes/btStridingMeshInterface.h"
+
+#include "CM_Message.h"
+
+#include "BLI_fileops.h"
+#include "BLI_fileops_types.h"
+#include "BLI_hash_md5.h"
+#include "BLI_path_util.h"
+#include "BLI_string.h"
+#include "BLI_utildefines.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include <sys/stat.h>
+
+/// Extension of the hierarchy cache files.
+#define SHAPE_CACHE_BVH_EXTENSION ".bvh"
+
+namespace {
+
+/** Description of the cached hierarchy, a file is only used if all the fields before the data
+ * size match the mesh and the Bullet build.
+ */
+struct BvhFileHeader {
+  char m_magic[8];
+  int m_bulletVersion;
+  int m_scalarSize;
+  int m_numVertices;
+  int m_numTriangles;
+  unsigned int m_dataSize;
+};
+
+/// Sort the cache files from the least recently used.
+class CompareFileTime {
+ public:
+  bool operator()(const direntry *file1, const direntry *file2) const
+  {
+    return file1->s.st_mtime < file2->s.st_mtime;
+  }
+};
+
+}  // namespace
+
+static const char shape_cache_magic[8] = {'B', 'G', 'E', 'B', 'V', 'H', '0', '1'};
+
+/// Compute the path of the cache file of a mesh and the header describing it.
+static void get_cache_file(const std::string &directory,
+                           btStridingMeshInterface *meshInterface,
+                           char r_path[FILE_MAX],
+                           BvhFileHeader &r_header)
+{
+  memset(&r_header, 0, sizeof(BvhFileHeader));
+  memcpy(r_header.m_magic, shape_cache_magic, sizeof(shape_cache_magic));
+  r_header.m_bulletVersion = BT_BULLET_VERSION;
+  r_header.m_scalarSize = sizeof(btScalar);
+
+  // Hash each array of the mesh and the scaling, then hash all the digests.
+  const int numParts = meshInterface->getNumSubParts();
+  std::vector<unsigned char> digests((numParts * 2 + 1) * 16);
+  for (int part = 0; part < numParts; ++part) {
+    const unsigned char *vertexBase;
+    int numVertices;
+    PHY_ScalarType vertexType;
+    int vertexStride;
+    const unsigned char *indexBase;
+    int indexStride;
+    int numTriangles;
+    PHY_ScalarType indexType;
+    meshInterface->getLockedReadOnlyVertexIndexBase(&vertexBase,
+                                                    numVertices,
+                                                    vertexType,
+                                                    vertexStride,
+                                                    &indexBase,
+                                                    indexStride,
+                                                    numTriangles,
+                                                    indexType,
+                                                    part);
+
+    BLI_hash_md5_buffer(
+        (const char *)vertexBase, numVertices * vertexStride, &digests[part * 32]);
+    BLI_hash_md5_buffer(
+        (const char *)indexBase, numTriangles * indexStride, &digests[part * 32 + 16]);
+
+    meshInterface->unLockReadOnlyVertexBase(part);
+
+    r_header.m_numVertices += numVertices;
+    r_header.m_numTriangles += numTriangles;
+  }
+
+  const btVector3 &scaling = meshInterface->getScaling();
+  BLI_hash_md5_buffer(
+      (const char *)scaling.m_floats, sizeof(btScalar) * 3, &digests[numParts * 32]);
+
+  unsigned char digest[16];
+  char name[33 + sizeof(SHAPE_CACHE_BVH_EXTENSION)];
+  BLI_hash_md5_buffer((const char *)digests.data(), digests.size(), digest);
+  BLI_hash_md5_to_hexdigest(digest, name);
+  strcat(name, SHAPE_CACHE_BVH_EXTENSION);
+
+  BLI_join_dirfile(r_path, FILE_MAX, directory.c_str(), name);
+}
+
+CcdShapeCache::CcdShapeCache(const std::string &directory, size_t maxSize)
+    : m_directory(directory)
+{
+  Trim(maxSize);
+}
+
+void CcdShapeCache::Trim(size_t maxSize) const
+{
+  if (!BLI_is_dir(m_directory.c_str())) {
+    return;
+  }
+
+  struct direntry *entries;
+  const unsigned int numEntries = BLI_filelist_dir_contents(m_directory.c_str(), &entries);
+
+  std::vector<direntry *> files;
+  size_t totalSize = 0;
+  for (unsigned int i = 0; i < numEntries; ++i) {
+    direntry *entry = &entries[i];
+    // Skip the temporary files being written.
+    if (S_ISDIR(entry->type) ||
+        !BLI_path_extension_check(entry->relname, SHAPE_CACHE_BVH_EXTENSION)) {
+      continue;
+    }
+    files.push_back(entry);
+    totalSize += entry->s.st_size;
+  }
+
+  if (totalSize > maxSize) {
+    std::sort(files.begin(), files.end(), CompareFileTime());
+    for (direntry *entry : files) {
+      if (totalSize <= maxSize) {
+        break;
+      }
+      // A file used by another game is kept if it can't be removed.
+      if (BLI_delete(entry->path, false, false) == 0) {
+        totalSize -= entry->s.st_size;
+      }
+    }
+  }
+
+  BLI_filelist_free(entries, numEntries);
+}
+
+btOptimizedBvh *CcdShapeCache::LoadBvh(btStridingMeshInterface *meshInterface,
+                                       void **r_buffer) const
+{
+  char path[FILE_MAX];
+  BvhFileHeader header;
+  get_cache_file(m_directory, meshInterface, path, header);
+
+  FILE *file = BLI_fopen(path, "rb");
+  if (!file) {
+    return nullptr;
+  }
+
+  btOptimizedBvh *bvh = nullptr;
+  void *buffer = nullptr;
+
+  BvhFileHeader fileHeader;
+  if (fread(&fileHeader, sizeof(BvhFileHeader), 1, file) == 1 &&
+      memcmp(&fileHeader, &header, offsetof(BvhFileHeader, m_dataSize)) == 0) {
+    // The hierarchy is deserialized in place, the buffer must use the Bullet alignment.
+    buffer = btAlignedAlloc(fileHeader.m_dataSize, 16);
+    if (fread(buffer, 1, fileHeader.m_dataSize, file) == fileHeader.m_dataSize) {
+      bvh = btOptimizedBvh::deSerializeInPlace(buffer, fileHeader.m_dataSize, false);
+    }
+  }
+
+  fclose(file);
+
+  if (!bvh) {
+    CM_Warning("invalid physics cache file \"" << path << "\", the mesh hierarchy is rebuilt");
+    if (buffer) {
+      btAlignedFree(buffer);
+    }
+    return nullptr;
+  }
+
+  // Mark the file as recently used to keep it when the cache is trimmed.
+  BLI_file_touch(path);
+
+  *r_buffer = buffer;
+  return bvh;
+}
+
+void CcdShapeCache::SaveBvh(btStridingMeshInterface *meshInterface,
+                            const btOptimizedBvh *bvh) const
+{
+  char path[FILE_MAX];
+  BvhFileHeader header;
+  get_cache_file(m_directory, meshInterface, path, header);
+
+  header.m_dataSize = bvh->calculateSerializeBufferSize();
+  void *buffer = btAlignedAlloc(header.m_dataSize, 16);
+  if (!bvh->serializeInPlace(buffer, header.m_dataSize, false)) {
+    btAlignedFree(buffer);
+    return;
+  }
+
+  char directory[FILE_MAX];
+  BLI_split_dir_part(path, directory, sizeof(directory));
+
+  // Write in a temporary file renamed at the end to never leave a partial cache file.
+  char tmpPath[FILE_MAX];
+  BLI_snprintf(tmpPath, sizeof(tmpPath), "%s.%p.tmp", path, (void *)bvh);
+
+  bool written = false;
+  if (BLI_dir_create_recursive(directory)) {
+    FILE *file = BLI_fopen(tmpPath, "wb");
+    if (file) {
+      written = (fwrite(&header, sizeof(BvhFileHeader), 1, file) == 1 &&
+                 fwrite(buffer, 1, header.m_dataSize, file) == header.m_dataSize);
+      written = (fclose(file) == 0) && written;
+    }
+  }
+
+  if (!written || BLI_rename(tmpPath, path) != 0) {
+    CM_Warning("failed to write physics cache file \"" << path << "\"");
+    if (BLI_exists(tmpPath)) {
+      BLI_delete(tmpPath, false, false);
+    }
+  }
+
+  btAlignedFree(buffer);
+}
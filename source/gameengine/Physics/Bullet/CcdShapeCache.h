@@ -0,0 +1,66 @@
+/*
+ * ***** BEGIN GPL LICENSE BLOCK *****
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ * Contributor(s): none yet.
+ *
+ * ***** END GPL LICENSE BLOCK *****
+ */
+
+/** \file CcdShapeCache.h
+ *  \ingroup physbullet
+ */
+
+
+#ifndef __CCDSHAPECACHE_H__
+#define __CCDSHAPECACHE_H__
+
+#include <string>
+
+class btOptimizedBvh;
+class btStridingMeshInterface;
+
+/** Cache on disk of the bounding volume hierarchies of the triangle mesh shapes.
+ * A hierarchy is stored in the Bullet in place serialization format in a file named by the hash
+ * of the mesh vertices and triangles, the next conversions of the same mesh load it instead of
+ * building it again, also in the following game runs.
+ * The cache is owned by a physics environment and only used by the conversion of its objects.
+ */
+class CcdShapeCache {
+ private:
+  /// Directory of the cache files.
+  std::string m_directory;
+
+ public:
+  /** Use the cache files of a directory, the least recently used files are removed until the
+   * directory is under a maximum size.
+   */
+  CcdShapeCache(const std::string &directory, size_t maxSize);
+  ~CcdShapeCache() = default;
+
+  /// Remove the least recently used files until their total size is under maxSize bytes.
+  void Trim(size_t maxSize) const;
+
+  /** Load the hierarchy of a mesh.
+   * \param r_buffer The memory of the hierarchy to free with btAlignedFree once unused.
+   * \return The hierarchy or nullptr if the mesh is not cached.
+   */
+  btOptimizedBvh *LoadBvh(btStridingMeshInterface *meshInterface, void **r_buffer) const;
+  /// Write the hierarchy of a mesh in the cache.
+  void SaveBvh(btStridingMeshInterface *meshInterface, const btOptimizedBvh *bvh) const;
+};
+
+#endif  // __CCDSHAPECACHE_H__
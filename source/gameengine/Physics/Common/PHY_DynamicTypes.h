@@ -29,11 +29,12 @@ struct KX_ClientObjectInfo;
 
 enum {
   PHY_FH_RESPONSE,
-  PHY_SENSOR_RESPONSE,   // Touch Sensors
-  PHY_CAMERA_RESPONSE,   // Visibility Culling
-  PHY_OBJECT_RESPONSE,   // Object Dynamic Geometry Response
-  PHY_STATIC_RESPONSE,   // Static Geometry Response
-  PHY_BROADPH_RESPONSE,  // broadphase Response
+  PHY_SENSOR_RESPONSE,     // Touch Sensors
+  PHY_CAMERA_RESPONSE,     // Visibility Culling
+  PHY_OBJECT_RESPONSE,     // Object Dynamic Geometry Response
+  PHY_STATIC_RESPONSE,     // Static Geometry Response
+  PHY_BROADPH_RESPONSE,    // broadphase Response
+  PHY_PROXIMITY_RESPONSE,  // Near and Radar Sensors
 
   PHY_NUM_RESPONSE
 };
@@ -39,6 +39,7 @@
 #include "MT_Vector4.h"
 
 #include <array>
+#include <vector>
 
 class PHY_IConstraint;
 class PHY_IVehicle;
@@ -101,6 +102,42 @@ class PHY_IRayCastFilterCallback {
   }
 };
 
+/// Ray or sweep of a batch of casts.
+struct PHY_CastQuery {
+  MT_Vector3 m_from;
+  MT_Vector3 m_to;
+  /// Controller not hit by the cast, can be nullptr.
+  PHY_IPhysicsController *m_ignoreController;
+};
+
+/// Closest hit of a cast, m_controller is nullptr if nothing was hit.
+struct PHY_CastResult {
+  PHY_IPhysicsController *m_controller;
+  MT_Vector3 m_hitPoint;
+  MT_Vector3 m_hitNormal;
+  /// Fraction of the cast from the start to the end point.
+  float m_hitFraction;
+};
+
+/// Filter of the objects tested by a batch of casts.
+class PHY_ICastFilter {
+ public:
+  virtual ~PHY_ICastFilter()
+  {
+  }
+
+  /// Return true to test the object, called concurrently by the casts of a batch.
+  virtual bool NeedCast(PHY_IPhysicsController *controller) const = 0;
+};
+
+/// State of the bodies of a physics environment saved to be restored later.
+class PHY_IPhysicsSnapshot {
+ public:
+  virtual ~PHY_IPhysicsSnapshot()
+  {
+  }
+};
+
 /**
  * Physics Environment takes care of stepping the simulation and is a container for physics
  * entities (rigidbodies,constraints, materials etc.) A derived class may be able to 'construct'
@@ -115,6 +152,11 @@ class PHY_IPhysicsEnvironment {
   virtual void EndFrame() = 0;
   /// Perform an integration step of duration 'timeStep'.
   virtual bool ProceedDeltaTime(double curTime, float timeStep, float interval) = 0;
+  /// Return true if ProceedDeltaTime can be called at the same time on this and other.
+  virtual bool CanProceedConcurrently(PHY_IPhysicsEnvironment *other) const
+  {
+    return true;
+  }
   /// draw debug lines (make sure to call this during the render phase, otherwise lines are not
   /// drawn properly)
   virtual void DebugDrawWorld()
@@ -230,6 +272,22 @@ class PHY_IPhysicsEnvironment {
                                           float toY,
                                           float toZ) = 0;
 
+  /** Cast rays, or spheres if the radius is positive, and find their closest hit.
+   * The casts are independent and the environment can compute them in parallel.
+   * \param filter The filter of the tested objects, nullptr to test all the objects.
+   * \param results Set to the result of each query.
+   */
+  virtual void CastTestBatch(const std::vector<PHY_CastQuery> &queries,
+                             float radius,
+                             const PHY_ICastFilter *filter,
+                             std::vector<PHY_CastResult> &results)
+  {
+    PHY_CastResult noHit;
+    noHit.m_controller = nullptr;
+    noHit.m_hitFraction = 1.0f;
+    results.assign(queries.size(), noHit);
+  }
+
   // culling based on physical broad phase
   // the plane number must be set as follow: near, far, left, right, top, botton
   // the near plane must be the first one and must always be present, it is used to get the
@@ -249,6 +307,24 @@ class PHY_IPhysicsEnvironment {
                                     void *user) = 0;
   virtual bool RequestCollisionCallback(PHY_IPhysicsController *ctrl) = 0;
   virtual bool RemoveCollisionCallback(PHY_IPhysicsController *ctrl) = 0;
+  /** Add the controller of a Near or Radar sensor tested once per frame against the objects
+   * without being part of the simulation, the overlaps are reported to PHY_PROXIMITY_RESPONSE.
+   * By default the controller is added as any other sensor.
+   */
+  virtual void AddProximitySensor(PHY_IPhysicsController *ctrl)
+  {
+    AddSensor(ctrl);
+  }
+  virtual void RemoveProximitySensor(PHY_IPhysicsController *ctrl)
+  {
+    RemoveSensor(ctrl);
+  }
+  /** Release the collision data passed to the response callbacks since the previous release,
+   * the data stay valid until this call.
+   */
+  virtual void ReleaseCollisionData()
+  {
+  }
   // These two methods are *solely* used to create controllers for sensor! Don't use for anything
   // else
   virtual PHY_IPhysicsController *CreateSphereController(float radius,
@@ -257,6 +333,19 @@ class PHY_IPhysicsEnvironment {
 
   virtual void ExportFile(const std::string &filename){};
 
+  /** Save the state of the bodies in a snapshot.
+   * \param snapshot A snapshot previously returned to reuse its memory or nullptr.
+   * \return The snapshot or nullptr if the environment doesn't support snapshots.
+   */
+  virtual PHY_IPhysicsSnapshot *SaveSnapshot(PHY_IPhysicsSnapshot *snapshot)
+  {
+    return nullptr;
+  }
+  /// Restore the state of the bodies saved in a snapshot, the removed bodies are ignored.
+  virtual void RestoreSnapshot(PHY_IPhysicsSnapshot *snapshot)
+  {
+  }
+
   virtual void MergeEnvironment(PHY_IPhysicsEnvironment *other_env) = 0;
 
   virtual void ConvertObject(KX_BlenderSceneConverter &converter,
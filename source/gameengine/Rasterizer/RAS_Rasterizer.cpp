@@ -188,13 +188,12 @@ RAS_Rasterizer::RAS_Rasterizer()
       m_noOfScanlines(32),
       m_clientobject(nullptr),
       m_auxilaryClientInfo(nullptr),
+      m_numgllights(0),
       m_shadowMode(RAS_SHADOW_NONE),
       m_invertFrontFace(false),
       m_last_frontface(true)
 {
   m_impl.reset(new RAS_OpenGLRasterizer(this));
-
-  m_numgllights = m_impl->GetNumLights();
 }
 
 RAS_Rasterizer::~RAS_Rasterizer()
@@ -281,6 +280,9 @@ void RAS_Rasterizer::Init(RAS_ICanvas *canvas)
 {
   GPU_state_init();
 
+  // Queried here and not in the constructor which must not need a GL context.
+  m_numgllights = m_impl->GetNumLights();
+
   Disable(RAS_BLEND);
   Disable(RAS_ALPHA_TEST);
 
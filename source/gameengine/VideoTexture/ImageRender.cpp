@@ -41,6 +41,7 @@
 #include "GPU_glew.h"
 
 #include "KX_Globals.h"
+#include "KX_KetsjiEngine.h"
 #include "DNA_scene_types.h"
 #include "RAS_FrameBuffer.h"
 #include "RAS_CameraData.h"
@@ -65,6 +66,7 @@ extern "C" {
 ExceptionID SceneInvalid, CameraInvalid, ObserverInvalid, FrameBufferInvalid;
 ExceptionID MirrorInvalid, MirrorSizeInvalid, MirrorNormalInvalid, MirrorHorizontal,
     MirrorTooSmall;
+ExceptionID RenderUnavailable;
 ExpDesc SceneInvalidDesc(SceneInvalid, "Scene object is invalid");
 ExpDesc CameraInvalidDesc(CameraInvalid, "Camera object is invalid");
 ExpDesc ObserverInvalidDesc(ObserverInvalid, "Observer object is invalid");
@@ -74,6 +76,7 @@ ExpDesc MirrorSizeInvalidDesc(MirrorSizeInvalid, "Mirror has no vertex or no siz
 ExpDesc MirrorNormalInvalidDesc(MirrorNormalInvalid, "Cannot determine mirror plane");
 ExpDesc MirrorHorizontalDesc(MirrorHorizontal, "Mirror is horizontal in local space");
 ExpDesc MirrorTooSmallDesc(MirrorTooSmall, "Mirror is too small");
+ExpDesc RenderUnavailableDesc(RenderUnavailable, "Rendering is not available in headless mode");
 
 // constructor
 ImageRender::ImageRender(KX_Scene *scene,
@@ -405,6 +408,10 @@ static int ImageRender_init(PyObject *pySelf, PyObject *args, PyObject *kwds)
                                    &samples))
     return -1;
   try {
+    // the headless engine has no GPU context to render to
+    if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS)) {
+      THRWEXCP(RenderUnavailable, S_OK);
+    }
     // get scene pointer
     KX_Scene *scenePtr(nullptr);
     if (!PyObject_TypeCheck(scene, &KX_Scene::Type)) {
@@ -633,6 +640,10 @@ static int ImageMirror_init(PyObject *pySelf, PyObject *args, PyObject *kwds)
                                    &samples))
     return -1;
   try {
+    // the headless engine has no GPU context to render to
+    if (KX_GetActiveEngine()->GetFlag(KX_KetsjiEngine::HEADLESS)) {
+      THRWEXCP(RenderUnavailable, S_OK);
+    }
     // get scene pointer
     KX_Scene *scenePtr(nullptr);
     if (scene != nullptr && PyObject_TypeCheck(scene, &KX_Scene::Type))
@@ -0,0 +1,107 @@
+#!/usr/bin/env python3
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Smoke test of the headless blenderplayer: the default scene runs and the python functions
+using the GPU raise a RuntimeError instead of reaching the missing GL context.
+
+Example:
+  ./bge_headless_tests.py --blender ./blender --blenderplayer ./blenderplayer
+"""
+
+import argparse
+import pathlib
+import sys
+import tempfile
+import unittest
+
+from modules import bge_utils
+
+# Printed by the main loop for each render function, with the name of the raised exception.
+RESULT_PREFIX = "BGE_HEADLESS:"
+
+MAIN_LOOP_SCRIPT = """
+import bge
+
+for i in range(10):
+    bge.logic.NextFrame()
+
+scene = bge.logic.getCurrentScene()
+calls = (
+    ("makeScreenshot", lambda: bge.render.makeScreenshot("//screenshot.png")),
+    ("setVsync", lambda: bge.render.setVsync(bge.render.VSYNC_ON)),
+    ("setMipmapping", lambda: bge.render.setMipmapping(bge.render.RAS_MIPMAP_NONE)),
+    ("drawLine", lambda: bge.render.drawLine((0, 0, 0), (1, 1, 1), (1, 0, 0))),
+    ("addFilter", lambda: scene.filterManager.addFilter(0, bge.logic.RAS_2DFILTER_BLUR, "")),
+    ("ImageRender", lambda: bge.texture.ImageRender(scene, scene.active_camera)),
+)
+for name, call in calls:
+    try:
+        call()
+        error = "None"
+    except Exception as ex:
+        error = type(ex).__name__
+    print("{prefix}%s:%s" % (name, error))
+
+bge.logic.NextFrame()
+"""
+
+
+class HeadlessPlayerTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.tempdir_obj = tempfile.TemporaryDirectory(prefix='bge-headless')
+        cls.tempdir = pathlib.Path(cls.tempdir_obj.name)
+        cls.blendfile = cls.tempdir / 'headless.blend'
+        bge_utils.build_blend(args.blender, cls.blendfile, bge_utils.LOGIC_SCENE_SCRIPT.format(
+            script="", use_function=False, num_objects=16))
+
+        main_loop = cls.tempdir / 'main_loop.py'
+        main_loop.write_text(MAIN_LOOP_SCRIPT.format(prefix=RESULT_PREFIX))
+        cls.code, cls.output = bge_utils.run_player(args.blenderplayer, cls.blendfile, main_loop)
+
+        cls.results = {}
+        for line in cls.output.splitlines():
+            if line.startswith(RESULT_PREFIX):
+                name, error = line[len(RESULT_PREFIX):].split(':')
+                cls.results[name] = error
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.tempdir_obj.cleanup()
+
+    def test_exit_code(self):
+        self.assertEqual(0, self.code, self.output)
+
+    def test_render_functions_raise(self):
+        for name in ("makeScreenshot", "setVsync", "setMipmapping", "drawLine", "addFilter",
+                     "ImageRender"):
+            with self.subTest(name=name):
+                self.assertEqual("RuntimeError", self.results.get(name), self.output)
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--blender', required=True)
+    parser.add_argument('--blenderplayer', required=True)
+    args, remaining = parser.parse_known_args()
+
+    unittest.main(argv=sys.argv[0:1] + remaining)
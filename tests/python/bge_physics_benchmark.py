@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Benchmark of the parallel physics, run in the headless player.
+
+A grid of rigid body cubes falls in a pile on a plane, the scene is run with the parallel
+physics disabled and with 1, 2, 4 and 8 physics threads.
+
+Example:
+  ./bge_physics_benchmark.py --blender ./blender --blenderplayer ./blenderplayer
+"""
+
+import argparse
+import pathlib
+import sys
+import tempfile
+
+from modules import bge_utils
+
+SCENE_SCRIPT = """
+import bpy
+
+scene = bpy.context.scene
+scene.game_settings.use_parallel_physics = {parallel!r}
+scene.game_settings.physics_threads = {threads:d}
+
+bpy.ops.mesh.primitive_plane_add(size=200.0, location=(0.0, 0.0, -1.0))
+
+base = bpy.data.objects["Cube"]
+base.game.physics_type = 'RIGID_BODY'
+for i in range(1, {num_objects:d}):
+    copy = base.copy()
+    # Layers of 16 x 16 cubes slightly shifted to make them collide while falling.
+    copy.location = ((i % 16) * 2.1 + (i // 256) * 0.5, ((i // 16) % 16) * 2.1, (i // 256) * 2.5)
+    scene.collection.objects.link(copy)
+"""
+
+THREADS = (1, 2, 4, 8)
+
+
+def run_case(args, tempdir, name, parallel, threads):
+    blendfile = tempdir / (name.replace(' ', '_') + '.blend')
+    bge_utils.build_blend(args.blender, blendfile, SCENE_SCRIPT.format(
+        parallel=parallel, threads=threads, num_objects=args.objects))
+
+    times = []
+    for i in range(args.repeat):
+        code, output = bge_utils.run_player(args.blenderplayer, blendfile,
+                                            tempdir / 'main_loop.py')
+        if code:
+            raise RuntimeError('Error %d running %s:\n%s' % (code, name, output))
+        times.append(bge_utils.parse_time(output))
+    return min(times)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--blender', required=True)
+    parser.add_argument('--blenderplayer', required=True)
+    parser.add_argument('--objects', type=int, default=2048)
+    parser.add_argument('--frames', type=int, default=300)
+    parser.add_argument('--repeat', type=int, default=3)
+    args = parser.parse_args()
+
+    cases = [("serial", False, 0)]
+    cases += [("%d threads" % threads, True, threads) for threads in THREADS]
+
+    with tempfile.TemporaryDirectory(prefix='bge-benchmark') as dirname:
+        tempdir = pathlib.Path(dirname)
+        bge_utils.write_main_loop(tempdir / 'main_loop.py', args.frames)
+
+        print("%d objects, %d frames" % (args.objects, args.frames))
+        for name, parallel, threads in cases:
+            elapsed = run_case(args, tempdir, name, parallel, threads)
+            print("%-20s %8.3f ms/frame" % (name, elapsed * 1000.0 / args.frames))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,118 @@
+#!/usr/bin/env python3
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Test of the parallel physics determinism, run in the headless player.
+
+A pile of rigid body cubes falls on a plane with one physics thread, which steps the islands
+serially, and with several threads. The final transforms of all the cubes must be identical.
+
+Example:
+  ./bge_physics_determinism_tests.py --blender ./blender --blenderplayer ./blenderplayer
+"""
+
+import argparse
+import pathlib
+import sys
+import tempfile
+import unittest
+
+from modules import bge_utils
+
+# Printed by the main loop for each object, with its world position and orientation.
+RESULT_PREFIX = "BGE_TRANSFORM:"
+
+SCENE_SCRIPT = """
+import bpy
+
+scene = bpy.context.scene
+scene.game_settings.use_parallel_physics = True
+scene.game_settings.physics_threads = {threads:d}
+
+bpy.ops.mesh.primitive_plane_add(size=100.0, location=(0.0, 0.0, -1.0))
+
+base = bpy.data.objects["Cube"]
+base.game.physics_type = 'RIGID_BODY'
+for i in range(1, 256):
+    copy = base.copy()
+    # Layers of 8 x 8 cubes slightly shifted to make them collide while falling.
+    copy.location = ((i % 8) * 2.1 + (i // 64) * 0.5, ((i // 8) % 8) * 2.1, (i // 64) * 2.5)
+    scene.collection.objects.link(copy)
+"""
+
+MAIN_LOOP_SCRIPT = """
+import bge
+
+for i in range(200):
+    bge.logic.NextFrame()
+
+for obj in bge.logic.getCurrentScene().objects:
+    values = list(obj.worldPosition) + [v for row in obj.worldOrientation for v in row]
+    print("{prefix}%s:%s" % (obj.name, " ".join(repr(v) for v in values)))
+
+bge.logic.NextFrame()
+"""
+
+THREADS = (2, 4)
+
+
+class PhysicsDeterminismTest(unittest.TestCase):
+    @classmethod
+    def setUpClass(cls):
+        cls.tempdir_obj = tempfile.TemporaryDirectory(prefix='bge-physics')
+        cls.tempdir = pathlib.Path(cls.tempdir_obj.name)
+        cls.main_loop = cls.tempdir / 'main_loop.py'
+        cls.main_loop.write_text(MAIN_LOOP_SCRIPT.format(prefix=RESULT_PREFIX))
+
+    @classmethod
+    def tearDownClass(cls):
+        cls.tempdir_obj.cleanup()
+
+    def run_scene(self, threads):
+        """Returns the final transform of each object, stepped with a number of threads."""
+        blendfile = self.tempdir / ('physics_%d.blend' % threads)
+        bge_utils.build_blend(args.blender, blendfile, SCENE_SCRIPT.format(threads=threads))
+
+        code, output = bge_utils.run_player(args.blenderplayer, blendfile, self.main_loop)
+        self.assertEqual(0, code, output)
+
+        transforms = {}
+        for line in output.splitlines():
+            if line.startswith(RESULT_PREFIX):
+                name, values = line[len(RESULT_PREFIX):].rsplit(':', 1)
+                transforms[name] = values
+        self.assertTrue(transforms, output)
+        return transforms
+
+    def test_threads_match_serial(self):
+        serial = self.run_scene(1)
+        for threads in THREADS:
+            with self.subTest(threads=threads):
+                self.assertEqual(serial, self.run_scene(threads))
+
+
+if __name__ == '__main__':
+    parser = argparse.ArgumentParser()
+    parser.add_argument('--blender', required=True)
+    parser.add_argument('--blenderplayer', required=True)
+    args, remaining = parser.parse_known_args()
+
+    unittest.main(argv=sys.argv[0:1] + remaining)
@@ -0,0 +1,108 @@
+#!/usr/bin/env python3
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""
+Benchmark of the script mode python controllers, run in the headless player.
+
+Each object of the scene runs a script controller at every frame:
+- "S": the namespace of the script is emptied and reused between the runs.
+- "S fresh namespace": the script defines a function, the namespace referenced by the
+  function is given up and a new one is copied at each run, as every run used to do.
+- "F": the script is the body of a function defined once.
+
+With --reference-blenderplayer the "S" scene is also run with another player, e.g. a build
+without the namespace reuse.
+
+Example:
+  ./bge_python_controller_benchmark.py --blender ./blender --blenderplayer ./blenderplayer
+"""
+
+import argparse
+import pathlib
+import sys
+import tempfile
+
+from modules import bge_utils
+
+SCRIPT = """
+import bge
+cont = bge.logic.getCurrentController()
+own = cont.owner
+position = own.worldPosition
+value = position.x + position.y
+"""
+
+SCRIPT_FUNCTION = SCRIPT + """
+def get_value():
+    return value
+"""
+
+
+def run_case(args, tempdir, name, script, use_function, player):
+    blendfile = tempdir / (name.replace(' ', '_') + '.blend')
+    if not blendfile.exists():
+        bge_utils.build_blend(args.blender, blendfile, bge_utils.LOGIC_SCENE_SCRIPT.format(
+            script=script, use_function=use_function, num_objects=args.objects))
+
+    times = []
+    for i in range(args.repeat):
+        code, output = bge_utils.run_player(player, blendfile, tempdir / 'main_loop.py')
+        if code:
+            raise RuntimeError('Error %d running %s:\n%s' % (code, name, output))
+        times.append(bge_utils.parse_time(output))
+    return min(times)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--blender', required=True)
+    parser.add_argument('--blenderplayer', required=True)
+    parser.add_argument('--reference-blenderplayer')
+    parser.add_argument('--objects', type=int, default=1000)
+    parser.add_argument('--frames', type=int, default=300)
+    parser.add_argument('--repeat', type=int, default=3)
+    args = parser.parse_args()
+
+    cases = [
+        ("S", SCRIPT, False, args.blenderplayer),
+        ("S fresh namespace", SCRIPT_FUNCTION, False, args.blenderplayer),
+        ("F", SCRIPT, True, args.blenderplayer),
+    ]
+    if args.reference_blenderplayer:
+        cases.append(("S reference", SCRIPT, False, args.reference_blenderplayer))
+
+    with tempfile.TemporaryDirectory(prefix='bge-benchmark') as dirname:
+        tempdir = pathlib.Path(dirname)
+        bge_utils.write_main_loop(tempdir / 'main_loop.py', args.frames)
+
+        print("%d objects, %d frames" % (args.objects, args.frames))
+        for name, script, use_function, player in cases:
+            # The reference scene is the same as "S".
+            blendname = "S" if name == "S reference" else name
+            elapsed = run_case(args, tempdir, blendname, script, use_function, player)
+            print("%-20s %8.3f ms/frame" % (name, elapsed * 1000.0 / args.frames))
+
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+# ##### BEGIN GPL LICENSE BLOCK #####
+#
+#  This program is free software; you can redistribute it and/or
+#  modify it under the terms of the GNU General Public License
+#  as published by the Free Software Foundation; either version 2
+#  of the License, or (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program; if not, write to the Free Software Foundation,
+#  Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+#
+# ##### END GPL LICENSE BLOCK #####
+
+# <pep8 compliant>
+
+"""Utilities to build a game with Blender and run it with the headless blenderplayer."""
+
+import pathlib
+import subprocess
+
+# Printed by the main loop scripts with the time spent in the measured frames.
+TIME_PREFIX = "BGE_TIME:"
+
+# Python main loop stepping the engine a given number of frames and printing the elapsed time.
+MAIN_LOOP_SCRIPT = """
+import time
+import bge
+
+for i in range({warmup:d}):
+    bge.logic.NextFrame()
+
+start = time.perf_counter()
+for i in range({frames:d}):
+    bge.logic.NextFrame()
+print("{prefix}%f" % (time.perf_counter() - start))
+"""
+
+# Blender script adding logic bricks: an always sensor in pulse mode linked to a python
+# controller running a text, on the default cube duplicated to a number of objects.
+LOGIC_SCENE_SCRIPT = """
+import bpy
+
+text = bpy.data.texts.new("script.py")
+text.from_string({script!r})
+
+base = bpy.data.objects["Cube"]
+bpy.context.view_layer.objects.active = base
+bpy.ops.logic.sensor_add(type='ALWAYS', object=base.name)
+bpy.ops.logic.controller_add(type='PYTHON', object=base.name)
+
+sensor = base.game.sensors[-1]
+sensor.use_pulse_true_level = True
+controller = base.game.controllers[-1]
+controller.mode = 'SCRIPT'
+controller.text = text
+controller.use_function = {use_function!r}
+sensor.link(controller)
+
+scene = bpy.context.scene
+for i in range(1, {num_objects:d}):
+    copy = base.copy()
+    copy.location = (i % 32, i // 32, 0.0)
+    scene.collection.objects.link(copy)
+"""
+
+
+def build_blend(blender: pathlib.Path, blendfile: pathlib.Path, script: str,
+                timeout: int=300) -> str:
+    """Runs a script building a scene in Blender from the factory startup file and saves it.
+
+    Returns Blender's stdout + stderr combined into one string.
+    """
+    save = "\nimport bpy\nbpy.ops.wm.save_as_mainfile(filepath=%r)\n" % str(blendfile)
+    command = [
+        str(blender),
+        '--background',
+        '-noaudio',
+        '--factory-startup',
+        '--python-exit-code', '47',
+        '--python-expr', script + save,
+    ]
+
+    proc = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          timeout=timeout)
+    output = proc.stdout.decode('utf8')
+    if proc.returncode:
+        raise RuntimeError('Error %d running Blender:\n%s' % (proc.returncode, output))
+
+    return output
+
+
+def run_player(player: pathlib.Path, blendfile: pathlib.Path, main_loop: pathlib.Path=None,
+               options: dict=None, timeout: int=300) -> (int, str):
+    """Runs a blend file with the headless player, as fast as possible.
+
+    :param main_loop: optional python main loop script.
+    :param options: game engine options passed with -g.
+    Returns the exit code and the player's stdout + stderr combined into one string.
+    """
+    command = [str(player), '-b', '-g', 'fast_forward', '=', '1']
+    for name, value in (options or {}).items():
+        command.extend(['-g', name, '=', str(value)])
+    if main_loop:
+        command.extend(['-p', str(main_loop)])
+    command.append(str(blendfile))
+
+    proc = subprocess.run(command, stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          timeout=timeout)
+    return proc.returncode, proc.stdout.decode('utf8')
+
+
+def write_main_loop(filepath: pathlib.Path, frames: int, warmup: int=10):
+    """Writes a main loop script stepping the engine and printing the elapsed time."""
+    filepath.write_text(MAIN_LOOP_SCRIPT.format(warmup=warmup, frames=frames, prefix=TIME_PREFIX))
+
+
+def parse_time(output: str) -> float:
+    """Returns the time printed by the main loop script or raises if missing."""
+    for line in output.splitlines():
+        if line.startswith(TIME_PREFIX):
+            return float(line[len(TIME_PREFIX):])
+    raise RuntimeError('No time in the player output:\n%s' % output)